@@ -0,0 +1,85 @@
+/*
+ _______          _    _
+|__   __|  /\    | |  | |
+   | |    /  \   | |  | |  Tau - The Micro Testing Framework for C/C++
+   | |   / /\ \  | |  | |  Language: C
+   | |  / ____ \ | |__| |  https://github.com/jasmcaus/tau
+   |_| /_/    \_\ \____/
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Jason Dsouza <@jasmcaus>
+*/
+
+/**
+    TauAlloc: counts the allocations of the test binary it is linked into (see <tau/alloc.h>). It needs to be
+    linked with `-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free`, which the `TauAlloc` CMake target
+    passes on to whatever links against it.
+*/
+#include <tau/alloc.h>
+
+#include <malloc.h>
+#include <stddef.h>
+
+// Defined by `TAU_MAIN()`/`TAU_NO_MAIN()`
+extern _Thread_local tauAllocStatsStruct tauAllocStats;
+extern int tauAllocInterposed;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+// Tell Tau that the counters are live (before `main()`, so before any test runs)
+__attribute__((constructor)) static void tauAllocInit(void) {
+    tauAllocInterposed = 1;
+}
+
+static void tauAllocCountAlloc(void* const ptr) {
+    tau_u64 size;
+
+    if(ptr == NULL || tauAllocStats.paused)
+        return;
+    size = (tau_u64)malloc_usable_size(ptr);
+    tauAllocStats.allocs++;
+    tauAllocStats.bytes += size;
+    tauAllocStats.live += (tau_i64)size;
+    if(tauAllocStats.live > tauAllocStats.peak)
+        tauAllocStats.peak = tauAllocStats.live;
+}
+
+static void tauAllocCountFree(const size_t size) {
+    if(tauAllocStats.paused)
+        return;
+    tauAllocStats.frees++;
+    tauAllocStats.live -= (tau_i64)size;
+}
+
+void* __wrap_malloc(size_t size) {
+    void* const ptr = __real_malloc(size);
+    tauAllocCountAlloc(ptr);
+    return ptr;
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    void* const ptr = __real_calloc(count, size);
+    tauAllocCountAlloc(ptr);
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    const size_t previous = ptr != NULL ? malloc_usable_size(ptr) : 0;
+    void* const moved = __real_realloc(ptr, size);
+
+    // On failure, `ptr` is left alone (unless `size` is 0, in which case it was freed)
+    if(ptr != NULL && (moved != NULL || size == 0))
+        tauAllocCountFree(previous);
+    tauAllocCountAlloc(moved);
+    return moved;
+}
+
+void __wrap_free(void* ptr) {
+    if(ptr != NULL)
+        tauAllocCountFree(malloc_usable_size(ptr));
+    __real_free(ptr);
+}
@@ -0,0 +1,37 @@
+/*
+ _______          _    _
+|__   __|  /\    | |  | |
+   | |    /  \   | |  | |  Tau - The Micro Testing Framework for C/C++
+   | |   / /\ \  | |  | |  Language: C
+   | |  / ____ \ | |__| |  https://github.com/jasmcaus/tau
+   |_| /_/    \_\ \____/
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Jason Dsouza <@jasmcaus>
+*/
+
+#ifndef TAU_ALLOC_H
+#define TAU_ALLOC_H
+
+#include <tau/types.h>
+
+/**
+    Allocation tracking (the `TauAlloc` library)
+    Linking TauAlloc into a test binary wraps its calls to `malloc()`, `calloc()`, `realloc()` and `free()` (with
+    the GNU linker's `--wrap`), and counts them for each thread in `tauAllocStats`. Sizes are the ones reported by
+    `malloc_usable_size()`. Tau reads the counters around every test and `CHECK_NO_ALLOC`/`CHECK_ALLOCS_LE()` block.
+
+    Only the calls made by the binary's own code are wrapped: allocations inside shared libraries (including
+    those of C++'s `operator new` in libstdc++) aren't counted.
+*/
+typedef struct tauAllocStatsStruct {
+    tau_u64 allocs;         // Calls that returned memory (a `realloc()` counts as a free and an allocation)
+    tau_u64 frees;
+    tau_u64 bytes;          // Allocated in total
+    tau_i64 live;           // Allocated but not freed yet; may go negative if other threads free our memory
+    tau_i64 peak;           // High-water mark of `live`. Tau lowers it to `live` when a test starts.
+    int paused;             // While non-zero, nothing is counted (Tau's own allocations)
+} tauAllocStatsStruct;
+
+#endif // TAU_ALLOC_H
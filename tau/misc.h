@@ -19,14 +19,15 @@ Copyright (c) 2021 Jason Dsouza <@jasmcaus>
     #define TAU_CAST(type, x)       static_cast<type>(x)
     #define TAU_PTRCAST(type, x)    reinterpret_cast<type>(x)
 #else
-    #define TAU_CAST(type, x)       ((type)x)
-    #define TAU_PTRCAST(type, x)    ((type)x)
+    #define TAU_CAST(type, x)       ((type)(x))
+    #define TAU_PTRCAST(type, x)    ((type)(x))
 #endif // __cplusplus
 
-// printf format-string specifiers for tau_i64 and tau_u64 respectively
+// printf format-string specifiers for tau_i64 and tau_u64 (in decimal and in hex)
 #if defined(_MSC_VER) && (_MSC_VER < 1920)
     #define TAU_PRId64 "I64d"
     #define TAU_PRIu64 "I64u"
+    #define TAU_PRIx64 "I64x"
 #else
     // Avoid spurious trailing ‘%’ in format error
 	// See: https://stackoverflow.com/questions/8132399/how-to-printf-uint64-t-fails-with-spurious-trailing-in-format
@@ -35,6 +36,7 @@ Copyright (c) 2021 Jason Dsouza <@jasmcaus>
 
     #define TAU_PRId64 PRId64
     #define TAU_PRIu64 PRIu64
+    #define TAU_PRIx64 PRIx64
 #endif
 
 #ifndef TAU_IS_SIGNED
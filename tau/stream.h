@@ -0,0 +1,105 @@
+/*
+ _______          _    _
+|__   __|  /\    | |  | |
+   | |    /  \   | |  | |  Tau - The Micro Testing Framework for C/C++
+   | |   / /\ \  | |  | |  Language: C
+   | |  / ____ \ | |__| |  https://github.com/jasmcaus/tau
+   |_| /_/    \_\ \____/
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Jason Dsouza <@jasmcaus>
+*/
+
+#ifndef TAU_STREAM_H
+#define TAU_STREAM_H
+
+#include <tau/types.h>
+
+/**
+    Tau's binary result stream (`--emit=bin:<FILE>`)
+    The file starts with a `tauStreamHeaderStruct`, followed by a sequence of records. Every record is a
+    `tauStreamRecordStruct` giving its type and the size of its payload, followed by exactly that many bytes of
+    payload, so readers can skip record types they don't know about.
+
+    Payloads start with a fixed-size struct (listed below for each record type); the strings some of them carry
+    follow it, in the order their sizes are listed in, without NUL terminators. All integers are in the byte order
+    of the machine that ran the tests (see `byteOrder`), and all structs are laid out without padding.
+
+    The records of a test (START, any number of ASSERTION_FAILUREs, an optional METRICS, END) are always written
+    together, even when tests run concurrently. Tests are identified by their registration index.
+*/
+#define TAU_STREAM_MAGIC                "TAUSTRM"   // 8 bytes, including the NUL terminator
+#define TAU_STREAM_VERSION              1
+#define TAU_STREAM_BYTE_ORDER           0x01020304u
+
+#define TAU_STREAM_TEST_START           1           // tauStreamTestStartStruct + name + file
+#define TAU_STREAM_ASSERTION_FAILURE    2           // tauStreamAssertionFailureStruct + file + message
+#define TAU_STREAM_TEST_END             3           // tauStreamTestEndStruct
+#define TAU_STREAM_SUMMARY              4           // tauStreamSummaryStruct
+#define TAU_STREAM_METRICS              5           // tauStreamMetricsStruct + values + names
+
+// Values of `tauStreamTestEndStruct::status`
+#define TAU_STREAM_STATUS_PASSED        1
+#define TAU_STREAM_STATUS_FAILED        2
+
+typedef struct tauStreamHeaderStruct {
+    char magic[8];
+    tau_u32 version;
+    tau_u32 byteOrder;          // TAU_STREAM_BYTE_ORDER, as written by the producer
+} tauStreamHeaderStruct;
+
+typedef struct tauStreamRecordStruct {
+    tau_u32 type;
+    tau_u32 size;               // Size of the payload that follows
+} tauStreamRecordStruct;
+
+typedef struct tauStreamTestStartStruct {
+    tau_u64 test;
+    tau_u32 line;
+    tau_u32 nameSize;
+    tau_u32 fileSize;
+    tau_u32 reserved;
+} tauStreamTestStartStruct;
+
+typedef struct tauStreamAssertionFailureStruct {
+    tau_u64 test;
+    tau_u32 line;
+    tau_u32 fileSize;
+    tau_u32 messageSize;
+    tau_u32 reserved;
+} tauStreamAssertionFailureStruct;
+
+typedef struct tauStreamTestEndStruct {
+    tau_u64 test;
+    tau_u64 duration;           // In nanoseconds
+    tau_u32 status;
+    tau_u32 reserved;
+} tauStreamTestEndStruct;
+
+// Performance counters and resource usage of a test (`--counters`, `--resources`): `count` doubles, followed by
+// their names, separated by commas
+typedef struct tauStreamMetricsStruct {
+    tau_u64 test;
+    tau_u32 count;
+    tau_u32 namesSize;
+} tauStreamMetricsStruct;
+
+typedef struct tauStreamSummaryStruct {
+    tau_u64 total;
+    tau_u64 ran;
+    tau_u64 failed;
+    tau_u64 skipped;
+    tau_u64 warnings;
+    tau_u64 duration;           // In nanoseconds
+} tauStreamSummaryStruct;
+
+TAU_STATIC_ASSERT(sizeof(tauStreamHeaderStruct) == 16);
+TAU_STATIC_ASSERT(sizeof(tauStreamRecordStruct) == 8);
+TAU_STATIC_ASSERT(sizeof(tauStreamTestStartStruct) == 24);
+TAU_STATIC_ASSERT(sizeof(tauStreamAssertionFailureStruct) == 24);
+TAU_STATIC_ASSERT(sizeof(tauStreamTestEndStruct) == 24);
+TAU_STATIC_ASSERT(sizeof(tauStreamMetricsStruct) == 16);
+TAU_STATIC_ASSERT(sizeof(tauStreamSummaryStruct) == 48);
+
+#endif // TAU_STREAM_H
@@ -15,6 +15,8 @@ Copyright (c) 2021 Jason Dsouza <http://github.com/jasmcaus>
 
 #include <tau/types.h>
 #include <tau/misc.h>
+#include <tau/stream.h>
+#include <tau/alloc.h>
 
 TAU_DISABLE_DEBUG_WARNINGS
 
@@ -32,6 +34,17 @@ TAU_DISABLE_DEBUG_WARNINGS
     #include <sys/wait.h>
     #include <signal.h>
     #include <time.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <sys/resource.h>
+
+    // Worker processes for the crash-isolating runner (`--isolate`, `--shards`)
+    #define TAU_HAS_FORK_   1
+    #ifndef __cplusplus
+        // Hidden by strict ISO C modes (e.g. `-std=c11`), but the C library has them all the same
+        extern int ftrylockfile(FILE*);
+        extern void funlockfile(FILE*);
+    #endif // __cplusplus
 
     #if defined(CLOCK_PROCESS_CPUTIME_ID) && defined(CLOCK_MONOTONIC)
         #define TAU_HAS_POSIX_TIMER_    1
@@ -44,6 +57,23 @@ TAU_DISABLE_DEBUG_WARNINGS
     #include <sys/stat.h>
 #endif // _gnu_linux_
 
+// Hardware performance counters (`--counters`). Define `TAU_NO_COUNTERS` to build Tau without them.
+#if defined(TAU_LINUX_) && !defined(TAU_NO_COUNTERS) && defined(__has_include)
+    #if __has_include(<linux/perf_event.h>)
+        #include <linux/perf_event.h>
+        #include <sys/ioctl.h>
+        #include <sys/syscall.h>
+
+        #ifdef SYS_perf_event_open
+            #define TAU_HAS_COUNTERS_   1
+            #ifndef __cplusplus
+                // Hidden by strict ISO C modes (e.g. `-std=c11`), but the C library has it all the same
+                extern long syscall(long, ...);
+            #endif // __cplusplus
+        #endif // SYS_perf_event_open
+    #endif // __has_include(<linux/perf_event.h>)
+#endif // TAU_LINUX_
+
 #if defined(_WIN32) || defined(__WIN32__) || defined(__WINDOWS__)
     #define TAU_WIN_        1
     #pragma warning(push, 0)
@@ -52,6 +82,38 @@ TAU_DISABLE_DEBUG_WARNINGS
     #pragma warning(pop)
 #endif // _WIN32
 
+// The parallel runner (`--jobs`) needs a threading library. Define `TAU_NO_THREADS` to build Tau without it.
+#if !defined(TAU_NO_THREADS) && (defined(TAU_UNIX_) || defined(TAU_WIN_))
+    #define TAU_HAS_THREADS_    1
+    #ifdef TAU_UNIX_
+        #include <pthread.h>
+    #endif // TAU_UNIX_
+#endif // TAU_NO_THREADS
+
+// Stacks of tests that time out (see `tauWatchdogCaptureStack()`)
+#if defined(TAU_HAS_THREADS_) && defined(TAU_UNIX_) && defined(__has_include)
+    #if __has_include(<execinfo.h>)
+        #include <execinfo.h>
+        #define TAU_HAS_BACKTRACE_  1
+        #ifndef __cplusplus
+            // Hidden by strict ISO C modes (e.g. `-std=c11`), but the C library has it all the same
+            extern int pthread_kill(pthread_t, int);
+        #endif // __cplusplus
+    #endif // __has_include(<execinfo.h>)
+#endif // TAU_HAS_THREADS_
+
+// Vector compares for the buffer assertions (see `tauBufScan()`)
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define TAU_HAS_AVX2_   1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TAU_HAS_SSE2_   1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define TAU_HAS_NEON_   1
+#endif // __AVX2__
+
 #ifdef __has_include
     #if __has_include(<valgrind.h>)
         #include <valgrind.h>
@@ -83,6 +145,22 @@ TAU_DISABLE_DEBUG_WARNINGS
     #define TAU_ATTRIBUTE_(attr)
 #endif // __GNUC__
 
+// Branch hints, and the marker for code that only runs when something went wrong (kept out of line, and out of
+// the way of the code that calls it)
+#if defined(__GNUC__) || defined(__clang__)
+    #define TAU_LIKELY(x)       __builtin_expect(!!(x), 1)
+    #define TAU_UNLIKELY(x)     __builtin_expect(!!(x), 0)
+    #define TAU_COLD_           __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+    #define TAU_LIKELY(x)       (x)
+    #define TAU_UNLIKELY(x)     (x)
+    #define TAU_COLD_           __declspec(noinline)
+#else
+    #define TAU_LIKELY(x)       (x)
+    #define TAU_UNLIKELY(x)     (x)
+    #define TAU_COLD_
+#endif // __GNUC__
+
 #ifdef __cplusplus
     // On C++, default to its polymorphism capabilities
     #define TAU_OVERLOADABLE
@@ -99,36 +177,169 @@ TAU_DISABLE_DEBUG_WARNINGS
     #define TAU_UNUSED   __attribute__((unused))
 #endif // _MSC_VER
 
+// Storage that is private to each thread running tests (see `--jobs`)
+#if defined(__cplusplus)
+    #define TAU_THREAD_LOCAL    thread_local
+#elif defined(_MSC_VER)
+    #define TAU_THREAD_LOCAL    __declspec(thread)
+#else
+    #define TAU_THREAD_LOCAL    _Thread_local
+#endif // __cplusplus
+
+// Counters that may be bumped from several worker threads at once, and flags that several threads may flip. The
+// loads and stores are of `int`s, or of 64-bit values with the `64` variants (which only MSVC needs told apart).
+#if defined(_MSC_VER)
+    #define TAU_ATOMIC_ADD(ptr, val)    InterlockedExchangeAdd64(TAU_PTRCAST(volatile LONG64*, ptr), val)
+    #define TAU_ATOMIC_CAS(ptr, expected, desired) \
+        (InterlockedCompareExchange(TAU_PTRCAST(volatile LONG*, ptr), desired, expected) == (expected))
+    #define TAU_ATOMIC_LOAD(ptr)        InterlockedCompareExchange(TAU_PTRCAST(volatile LONG*, ptr), 0, 0)
+    #define TAU_ATOMIC_STORE(ptr, val)  InterlockedExchange(TAU_PTRCAST(volatile LONG*, ptr), val)
+    #define TAU_ATOMIC_LOAD64(ptr) \
+        TAU_CAST(tau_u64, InterlockedCompareExchange64(TAU_PTRCAST(volatile LONG64*, ptr), 0, 0))
+    #define TAU_ATOMIC_STORE64(ptr, val) \
+        InterlockedExchange64(TAU_PTRCAST(volatile LONG64*, ptr), TAU_CAST(LONG64, val))
+#else
+    #define TAU_ATOMIC_ADD(ptr, val)    __atomic_fetch_add(ptr, val, __ATOMIC_RELAXED)
+    #define TAU_ATOMIC_CAS(ptr, expected, desired) \
+        __sync_bool_compare_and_swap(ptr, expected, desired)
+    #define TAU_ATOMIC_LOAD(ptr)            __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+    #define TAU_ATOMIC_STORE(ptr, val)      __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+    #define TAU_ATOMIC_LOAD64(ptr)          __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+    #define TAU_ATOMIC_STORE64(ptr, val)    __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#endif // _MSC_VER
+
+// A growable byte buffer. Used to hold the output of a test while it runs, so that it can be emitted in one go
+// at the next test boundary (and, on a worker thread, without interleaving with the output of concurrent tests).
+typedef struct tauBufferStruct {
+    char* data;
+    tau_ull size;
+    tau_ull capacity;
+} tauBufferStruct;
+
+// The output sink of a thread: everything Tau prints while running tests is formatted (once) straight into these
+// buffers, and handed to stdio with a single `fwrite()` per destination at test boundaries. Going through stdio
+// keeps it in order with anything the tests print themselves, and lets stdio batch the actual `write()`s.
+typedef struct tauCaptureStruct {
+    tauBufferStruct console;
+    tauBufferStruct file;
+    tauBufferStruct events;     // Records for the binary result stream (`--emit=bin:<FILE>`)
+    tauBufferStruct benchmarks; // Samples of the benchmarks that ran, one line each (see `tauRunBenchmark()`)
+    int live;                   // Written out as the test goes, not only once it is done (serial runs)
+    tau_ull written;            // How much of `console` has been written out already
+    // Writes out what the sink holds so far when an assertion fails, so that it survives a crash (if set). It is
+    // set by the runner, as the assertion may be in another translation unit, with report files of its own.
+    void (*writeThrough)(struct tauCaptureStruct* capture);
+    int streaming;              // Whether to generate `events`
+    const struct tauTestSuiteStruct* currentTest;
+    tau_ull failureMark;        // Where in `console` the output of the next failed assertion starts
+} tauCaptureStruct;
+
 #ifndef TAU_NO_TESTING
 
+#define TAU_TEST_NOT_RUN_       0
+#define TAU_TEST_PASSED_        1
+#define TAU_TEST_FAILED_        2
+
+#define TAU_MAX_COUNTERS_       8   // Events `--counters` can count at once
+
+// What `--resources` measures around each test (see `tauResourcesSample()`)
+#define TAU_RESOURCE_MAX_RSS_               0   // Growth of the peak resident set size, in bytes
+#define TAU_RESOURCE_RSS_                   1   // Growth of the resident set size, in bytes
+#define TAU_RESOURCE_MINOR_FAULTS_          2
+#define TAU_RESOURCE_MAJOR_FAULTS_          3
+#define TAU_RESOURCE_VOLUNTARY_SWITCHES_    4
+#define TAU_RESOURCE_INVOLUNTARY_SWITCHES_  5
+#define TAU_NUM_RESOURCES_                  6
+
+// The outcome of a single test. Each test is run by exactly one worker, so this needs no locking.
+typedef struct tauTestResultStruct {
+    int status;
+    tau_u64 duration;           // In nanoseconds
+    tau_i64 previousDuration;   // As recorded by an earlier run in the `--durations` file; negative if unknown
+    tau_u64 counters[TAU_MAX_COUNTERS_];    // Values of the `--counters` events, in `tauCounterConfig` order
+    int numCounters;            // 0 if the test wasn't counted
+    tau_u64 allocs;             // What the test allocated, if TauAlloc is linked in (see <tau/alloc.h>)
+    tau_u64 allocBytes;
+    tau_i64 peakBytes;          // Most memory the test had allocated at once
+    tau_i64 leakedBytes;        // Allocated by the test and not freed by the time it returned
+    tau_i64 resources[TAU_NUM_RESOURCES_];  // Indexed by the `TAU_RESOURCE_*_` constants
+    int hasResources;           // 0 if the test's resource usage wasn't measured
+    tau_u64 assertions;         // Number of assertions the test made (passing or not)
+} tauTestResultStruct;
+
 typedef void (*tau_testsuite_t)();
+// One registry node per `TEST()`/`TEST_F()`. Nodes are `static` objects owned by the translation unit that
+// defines the test, and are chained together in registration order, so registering a test never allocates.
 typedef struct tauTestSuiteStruct {
     tau_testsuite_t func;
-    char* name;
+    const char* name;           // Points at a string literal
+    const char* file;
+    int line;
+    tau_ull index;              // Position in registration order
+    tau_bool selected;          // Passes `--filter`; computed once by `tauApplyFilter()`
+    tauTestResultStruct result;
+    tau_u64 numPasses;          // Over all iterations of `--repeat`/`--until-fail`
+    tau_u64 numFailures;
+    struct tauTestSuiteStruct* next;
 } tauTestSuiteStruct;
 
 typedef struct tauTestStateStruct {
-    tauTestSuiteStruct* tests;
+    tauTestSuiteStruct* tests;      // First registered test; walk the rest through `next`
+    tauTestSuiteStruct* lastTest;
     tau_ull numTestSuites;
     FILE* foutput;
 } tauTestStateStruct;
 
+// What a test emits into the `tau_tests` section when `TAU_SECTION_REGISTRY` is defined. The descriptor itself
+// is read-only; everything that changes at runtime lives in the `tauTestSuiteStruct` node it points to.
+typedef struct tauTestDescriptorStruct {
+    tauTestSuiteStruct* test;
+    tau_testsuite_t func;
+    const char* name;
+    const char* file;
+    int line;
+} tauTestDescriptorStruct;
+
 static tau_u64 tauStatsTotalTestSuites = 0;
 static tau_u64 tauStatsTestsRan = 0;
 static tau_u64 tauStatsNumTestsFailed = 0;
 static tau_u64 tauStatsSkippedTests = 0;
-static tau_ull* tauStatsFailedTestSuites = TAU_NULL;
-static tau_ull tauStatsNumFailedTestSuites = 0;
+static tau_u64 tauStatsIterations = 0;
+static tau_u64 tauStatsNumAssertions = 0;
+static tau_u64 tauStatsTestsDuration = 0;   // The run times of the tests, summed (in nanoseconds)
 extern tau_u64 tauStatsNumWarnings;
 
+// Number of worker threads to run tests on. Overridden in `tau_main` if the cmdline option `--jobs` is passed
+static tau_ull tauNumJobs = 1;
+// Number of worker processes to run tests in. Overridden in `tau_main` if `--isolate` or `--shards` is passed
+static tau_ull tauNumShards = 0;
+
 // Overridden in `tau_main` if the cmdline option `--no-color` is passed
 static int tauShouldColourizeOutput = 1;
 static int tauDisableSummary = 0;
 static int tauDisplayOnlyFailedOutput = 0;
 static int tauDisplayTests = 0;
+static int tauMeasureResources = 0;             // `--resources`
+static tau_ull tauNumTopTests = 0;              // `--top`
+static tau_u64 tauTimeout = 0;                  // In nanoseconds; overridden by `--timeout`
+static tau_ull tauPartitionIndex = 0;           // `--shard-index`
+static tau_ull tauPartitionCount = 0;           // `--shard-count`; 0 if this machine runs all of the tests
+static int tauPartitionByDuration = 0;          // `--shard-by=duration`
+static int tauShuffle = 0;                      // `--shuffle`
+static tau_u64 tauShuffleSeed = 0;
+static tau_u64 tauNumRepeats = 1;               // `--repeat`; 0 repeats until a test fails (`--until-fail`)
+static int tauUntilFail = 0;                    // `--until-fail`
 
 static const char* tau_argv0_ = TAU_NULL;
 static const char* cmd_filter = TAU_NULL;
+static const char* tauDurationsFile = TAU_NULL;
+static const char* tauXUnitPath = TAU_NULL;
+static const char* tauBenchSaveFile = TAU_NULL;
+static const char* tauBenchCompareFile = TAU_NULL;
+static double tauBenchThreshold = 5;            // In percent; overridden by `--bench-threshold`
+static tauBufferStruct tauBenchResults;         // What the benchmarks that ran put in their sinks' `benchmarks`
+static char* tauBenchBaseline = TAU_NULL;       // Contents of the `--bench-compare` file
+static tau_u64 tauBenchNumRegressions = 0;
 #endif // TAU_NO_TESTING
 
 /**
@@ -142,13 +353,165 @@ static const char* cmd_filter = TAU_NULL;
     `CHECK`s and `REQUIRE`s will do their thing and return the appropriate result.
     If the assertion macro is not within the `TEST()` scope, it simply does not return anything - it only
     resets it back to false so that this same process occurs for the rest of the checks.
+
+    All of these flags are thread-local: with `--jobs`, every worker thread tracks the test it is currently
+    running independently of the others.
+*/
+TAU_EXTERN TAU_THREAD_LOCAL volatile int checkIsInsideTestSuite;
+TAU_EXTERN TAU_THREAD_LOCAL volatile int hasCurrentTestFailed;
+
+// If non-NULL, output is appended to this (thread-local) capture instead of being written out directly
+TAU_EXTERN TAU_THREAD_LOCAL tauCaptureStruct* tauCurrentCapture;
+
+// Number of assertions this thread has made. Bumped by every assertion macro, so it is a plain (non-atomic,
+// non-volatile) counter: a test's count is the difference between its value before and after the test.
+TAU_EXTERN TAU_THREAD_LOCAL tau_u64 tauAssertionCount;
+
+/**
+    Failure budget (`--max-failures-per-test=N`)
+    Once a test has reported N failed assertions, further failures are only counted, by where they come from, and
+    summed up when the test ends. A check that starts failing inside a long loop then costs a few lines of log
+    instead of millions.
 */
-extern volatile int checkIsInsideTestSuite;
-extern volatile int hasCurrentTestFailed;
+#define TAU_MAX_FAILURES_PER_TEST_  100         // The default N
+#define TAU_MAX_FAILURE_SITES_      16          // Assertions counted separately; the rest are lumped together
+
+typedef struct tauFailureSiteStruct {
+    const char* file;
+    unsigned line;
+    tau_u64 count;
+} tauFailureSiteStruct;
+
+typedef struct tauFailureBudgetStruct {
+    tau_u64 reported;                                   // Failures the current test has reported in full
+    tau_u64 numSites;
+    tauFailureSiteStruct sites[TAU_MAX_FAILURE_SITES_]; // Where the others came from...
+    tau_u64 elsewhere;                                  // ...once there are more places than fit in `sites`
+    int lastReported;                                   // Whether the latest failure was reported in full
+} tauFailureBudgetStruct;
+
+TAU_EXTERN tau_u64 tauMaxFailuresPerTest;              // 0 for no limit
+TAU_EXTERN TAU_THREAD_LOCAL tauFailureBudgetStruct tauFailureBudget;
+
+// Allocations made by this thread, kept up to date by the TauAlloc library (which sets `tauAllocInterposed`)
+TAU_EXTERN TAU_THREAD_LOCAL tauAllocStatsStruct tauAllocStats;
+TAU_EXTERN int tauAllocInterposed;
+
+// Tau's own memory, which isn't charged to the test that happens to be running
+static void* tauMalloc(const tau_ull size) {
+    void* ptr;
+    tauAllocStats.paused++;
+    ptr = malloc(size);
+    tauAllocStats.paused--;
+    return ptr;
+}
+
+static void* tauCalloc(const tau_ull count, const tau_ull size) {
+    void* ptr;
+    tauAllocStats.paused++;
+    ptr = calloc(count, size);
+    tauAllocStats.paused--;
+    return ptr;
+}
+
+static void* tauRealloc(void* const ptr, const tau_ull size) {
+    void* moved;
+    tauAllocStats.paused++;
+    moved = realloc(ptr, size);
+    tauAllocStats.paused--;
+    return moved;
+}
+
+static void tauFree(void* const ptr) {
+    tauAllocStats.paused++;
+    free(ptr);
+    tauAllocStats.paused--;
+}
+
+// Make sure `buf` can hold `extra` more bytes (plus the NUL terminator `vsnprintf` always writes)
+static tau_bool tauBufferReserve(tauBufferStruct* const buf, const tau_ull extra) {
+    if(buf->size + extra + 1 > buf->capacity) {
+        tau_ull capacity = buf->capacity ? buf->capacity : 65536;
+        char* data;
+        while(capacity < buf->size + extra + 1)
+            capacity *= 2;
+
+        data = TAU_PTRCAST(char*, tauRealloc(buf->data, capacity));
+        if(TAU_NONE(data))
+            return tau_false;
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+    return tau_true;
+}
+
+static void tauBufferAppend(tauBufferStruct* const buf, const char* const data, const tau_ull size) {
+    if(tauBufferReserve(buf, size)) {
+        memcpy(buf->data + buf->size, data, size);
+        buf->size += size;
+    }
+}
+
+static void tauBufferVPrintf(tauBufferStruct* const buf, const char* const fmt, va_list args) {
+    va_list argsCopy;
+    int n;
+
+    // Format straight into the free space; only if that turns out to be too small, grow and format again
+    if(!tauBufferReserve(buf, 0))
+        return;
+    va_copy(argsCopy, args);
+    n = vsnprintf(buf->data + buf->size, buf->capacity - buf->size, fmt, argsCopy);
+    va_end(argsCopy);
+    if(n <= 0)
+        return;
+
+    if(buf->size + TAU_CAST(tau_ull, n) >= buf->capacity) {
+        if(!tauBufferReserve(buf, TAU_CAST(tau_ull, n)))
+            return;
+        vsnprintf(buf->data + buf->size, TAU_CAST(tau_ull, n) + 1, fmt, args);
+    }
+    buf->size += TAU_CAST(tau_ull, n);
+}
+
+static void tauBufferFree(tauBufferStruct* const buf) {
+    tauFree(TAU_PTRCAST(void*, buf->data));
+    buf->data = TAU_NULL;
+    buf->size = buf->capacity = 0;
+}
+
+// Write to STDOUT (or to the current capture, if any)
+static int tauConsoleVPrintf(const char* const fmt, va_list args) {
+    if(tauCurrentCapture) {
+        const tau_ull size = tauCurrentCapture->console.size;
+        tauBufferVPrintf(&tauCurrentCapture->console, fmt, args);
+        return TAU_CAST(int, tauCurrentCapture->console.size - size);
+    }
+    return vprintf(fmt, args);
+}
+
+static inline int TAU_ATTRIBUTE_(format (printf, 1, 2))
+tauConsolePrintf(const char* const fmt, ...);
+static inline int TAU_ATTRIBUTE_(format (printf, 1, 2))
+tauConsolePrintf(const char* const fmt, ...) {
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = tauConsoleVPrintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+static void tauConsoleWrite(const char* const str) {
+    if(tauCurrentCapture)
+        tauBufferAppend(&tauCurrentCapture->console, str, strlen(str));
+    else
+        fputs(str, stdout);
+}
 
 #ifndef TAU_NO_TESTING
-extern volatile int shouldFailTest;
-extern volatile int shouldAbortTest;
+TAU_EXTERN TAU_THREAD_LOCAL volatile int shouldFailTest;
+TAU_EXTERN TAU_THREAD_LOCAL volatile int shouldAbortTest;
 
 /**
     This function is called from within a macro in the format {CHECK|REQUIRE)_*
@@ -156,28 +519,101 @@ extern volatile int shouldAbortTest;
     appropriately - fail the current test suite and carry on with the other checks (or move on to the next
     suite in the case of a REQUIRE)
 */
-static void failIfInsideTestSuite__();
-static void abortIfInsideTestSuite__();
-
-static void failIfInsideTestSuite__() {
+static void failIfInsideTestSuite__(const char* const file, const unsigned line);
+static void abortIfInsideTestSuite__(const char* const file, const unsigned line);
+static void tauReportContext();
+static void tauContextAbandon();
+static void tauStreamAssertionFailure(tauCaptureStruct* const capture, const char* const file, const unsigned line);
+
+static void failIfInsideTestSuite__(const char* const file, const unsigned line) {
+    tauReportContext();
     if(checkIsInsideTestSuite == 1) {
         hasCurrentTestFailed = 1;
         shouldFailTest = 1;
+        if(tauCurrentCapture && tauCurrentCapture->streaming)
+            tauStreamAssertionFailure(tauCurrentCapture, file, line);
     }
+    if(tauCurrentCapture && tauCurrentCapture->writeThrough)
+        tauCurrentCapture->writeThrough(tauCurrentCapture);
 }
 
-static void abortIfInsideTestSuite__() {
+static void abortIfInsideTestSuite__(const char* const file, const unsigned line) {
+    tauReportContext();
+    tauContextAbandon();
     if(checkIsInsideTestSuite == 1) {
         hasCurrentTestFailed = 1;
         shouldAbortTest = 1;
+        if(tauCurrentCapture && tauCurrentCapture->streaming)
+            tauStreamAssertionFailure(tauCurrentCapture, file, line);
     }
+    if(tauCurrentCapture && tauCurrentCapture->writeThrough)
+        tauCurrentCapture->writeThrough(tauCurrentCapture);
+}
+
+// Append a record for the binary result stream: its fixed-size part, followed by up to two strings
+static void tauStreamAppendRecord(tauBufferStruct* const events, const tau_u32 type, const void* const fixed,
+                                  const tau_u32 fixedSize, const char* const str1, const tau_u32 size1,
+                                  const char* const str2, const tau_u32 size2) {
+    tauStreamRecordStruct record;
+    record.type = type;
+    record.size = fixedSize + size1 + size2;
+
+    tauBufferAppend(events, TAU_PTRCAST(const char*, &record), sizeof(record));
+    tauBufferAppend(events, TAU_PTRCAST(const char*, fixed), fixedSize);
+    if(size1 > 0)
+        tauBufferAppend(events, str1, size1);
+    if(size2 > 0)
+        tauBufferAppend(events, str2, size2);
+}
+
+// Record what the current test printed since its last failed assertion (the failure message of the assertion at
+// `file`:`line`) as an ASSERTION_FAILURE, minus any colour codes
+static void tauStreamAssertionFailure(tauCaptureStruct* const capture, const char* const file, const unsigned line) {
+    const char* const text = capture->console.data + capture->failureMark;
+    const tau_ull size = capture->console.size - capture->failureMark;
+    tauStreamAssertionFailureStruct failure;
+    tau_ull recordStart;
+    tau_ull messageStart;
+
+    memset(&failure, 0, sizeof(failure));
+    failure.test = capture->currentTest->index;
+    if(size == 0)
+        return;
+    failure.fileSize = TAU_CAST(tau_u32, strlen(file));
+    failure.line = line;
+
+    recordStart = capture->events.size;
+    tauStreamAppendRecord(&capture->events, TAU_STREAM_ASSERTION_FAILURE, &failure, sizeof(failure), file,
+                          failure.fileSize, TAU_NULL, 0);
+
+    // Copy the message over without colour codes, then fill in its size
+    messageStart = capture->events.size;
+    for(tau_ull i = 0; i < size; i++) {
+        tau_ull run = i;
+        while(i < size && text[i] != '\033')
+            i++;
+        tauBufferAppend(&capture->events, text + run, i - run);
+        if(i + 1 < size && text[i + 1] == '[') {
+            for(i += 2; i < size && !(text[i] >= '@' && text[i] <= '~'); i++) {}
+        }
+    }
+    if(capture->events.size > recordStart) {
+        tauStreamRecordStruct record;
+        memcpy(&record, capture->events.data + recordStart, sizeof(record));
+        failure.messageSize = TAU_CAST(tau_u32, capture->events.size - messageStart);
+        record.size += failure.messageSize;
+        memcpy(capture->events.data + recordStart, &record, sizeof(record));
+        memcpy(capture->events.data + recordStart + sizeof(record), &failure, sizeof(failure));
+    }
+
+    capture->failureMark = capture->console.size;
 }
 
 #endif // TAU_NO_TESTING
 
 static void incrementWarnings() {
 #ifndef TAU_NO_TESTING
-    tauStatsNumWarnings++;
+    TAU_ATOMIC_ADD(&tauStatsNumWarnings, 1);
 #endif // TAU_NO_TESTING
 }
 
@@ -229,52 +665,213 @@ TAU_EXTERN tauTestStateStruct tauTestContext;
         #define TAU_USE_CLOCKGETTIME
     #endif // __GLIBC__
 
+    #if !defined(TAU_HAS_POSIX_TIMER_) && defined(TAU_USE_CLOCKGETTIME)
+        // Strict ISO C modes (e.g. `-std=c11`) hide POSIX's clocks, but the C library has them all the same.
+        // Clock IDs are part of the kernel's ABI, and `clockid_t` is an `int` in both glibc and musl.
+        TAU_C_FUNC int clock_gettime(int, struct timespec*);
+        #define TAU_HAS_POSIX_TIMER_            1
+        #define TAU_CLOCK_MONOTONIC_            1
+        #define TAU_CLOCK_PROCESS_CPUTIME_ID_   2
+    #endif // TAU_HAS_POSIX_TIMER_
+
 #elif defined(__APPLE__)
     #include <mach/mach_time.h>
 #endif // _MSC_VER
 
+#if defined(TAU_HAS_POSIX_TIMER_) && !defined(TAU_CLOCK_MONOTONIC_)
+    #define TAU_CLOCK_MONOTONIC_            CLOCK_MONOTONIC
+    #define TAU_CLOCK_PROCESS_CPUTIME_ID_   CLOCK_PROCESS_CPUTIME_ID
+#endif // TAU_HAS_POSIX_TIMER_
+
+#if defined(TAU_HAS_POSIX_TIMER_) && defined(__linux__) && !defined(TAU_USE_CLOCKGETTIME)
+    #define TAU_CLOCK_GETTIME_(id, ts)  syscall(SYS_clock_gettime, id, ts)
+#else
+    #define TAU_CLOCK_GETTIME_(id, ts)  clock_gettime(id, ts)
+#endif // TAU_USE_CLOCKGETTIME
+
+// A free-running cycle counter, for `--time=cycles`
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define TAU_HAS_CYCLE_COUNTER_  1
+    static inline tau_u64 tauCycleCounter() {
+        tau_u32 lo, hi;
+        __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+        return (TAU_CAST(tau_u64, hi) << 32) | lo;
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    #define TAU_HAS_CYCLE_COUNTER_  1
+    static inline tau_u64 tauCycleCounter() {
+        tau_u64 value;
+        __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(value) : : "memory");
+        return value;
+    }
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define TAU_HAS_CYCLE_COUNTER_  1
+    static inline tau_u64 tauCycleCounter() { return __rdtsc(); }
+#endif // __GNUC__
+
 /**
     Tau Timer
-    This method is useful in timing the execution of an Tau Test Suite
-    To use this, simply call this function before and after the particular code block you want to time,
-    and their difference will give you the time (in seconds).
-    NOTE: This method has been edited to return the time (in nanoseconds). Depending on how large this value
-    (e.g: 54890938849ns), we appropriately convert it to milliseconds/seconds before displaying it to stdout.
+    `tauClock()` returns a timestamp in nanoseconds; the difference of two timestamps is the time that passed in
+    between, on the clock selected with `--time`:
+        real    A monotonic clock (the default). Unlike the time of day, it is not affected by NTP adjusting the
+                system clock.
+        cpu     The CPU time used by the process (`CLOCK_PROCESS_CPUTIME_ID`)
+        cycles  The CPU's cycle counter (`rdtsc`, `cntvct_el0`), calibrated against the monotonic clock. The
+                cheapest to read, which matters for tests that only take a few hundred nanoseconds.
+
+    `tauClockInit()` sets the clock up, and measures how long reading it takes, so that `tauClockSince()` can
+    leave that out of the durations it reports.
 */
-static inline double tauClock() {
+#define TAU_CLOCK_REAL_     0
+#define TAU_CLOCK_CPU_      1
+#define TAU_CLOCK_CYCLES_   2
+
+typedef struct tauClockStruct {
+    int source;                 // One of the `TAU_CLOCK_*_` values
+    tau_u64 overhead;           // Time a back-to-back pair of `tauClock()` calls measures, in nanoseconds
+    tau_u64 cycleBase;          // `tauCycleCounter()` when the cycle counter was calibrated
+    double nsPerCycle;
+} tauClockStruct;
+
+TAU_EXTERN tauClockStruct tauClockState;
+
+static inline tau_u64 tauClockMonotonic() {
 #ifdef TAU_WIN_
+    static LARGE_INTEGER frequency = {0};
     LARGE_INTEGER counter;
-    LARGE_INTEGER frequency;
+    if(frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&counter);
-    QueryPerformanceFrequency(&frequency);
-    return TAU_CAST(double, (counter.QuadPart * 1000 * 1000 * 1000) / frequency.QuadPart); // in nanoseconds
+    // Split the conversion up, so that it can't overflow
+    return TAU_CAST(tau_u64, (counter.QuadPart / frequency.QuadPart) * 1000000000 +
+                             (counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart);
+
+#elif defined(TAU_HAS_POSIX_TIMER_)
+    struct timespec ts = {0, 0};
+    TAU_CLOCK_GETTIME_(TAU_CLOCK_MONOTONIC_, &ts);
+    return TAU_CAST(tau_u64, ts.tv_sec) * 1000000000 + TAU_CAST(tau_u64, ts.tv_nsec);
 
-#elif defined(__linux) && defined(__STRICT_ANSI__)
-    return TAU_CAST(double, clock()) * 1000000000 / CLOCKS_PER_SEC; // in nanoseconds
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase = {0, 0};
+    if(timebase.denom == 0)
+        mach_timebase_info(&timebase);
+    return mach_absolute_time() * timebase.numer / timebase.denom;
 
-#elif defined(__linux)
+#else
     struct timespec ts = {0, 0};
-    #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
-        timespec_get(&ts, TIME_UTC);
-    #else
-        const clockid_t cid = CLOCK_REALTIME;
-        #if defined(TAU_USE_CLOCKGETTIME)
-            clock_gettime(cid, &ts);
-        #else
-            syscall(SYS_clock_gettime, cid, &ts);
-        #endif
-    #endif
-    return TAU_CAST(double, ts.tv_sec) * 1000 * 1000 * 1000 + TAU_CAST(double, ts.tv_nsec); // in nanoseconds
+    timespec_get(&ts, TIME_UTC);
+    return TAU_CAST(tau_u64, ts.tv_sec) * 1000000000 + TAU_CAST(tau_u64, ts.tv_nsec);
+#endif // TAU_WIN_
+}
+
+static inline tau_u64 tauClockProcessCPU() {
+#ifdef TAU_WIN_
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime);
+    // In units of 100ns
+    return ((TAU_CAST(tau_u64, kernelTime.dwHighDateTime) << 32 | kernelTime.dwLowDateTime) +
+            (TAU_CAST(tau_u64, userTime.dwHighDateTime) << 32 | userTime.dwLowDateTime)) * 100;
+
+#elif defined(TAU_HAS_POSIX_TIMER_)
+    struct timespec ts = {0, 0};
+    TAU_CLOCK_GETTIME_(TAU_CLOCK_PROCESS_CPUTIME_ID_, &ts);
+    return TAU_CAST(tau_u64, ts.tv_sec) * 1000000000 + TAU_CAST(tau_u64, ts.tv_nsec);
 
-#elif __APPLE__
-    return TAU_CAST(double, mach_absolute_time());
+#else
+    return TAU_CAST(tau_u64, TAU_CAST(double, clock()) * 1000000000 / CLOCKS_PER_SEC);
 #endif // TAU_WIN_
 }
 
-static void tauClockPrintDuration(const double nanoseconds_duration) {
+static inline tau_u64 tauClock() {
+#ifdef TAU_HAS_CYCLE_COUNTER_
+    if(tauClockState.source == TAU_CLOCK_CYCLES_)
+        return TAU_CAST(tau_u64, TAU_CAST(double, tauCycleCounter() - tauClockState.cycleBase) *
+                                 tauClockState.nsPerCycle);
+#endif // TAU_HAS_CYCLE_COUNTER_
+    if(tauClockState.source == TAU_CLOCK_CPU_)
+        return tauClockProcessCPU();
+    return tauClockMonotonic();
+}
+
+// Nanoseconds since `start` (a `tauClock()` timestamp), minus the cost of reading the clock
+static inline tau_u64 tauClockSince(const tau_u64 start) {
+    const tau_u64 elapsed = tauClock() - start;
+    return elapsed > tauClockState.overhead ? elapsed - tauClockState.overhead : 0;
+}
+
+#ifdef TAU_HAS_CYCLE_COUNTER_
+// Whether the cycle counter ticks at a constant rate, whatever the CPU's frequency and power state
+static tau_bool tauCycleCounterIsInvariant() {
+#if defined(__x86_64__) || defined(__i386__)
+    tau_u32 eax = 0x80000000, ebx, ecx, edx;
+    __asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    if(eax < 0x80000007)
+        return tau_false;
+    eax = 0x80000007;
+    __asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx >> 8) & 1;      // "Invariant TSC"
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, TAU_CAST(int, 0x80000000));
+    if(TAU_CAST(tau_u32, info[0]) < 0x80000007)
+        return tau_false;
+    __cpuid(info, TAU_CAST(int, 0x80000007));
+    return (info[3] >> 8) & 1;
+#else
+    // The ARM generic timer always runs at a fixed frequency
+    return tau_true;
+#endif // __x86_64__
+}
+#endif // TAU_HAS_CYCLE_COUNTER_
+
+// Set up the clock selected in `tauClockState.source` (falling back to the monotonic clock if it can't be used).
+// Returns false if it had to fall back.
+static tau_bool tauClockInit() {
+    tau_bool ok = tau_true;
+
+    if(tauClockState.source == TAU_CLOCK_CYCLES_) {
+    #ifdef TAU_HAS_CYCLE_COUNTER_
+        if(tauCycleCounterIsInvariant()) {
+            // Count cycles over a few milliseconds of monotonic time
+            const tau_u64 startNs = tauClockMonotonic();
+            const tau_u64 startCycles = tauCycleCounter();
+            tau_u64 endNs;
+            tau_u64 endCycles;
+
+            do {
+                endNs = tauClockMonotonic();
+                endCycles = tauCycleCounter();
+            } while(endNs - startNs < 20000000);
+
+            tauClockState.nsPerCycle = TAU_CAST(double, endNs - startNs) /
+                                       TAU_CAST(double, endCycles - startCycles);
+            tauClockState.cycleBase = endCycles;
+        } else {
+            tauClockState.source = TAU_CLOCK_REAL_;
+            ok = tau_false;
+        }
+    #else
+        tauClockState.source = TAU_CLOCK_REAL_;
+        ok = tau_false;
+    #endif // TAU_HAS_CYCLE_COUNTER_
+    }
+
+    // The smallest interval the clock can measure between two back-to-back reads
+    tauClockState.overhead = 0;
+    for(int i = 0; i < 64; i++) {
+        const tau_u64 start = tauClock();
+        const tau_u64 elapsed = tauClock() - start;
+        if(i == 0 || elapsed < tauClockState.overhead)
+            tauClockState.overhead = elapsed;
+    }
+    return ok;
+}
+
+static void tauClockPrintDuration(const tau_u64 nanoseconds_duration) {
     tau_u64 n;
     int num_digits = 0;
-    n = TAU_CAST(tau_u64, nanoseconds_duration);
+    n = nanoseconds_duration;
     while(n!=0) {
         n/=10;
         ++num_digits;
@@ -282,14 +879,14 @@ static void tauClockPrintDuration(const double nanoseconds_duration) {
 
     // Stick with nanoseconds (no need for decimal points here)
     switch(num_digits) {
-        case 1: case 2:
-            printf("%.0lfns", nanoseconds_duration); break;
+        case 0: case 1: case 2:
+            tauConsolePrintf("%" TAU_PRIu64 "ns", nanoseconds_duration); break;
         case 3: case 4: case 5:
-            printf("%.2lfus", nanoseconds_duration/1000); break;
+            tauConsolePrintf("%.2lfus", TAU_CAST(double, nanoseconds_duration)/1000); break;
         case 6: case 7: case 8:
-            printf("%.2lfms", nanoseconds_duration/1000000); break;
+            tauConsolePrintf("%.2lfms", TAU_CAST(double, nanoseconds_duration)/1000000); break;
         default:
-            printf("%.2lfs", nanoseconds_duration/1000000000); break;
+            tauConsolePrintf("%.2lfs", TAU_CAST(double, nanoseconds_duration)/1000000000); break;
     }
 }
 
@@ -313,6 +910,20 @@ static void tauClockPrintDuration(const double nanoseconds_duration) {
         static void f(void)
 #endif // _MSC_VER
 
+/**
+    Section-based registry (opt-in: define `TAU_SECTION_REGISTRY` before including this file)
+    Instead of running one constructor per test at load time, every `TEST()`/`TEST_F()` places a const
+    descriptor in the `tau_tests` section, and `tau_main` links them all up in a single pass over
+    `__start_tau_tests`..`__stop_tau_tests`. Only available for ELF targets; elsewhere this falls back to
+    constructors. Note that sanitizers which pad globals with redzones (ASan) break the section layout.
+
+    `tau_main` always scans the section (it is simply empty if nothing was placed there), so translation units
+    built with and without `TAU_SECTION_REGISTRY` can be mixed freely.
+*/
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+    #define TAU_HAS_TEST_SECTION_ 1
+#endif // __ELF__
+
 
 static inline void* tau_realloc(void* const ptr, const tau_ull new_size) {
     void* const new_ptr = realloc(ptr, new_size);
@@ -322,6 +933,117 @@ static inline void* tau_realloc(void* const ptr, const tau_ull new_size) {
 
     return new_ptr;
 }
+
+#ifdef TAU_HAS_THREADS_
+    #ifdef TAU_WIN_
+        typedef HANDLE              tau_thread_t;
+        typedef CRITICAL_SECTION    tau_mutex_t;
+        typedef DWORD               tau_thread_result_t;
+        #define TAU_THREAD_CALL     WINAPI
+    #else
+        typedef pthread_t           tau_thread_t;
+        typedef pthread_mutex_t     tau_mutex_t;
+        typedef void*               tau_thread_result_t;
+        #define TAU_THREAD_CALL
+    #endif // TAU_WIN_
+
+    typedef tau_thread_result_t (TAU_THREAD_CALL *tau_thread_func_t)(void*);
+
+    static tau_bool tauThreadCreate(tau_thread_t* const thread, const tau_thread_func_t func, void* const arg) {
+    #ifdef TAU_WIN_
+        *thread = CreateThread(TAU_NULL, 0, func, arg, 0, TAU_NULL);
+        return *thread != TAU_NULL;
+    #else
+        return pthread_create(thread, TAU_NULL, func, arg) == 0;
+    #endif // TAU_WIN_
+    }
+
+    static void tauThreadJoin(const tau_thread_t thread) {
+    #ifdef TAU_WIN_
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+    #else
+        pthread_join(thread, TAU_NULL);
+    #endif // TAU_WIN_
+    }
+
+    static void tauMutexInit(tau_mutex_t* const mutex) {
+    #ifdef TAU_WIN_
+        InitializeCriticalSection(mutex);
+    #else
+        pthread_mutex_init(mutex, TAU_NULL);
+    #endif // TAU_WIN_
+    }
+
+    static void tauMutexLock(tau_mutex_t* const mutex) {
+    #ifdef TAU_WIN_
+        EnterCriticalSection(mutex);
+    #else
+        pthread_mutex_lock(mutex);
+    #endif // TAU_WIN_
+    }
+
+    static void tauMutexUnlock(tau_mutex_t* const mutex) {
+    #ifdef TAU_WIN_
+        LeaveCriticalSection(mutex);
+    #else
+        pthread_mutex_unlock(mutex);
+    #endif // TAU_WIN_
+    }
+
+    static void tauMutexDestroy(tau_mutex_t* const mutex) {
+    #ifdef TAU_WIN_
+        DeleteCriticalSection(mutex);
+    #else
+        pthread_mutex_destroy(mutex);
+    #endif // TAU_WIN_
+    }
+#endif // TAU_HAS_THREADS_
+
+static void tauSleep(const int milliseconds) {
+#if defined(TAU_WIN_)
+    Sleep(TAU_CAST(DWORD, milliseconds));
+#elif defined(TAU_UNIX_)
+    poll(TAU_NULL, 0, milliseconds);
+#else
+    (void)milliseconds;
+#endif // TAU_WIN_
+}
+
+// Values of `tauWatchStruct::state`
+#define TAU_WATCH_IDLE_         0
+#define TAU_WATCH_RUNNING_      1
+#define TAU_WATCH_EXPIRED_      2   // The watchdog gave up on the test (and is about to end the process)
+
+// The test a thread is running, as the watchdog sees it (see `tauWatchdogMain()`)
+typedef struct tauWatchStruct {
+    struct tauTestSuiteStruct* test;
+    tauCaptureStruct* capture;  // Where the test's output goes (TAU_NULL if it isn't captured)...
+    tau_ull outputStart;        // ...and where in `capture->console` its own output starts
+    tau_u64 start;              // `tauClockMonotonic()` when the test started
+    volatile tau_u64 limit;     // How long it may take, in nanoseconds; 0 if there's no limit
+    volatile int state;         // One of the `TAU_WATCH_*_` values
+    void (*launch)(void);       // Starts the watchdog (of the translation unit that runs the tests) if need be
+#if defined(TAU_HAS_THREADS_) && defined(TAU_UNIX_)
+    pthread_t thread;           // Signalled to dump its stack
+#endif // TAU_HAS_THREADS_
+} tauWatchStruct;
+
+TAU_EXTERN TAU_THREAD_LOCAL tauWatchStruct* tauCurrentWatch;
+
+// Number of logical CPUs available to this process (used as the default for `--jobs`)
+static tau_ull tauNumCPUs() {
+#if defined(TAU_WIN_)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return TAU_CAST(tau_ull, info.dwNumberOfProcessors);
+#elif defined(TAU_UNIX_) && defined(_SC_NPROCESSORS_ONLN)
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? TAU_CAST(tau_ull, n) : 1;
+#else
+    return 1;
+#endif // TAU_WIN_
+}
 #endif // TAU_NO_TESTING
 
 #define TAU_COLOUR_DEFAULT_              0
@@ -342,17 +1064,14 @@ tauColouredPrintf(const int colour, const char* const fmt, ...);
 static inline int TAU_ATTRIBUTE_(format (printf, 2, 3))
 tauColouredPrintf(const int colour, const char* const fmt, ...) {
     va_list args;
-    char buffer[256];
     int n;
 
     va_start(args, fmt);
-    vsnprintf(buffer, sizeof(buffer), fmt, args);
-    va_end(args);
-    buffer[sizeof(buffer)-1] = '\0';
-
 #ifndef TAU_NO_TESTING
     if(!tauShouldColourizeOutput) {
-        return printf("%s", buffer);
+        n = tauConsoleVPrintf(fmt, args);
+        va_end(args);
+        return n;
     }
 #endif // TAU_NO_TESTING
 
@@ -373,13 +1092,15 @@ tauColouredPrintf(const int colour, const char* const fmt, ...) {
             case TAU_COLOUR_BOLD_:         str = "\033[1m"; break;
             default:                       str = "\033[0m"; break;
         }
-        printf("%s", str);
-        n = printf("%s", buffer);
-        printf("\033[0m"); // Reset the colour
-        return n;
+        tauConsoleWrite(str);
+        n = tauConsoleVPrintf(fmt, args);
+        tauConsoleWrite("\033[0m"); // Reset the colour
     }
 #elif defined(TAU_WIN_)
-    {
+    // Console attributes can't be buffered; captured output is written uncoloured
+    if(tauCurrentCapture) {
+        n = tauConsoleVPrintf(fmt, args);
+    } else {
         HANDLE h;
         CONSOLE_SCREEN_BUFFER_INFO info;
         WORD attr;
@@ -405,101 +1126,912 @@ tauColouredPrintf(const int colour, const char* const fmt, ...) {
         }
         if(attr != 0)
             SetConsoleTextAttribute(h, attr);
-        n = printf("%s", buffer);
+        n = vprintf(fmt, args);
         SetConsoleTextAttribute(h, info.wAttributes);
-        return n;
     }
 #else
-    n = printf("%s", buffer);
-    return n;
+    n = tauConsoleVPrintf(fmt, args);
 #endif // TAU_UNIX_
+    va_end(args);
+    return n;
+}
+
+// Write to STDOUT. While a test runs with `--output` enabled, this also ends up in its XUnit record.
+static inline int TAU_ATTRIBUTE_(format (printf, 1, 2))
+tauPrintf(const char* const fmt, ...);
+static inline int TAU_ATTRIBUTE_(format (printf, 1, 2))
+tauPrintf(const char* const fmt, ...) {
+    va_list args;
+    int n;
+
+    va_start(args, fmt);
+    n = tauConsoleVPrintf(fmt, args);
+    va_end(args);
+    return n;
 }
 
 #ifndef TAU_NO_TESTING
-    #define tauPrintf(...) {                                \
-        if(tauTestContext.foutput)                          \
-            fprintf(tauTestContext.foutput, __VA_ARGS__);   \
-        printf(__VA_ARGS__);                                \
+#ifdef TAU_UNIX_
+static tau_bool tauWriteAll(const int fd, const void* const data, const tau_ull size) {
+    const char* ptr = TAU_PTRCAST(const char*, data);
+    tau_ull remaining = size;
+
+    while(remaining > 0) {
+        const ssize_t n = write(fd, ptr, remaining);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            return tau_false;
+        }
+        ptr += n;
+        remaining -= TAU_CAST(tau_ull, n);
     }
-#else
-    #define tauPrintf(...)   \
-        printf(__VA_ARGS__)
-#endif // TAU_NO_TESTING
+    return tau_true;
+}
+#endif // TAU_UNIX_
 
+static inline void TAU_ATTRIBUTE_(format (printf, 2, 3))
+tauBufferPrintf(tauBufferStruct* const buf, const char* const fmt, ...);
+static inline void TAU_ATTRIBUTE_(format (printf, 2, 3))
+tauBufferPrintf(tauBufferStruct* const buf, const char* const fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    tauBufferVPrintf(buf, fmt, args);
+    va_end(args);
+}
 
-static inline int tauIsDigit(const char c) { return c >= '0' && c <= '9'; }
-// If the macro arguments can be decomposed further, we need to print the `In macro ..., so and so failed`.
-// This method signals whether this message should be printed.
-//
-// Note: the arguments are of type `char const*` as opposed to `char*`.
-// This helps mitigate the ``warning: ISO C++ forbids converting a string constant to 'char*'`.
-// See: https://stackoverflow.com/questions/20944784/why-is-conversion-from-string-constant-to-char-valid-in-c-but-invalid-in-c/20944858
-static inline int tauShouldDecomposeMacro(const char* const actual, const char* const expected, const int isStringCmp) {
-    // Signal that the macro can be further decomposed if either of the following symbols are present
-    int dots = 0;
-    int numActualDigits = 0;
-    int numExpectedDigits = 0;
+/**
+    Hardware performance counters (`--counters=<EVENTS>`)
+    On Linux, every thread that runs tests opens a `perf_event_open()` group with the requested events, counting
+    that thread in user space only. The group is reset and enabled just around the test function (outside of its
+    timer), so that a test isn't charged for Tau's own bookkeeping; benchmarks also read it around each sample.
+
+    Which events can be counted depends on the machine: VMs often have no PMU, and `perf_event_paranoid` may
+    forbid them. `tauCountersInit()` drops the events that can't be opened (with a warning) before any test runs;
+    if none are left, tests are only timed.
+*/
+#define TAU_COUNTER_CYCLES_             0
+#define TAU_COUNTER_INSTRUCTIONS_       1
+#define TAU_COUNTER_CACHE_REFERENCES_   2
+#define TAU_COUNTER_CACHE_MISSES_       3
+#define TAU_COUNTER_BRANCHES_           4
+#define TAU_COUNTER_BRANCH_MISSES_      5
+#define TAU_COUNTER_PAGE_FAULTS_        6
+
+#ifdef TAU_HAS_COUNTERS_
+    #define TAU_COUNTER_EVENT_(name, type, config)      { name, PERF_TYPE_##type, PERF_COUNT_##config }
+#else
+    #define TAU_COUNTER_EVENT_(name, type, config)      { name, 0, 0 }
+#endif // TAU_HAS_COUNTERS_
+
+typedef struct tauCounterEventStruct {
+    const char* name;
+    tau_u32 type;
+    tau_u64 config;
+} tauCounterEventStruct;
+
+// Indexed by the `TAU_COUNTER_*_` constants above
+static const tauCounterEventStruct tauCounterEvents[] = {
+    TAU_COUNTER_EVENT_("cycles",            HARDWARE,   HW_CPU_CYCLES),
+    TAU_COUNTER_EVENT_("instructions",      HARDWARE,   HW_INSTRUCTIONS),
+    TAU_COUNTER_EVENT_("cache-references",  HARDWARE,   HW_CACHE_REFERENCES),
+    TAU_COUNTER_EVENT_("cache-misses",      HARDWARE,   HW_CACHE_MISSES),
+    TAU_COUNTER_EVENT_("branches",          HARDWARE,   HW_BRANCH_INSTRUCTIONS),
+    TAU_COUNTER_EVENT_("branch-misses",     HARDWARE,   HW_BRANCH_MISSES),
+    TAU_COUNTER_EVENT_("page-faults",       SOFTWARE,   SW_PAGE_FAULTS)
+};
+#define TAU_NUM_COUNTER_EVENTS_     (sizeof(tauCounterEvents) / sizeof(tauCounterEvents[0]))
+#define TAU_DEFAULT_COUNTERS_       "cycles,instructions,cache-misses,branch-misses"
+
+typedef struct tauCounterRatioStruct {
+    const char* name;
+    int numerator;
+    int denominator;
+    double scale;
+} tauCounterRatioStruct;
+
+// Derived from the counts, whenever both of the events they need were counted
+static const tauCounterRatioStruct tauCounterRatios[] = {
+    { "ipc",                TAU_COUNTER_INSTRUCTIONS_,  TAU_COUNTER_CYCLES_,            1 },
+    { "cache-miss-%",       TAU_COUNTER_CACHE_MISSES_,  TAU_COUNTER_CACHE_REFERENCES_,  100 },
+    { "branch-miss-%",      TAU_COUNTER_BRANCH_MISSES_, TAU_COUNTER_BRANCHES_,          100 },
+    { "cache-mpki",         TAU_COUNTER_CACHE_MISSES_,  TAU_COUNTER_INSTRUCTIONS_,      1000 }, // Per 1k instructions
+    { "branch-mpki",        TAU_COUNTER_BRANCH_MISSES_, TAU_COUNTER_INSTRUCTIONS_,      1000 }
+};
+#define TAU_MAX_METRICS_    (TAU_MAX_COUNTERS_ + sizeof(tauCounterRatios) / sizeof(tauCounterRatios[0]) + TAU_NUM_RESOURCES_)
+
+// The events to count. Set up once by the main thread, before any test runs.
+typedef struct tauCounterConfigStruct {
+    int numEvents;
+    int events[TAU_MAX_COUNTERS_];          // `TAU_COUNTER_*_` constants; the first one leads the group
+} tauCounterConfigStruct;
+
+// The counter group of a thread
+typedef struct tauCounterGroupStruct {
+    int state;                              // 0: not opened yet, 1: open, -1: can't be opened on this thread
+    int fds[TAU_MAX_COUNTERS_];
+} tauCounterGroupStruct;
+
+// What gets reported for a test or benchmark: the counts, followed by whichever ratios they allow for (and, for
+// a test, by its resource usage)
+typedef struct tauMetricsStruct {
+    const char* names[TAU_MAX_METRICS_];
+    double values[TAU_MAX_METRICS_];
+    int numCounts;
+    int numMetrics;
+} tauMetricsStruct;
+
+TAU_EXTERN tauCounterConfigStruct tauCounterConfig;
+TAU_EXTERN TAU_THREAD_LOCAL tauCounterGroupStruct tauCounterGroup;
+
+#ifdef TAU_HAS_COUNTERS_
+static int tauCounterOpen(const int event, const int groupFd) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = tauCounterEvents[event].type;
+    attr.config = tauCounterEvents[event].config;
+    attr.disabled = groupFd < 0;            // The group is enabled and disabled through its leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return TAU_CAST(int, syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif // TAU_HAS_COUNTERS_
 
-    // If not inside a string comparison, we will return `1` only if we determine that `actual` is a variable
-    // name/expression (i.e for a value, we search through each character verifying that each is a digit
-    // - for floats, we allow a maximum of 1 '.' char)
-    if(!isStringCmp) {
-        for(int i = 0; i < strlen(actual); i++) {
-            if(tauIsDigit(actual[i])) {
-                numActualDigits++;
-            } else if(actual[i] == '.') {
-                dots++;
-                if(dots > 1) { return 1; }
-            } else {
-                return 1;
-            }
+static void tauCountersClose() {
+#ifdef TAU_HAS_COUNTERS_
+    if(tauCounterGroup.state == 1) {
+        for(int i = tauCounterConfig.numEvents - 1; i >= 0; i--)
+            close(tauCounterGroup.fds[i]);
+    }
+#endif // TAU_HAS_COUNTERS_
+    tauCounterGroup.state = 0;
+}
+
+static void tauCountersOpen() {
+    tauCounterGroup.state = -1;
+#ifdef TAU_HAS_COUNTERS_
+    for(int i = 0; i < tauCounterConfig.numEvents; i++) {
+        const int fd = tauCounterOpen(tauCounterConfig.events[i], i == 0 ? -1 : tauCounterGroup.fds[0]);
+        if(fd < 0) {
+            while(i-- > 0)
+                close(tauCounterGroup.fds[i]);
+            return;
         }
-        // Do the same for `expected`
-        dots = 0;
-        for(int i=0; i < strlen(expected); i++) {
-            if(tauIsDigit(expected[i])) {
-                numExpectedDigits++;
-            } else if(expected[i] == '.') {
-                dots++;
-                if(dots > 1) { return 1; }
-            } else {
-                return 1;
-            }
+        tauCounterGroup.fds[i] = fd;
+    }
+    tauCounterGroup.state = 1;
+#endif // TAU_HAS_COUNTERS_
+}
+
+// Drop the requested events this machine can't count, warning about each of them
+static void tauCountersInit() {
+    int numEvents = 0;
+
+    if(tauCounterConfig.numEvents == 0)
+        return;
+#ifdef TAU_HAS_COUNTERS_
+    for(int i = 0; i < tauCounterConfig.numEvents; i++) {
+        const int event = tauCounterConfig.events[i];
+        const int fd = tauCounterOpen(event, -1);
+        if(fd < 0) {
+            const int error = errno;
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Can't count %s (perf_event_open: %s%s)\n",
+                              tauCounterEvents[event].name, strerror(error),
+                              error == EACCES || error == EPERM ? "; see /proc/sys/kernel/perf_event_paranoid" : "");
+            continue;
         }
+        close(fd);
+        tauCounterConfig.events[numEvents++] = event;
     }
-    // Inside a string comparison, we search for common expression tokens like the following:
-    // '(', ')', '-'
-    else {
-        if(strchr(actual, '(') != NULL || strchr(expected, '(') != NULL ||
-           actual[0] != '"' || expected[0] != '"' ) {
-            return 1;
+    tauCounterConfig.numEvents = numEvents;
+
+    // Each event can be counted, but maybe not all of them at once
+    if(numEvents > 0) {
+        tauCountersOpen();
+        if(tauCounterGroup.state != 1) {
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Can't count all of the --counters events at once\n");
+            numEvents = 0;
         }
+        tauCountersClose();
     }
-    return 0;
+#else
+    tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Performance counters aren't available in this build\n");
+#endif // TAU_HAS_COUNTERS_
+
+    tauCounterConfig.numEvents = numEvents;
+    if(numEvents == 0)
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: No performance counters available; timing tests only\n");
 }
 
+// Read the counts (scaled up if the kernel had to multiplex the group). Returns false if this thread isn't counting.
+static tau_bool tauCountersRead(tau_u64* const values) {
+#ifdef TAU_HAS_COUNTERS_
+    // `nr`, `time_enabled`, `time_running`, then the values
+    tau_u64 data[3 + TAU_MAX_COUNTERS_];
+    const int numEvents = tauCounterConfig.numEvents;
+    const ssize_t size = TAU_CAST(ssize_t, sizeof(tau_u64) * TAU_CAST(tau_ull, 3 + numEvents));
+
+    if(tauCounterGroup.state != 1 || read(tauCounterGroup.fds[0], data, TAU_CAST(size_t, size)) != size ||
+       data[0] != TAU_CAST(tau_u64, numEvents) || (data[1] > 0 && data[2] == 0))
+        return tau_false;
+    for(int i = 0; i < numEvents; i++) {
+        values[i] = data[2] < data[1] ? TAU_CAST(tau_u64, TAU_CAST(double, data[3 + i]) * TAU_CAST(double, data[1]) /
+                                                          TAU_CAST(double, data[2]))
+                                      : data[3 + i];
+    }
+    return tau_true;
+#else
+    (void)values;
+    return tau_false;
+#endif // TAU_HAS_COUNTERS_
+}
 
-#ifdef TAU_OVERLOADABLE
-    #ifndef TAU_CAN_USE_OVERLOADABLES
-        #define TAU_CAN_USE_OVERLOADABLES
-    #endif // TAU_CAN_USE_OVERLOADABLES
+// Start counting from zero on this thread (opening its group if need be). Returns false if it isn't counting.
+static tau_bool tauCountersStart() {
+    if(tauCounterConfig.numEvents == 0)
+        return tau_false;
+    if(tauCounterGroup.state == 0)
+        tauCountersOpen();
+#ifdef TAU_HAS_COUNTERS_
+    if(tauCounterGroup.state == 1) {
+        ioctl(tauCounterGroup.fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(tauCounterGroup.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return tau_true;
+    }
+#endif // TAU_HAS_COUNTERS_
+    return tau_false;
+}
 
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const float f);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const double d);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long double d);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const int i);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const unsigned int i);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long int i);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long unsigned int i);
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const void* const p);
+// Stop counting, and return the number of `values` read
+static int tauCountersStop(tau_u64* const values) {
+#ifdef TAU_HAS_COUNTERS_
+    ioctl(tauCounterGroup.fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif // TAU_HAS_COUNTERS_
+    return tauCountersRead(values) ? tauCounterConfig.numEvents : 0;
+}
 
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const float f) { tauPrintf("%f", TAU_CAST(double, f)); }
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const double d) { tauPrintf("%f", d); }
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long double d) { tauPrintf("%Lf", d); }
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const int i) { tauPrintf("%d", i); }
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const unsigned int i) { tauPrintf("%u", i); }
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long int i) { tauPrintf("%ld", i); }
-    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long unsigned int i) { tauPrintf("%lu", i); }
+static void tauCounterMetrics(tauMetricsStruct* const metrics, const double* const values, const int numValues) {
+    const double* counts[TAU_NUM_COUNTER_EVENTS_];
+
+    memset(TAU_PTRCAST(void*, counts), 0, sizeof(counts));
+    metrics->numMetrics = 0;
+    for(int i = 0; i < numValues; i++) {
+        counts[tauCounterConfig.events[i]] = &values[i];
+        metrics->names[metrics->numMetrics] = tauCounterEvents[tauCounterConfig.events[i]].name;
+        metrics->values[metrics->numMetrics++] = values[i];
+    }
+    metrics->numCounts = metrics->numMetrics;
+
+    for(tau_ull i = 0; i < sizeof(tauCounterRatios) / sizeof(tauCounterRatios[0]); i++) {
+        const tauCounterRatioStruct* const ratio = &tauCounterRatios[i];
+        if(TAU_NONE(counts[ratio->numerator]) || TAU_NONE(counts[ratio->denominator]) ||
+           *counts[ratio->denominator] <= 0)
+            continue;
+        metrics->names[metrics->numMetrics] = ratio->name;
+        metrics->values[metrics->numMetrics++] = *counts[ratio->numerator] / *counts[ratio->denominator] * ratio->scale;
+    }
+}
+
+// Metrics of a test that was counted
+static void tauCounterTestMetrics(tauMetricsStruct* const metrics, const tauTestResultStruct* const result) {
+    double values[TAU_MAX_COUNTERS_];
+    for(int i = 0; i < result->numCounters; i++)
+        values[i] = TAU_CAST(double, result->counters[i]);
+    tauCounterMetrics(metrics, values, result->numCounters);
+}
+
+static void tauCountersPrint(const tauMetricsStruct* const metrics, const tau_bool perOp) {
+    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "[ COUNTERS ] ");
+    for(int i = 0; i < metrics->numMetrics; i++) {
+        tauConsolePrintf(i == 0 ? "%s " : (i == metrics->numCounts ? "; %s " : ", %s "), metrics->names[i]);
+        tauConsolePrintf(i < metrics->numCounts && !perOp ? "%.0f" : "%.2f", metrics->values[i]);
+    }
+    tauConsolePrintf(perOp ? " (counts per op)\n" : "\n");
+}
+
+/**
+    Resource usage (`--resources`)
+    `getrusage()` is sampled just before and after the test function, like the counters. Page faults and context
+    switches are counted for the calling thread where the OS can (Linux), so tests running on other `--jobs`
+    workers don't get charged for them. Memory is a property of the whole process though: the peak RSS only ever
+    grows, so a test shows up there only if it pushes the high-water mark, and the current RSS (read from
+    `/proc/self/statm`, on Linux only) moves with whatever else runs at the same time.
+*/
+#ifdef TAU_LINUX_
+    #ifndef RUSAGE_THREAD
+        #define RUSAGE_THREAD   1   // Hidden without `_GNU_SOURCE`
+    #endif // RUSAGE_THREAD
+    #define TAU_RUSAGE_WHO_     RUSAGE_THREAD
+#else
+    #define TAU_RUSAGE_WHO_     RUSAGE_SELF
+#endif // TAU_LINUX_
+
+// Indexed by the `TAU_RESOURCE_*_` constants
+static const char* const tauResourceNames[TAU_NUM_RESOURCES_] = {
+    "max-rss-growth-bytes", "rss-growth-bytes", "minor-faults", "major-faults", "voluntary-switches",
+    "involuntary-switches"
+};
+
+#ifdef TAU_LINUX_
+// The current resident set size, in bytes. Read without stdio, which would allocate.
+static tau_i64 tauResidentBytes() {
+    char data[128];
+    const int fd = open("/proc/self/statm", O_RDONLY);
+    ssize_t size;
+    const char* resident;
+
+    if(fd < 0)
+        return 0;
+    size = read(fd, data, sizeof(data) - 1);
+    close(fd);
+    if(size <= 0)
+        return 0;
+    data[size] = TAU_NULLCHAR;
+
+    // The total program size comes first, then the resident set (both in pages)
+    resident = strchr(data, ' ');
+    return TAU_SOME(resident) ? strtoll(resident + 1, TAU_NULL, 10) * sysconf(_SC_PAGESIZE) : 0;
+}
+#endif // TAU_LINUX_
+
+// Returns false if resource usage can't be measured on this platform
+static tau_bool tauResourcesSample(tau_i64* const values) {
+#ifdef TAU_UNIX_
+    struct rusage usage;
+
+    if(getrusage(TAU_RUSAGE_WHO_, &usage) != 0)
+        return tau_false;
+    #ifdef __APPLE__
+        values[TAU_RESOURCE_MAX_RSS_] = TAU_CAST(tau_i64, usage.ru_maxrss);             // Bytes
+    #else
+        values[TAU_RESOURCE_MAX_RSS_] = TAU_CAST(tau_i64, usage.ru_maxrss) * 1024;      // Kilobytes
+    #endif // __APPLE__
+    #ifdef TAU_LINUX_
+        values[TAU_RESOURCE_RSS_] = tauResidentBytes();
+    #else
+        values[TAU_RESOURCE_RSS_] = 0;
+    #endif // TAU_LINUX_
+    values[TAU_RESOURCE_MINOR_FAULTS_] = TAU_CAST(tau_i64, usage.ru_minflt);
+    values[TAU_RESOURCE_MAJOR_FAULTS_] = TAU_CAST(tau_i64, usage.ru_majflt);
+    values[TAU_RESOURCE_VOLUNTARY_SWITCHES_] = TAU_CAST(tau_i64, usage.ru_nvcsw);
+    values[TAU_RESOURCE_INVOLUNTARY_SWITCHES_] = TAU_CAST(tau_i64, usage.ru_nivcsw);
+    return tau_true;
+#else
+    (void)values;
+    return tau_false;
+#endif // TAU_UNIX_
+}
+
+// Print a number of bytes, e.g. "1.50 MiB" (or "+1.50 MiB" with `showSign`)
+static void tauPrintBytes(const tau_i64 bytes, const tau_bool showSign) {
+    const char* const units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+    double value = TAU_CAST(double, bytes < 0 ? -bytes : bytes);
+    int unit = 0;
+
+    while(value >= 1024 && unit < 4) {
+        value /= 1024;
+        unit++;
+    }
+    tauConsolePrintf(unit == 0 ? "%s%.0f %s" : "%s%.2f %s", bytes < 0 ? "-" : (showSign ? "+" : ""), value,
+                     units[unit]);
+}
+
+static void tauResourcesPrint(const tau_i64* const values) {
+    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "[ RESOURCE ] ");
+    tauConsolePrintf("rss ");
+    tauPrintBytes(values[TAU_RESOURCE_RSS_], tau_true);
+    tauConsolePrintf(" (peak ");
+    tauPrintBytes(values[TAU_RESOURCE_MAX_RSS_], tau_true);
+    tauConsolePrintf("), faults %" TAU_PRId64 " minor / %" TAU_PRId64 " major, "
+                     "context switches %" TAU_PRId64 " voluntary / %" TAU_PRId64 " involuntary\n",
+                     values[TAU_RESOURCE_MINOR_FAULTS_], values[TAU_RESOURCE_MAJOR_FAULTS_],
+                     values[TAU_RESOURCE_VOLUNTARY_SWITCHES_], values[TAU_RESOURCE_INVOLUNTARY_SWITCHES_]);
+}
+
+// Everything the machine-readable reports carry for a test: its counter metrics, then its resource usage
+static void tauTestMetrics(tauMetricsStruct* const metrics, const tauTestResultStruct* const result) {
+    tauCounterTestMetrics(metrics, result);
+    if(result->hasResources) {
+        for(int i = 0; i < TAU_NUM_RESOURCES_; i++) {
+            metrics->names[metrics->numMetrics] = tauResourceNames[i];
+            metrics->values[metrics->numMetrics++] = TAU_CAST(double, result->resources[i]);
+        }
+    }
+}
+
+/**
+    Report files (the XUnit file, the binary result stream)
+    Reporters only ever hand complete records to a report file. Those are queued up and written out every
+    `TAU_REPORT_FLUSH_SIZE_` bytes or once a second, bypassing stdio so that the file never ends in the middle of
+    a record. Memory use is bounded by that, plus the output of a single test.
+
+    If the process is killed by a signal, what is queued up (followed by the file's `trailer`, if any) is written
+    from the signal handler, so that the file is usable even then.
+*/
+#define TAU_REPORT_FLUSH_SIZE_       65536
+#define TAU_REPORT_FLUSH_INTERVAL_   1000000000      // In nanoseconds, like `tauClock()`
+
+typedef struct tauReportFileStruct {
+    FILE* file;
+    int open;
+    tauBufferStruct pending;
+    tau_u64 lastFlush;
+    volatile int busy;          // `pending` is being modified
+    const char* trailer;        // Written after `pending` if the process is killed
+#ifdef TAU_UNIX_
+    int fd;                     // A descriptor of our own (which the signal handler can use as well)
+#endif // TAU_UNIX_
+} tauReportFileStruct;
+
+static tauReportFileStruct tauXUnitReport;
+static tauReportFileStruct tauStreamReport;
+
+static void tauReportFlush(tauReportFileStruct* const report) {
+    report->busy = 1;
+    if(report->pending.size > 0 && report->open) {
+    #ifdef TAU_UNIX_
+        tauWriteAll(report->fd, report->pending.data, report->pending.size);
+    #else
+        fwrite(report->pending.data, 1, report->pending.size, report->file);
+        fflush(report->file);
+    #endif // TAU_UNIX_
+    }
+    report->pending.size = 0;
+    report->busy = 0;
+    report->lastFlush = tauClock();
+}
+
+// Queue one or more complete records
+static void tauReportWrite(tauReportFileStruct* const report, const char* const data, const tau_ull size) {
+    report->busy = 1;
+    tauBufferAppend(&report->pending, data, size);
+    report->busy = 0;
+    if(report->pending.size >= TAU_REPORT_FLUSH_SIZE_ ||
+       tauClock() - report->lastFlush >= TAU_REPORT_FLUSH_INTERVAL_)
+        tauReportFlush(report);
+}
+
+#ifdef TAU_UNIX_
+static const int tauReportSignals[] = { SIGINT, SIGTERM, SIGHUP, SIGQUIT, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+#define TAU_REPORT_NUM_SIGNALS_ (sizeof(tauReportSignals) / sizeof(tauReportSignals[0]))
+static void (*tauReportPreviousHandlers[TAU_REPORT_NUM_SIGNALS_])(int);
+static int tauReportHandlingSignals = 0;
+
+static void tauReportSignalFlush(const tauReportFileStruct* const report) {
+    if(!report->open)
+        return;
+    if(!report->busy && report->pending.size > 0)
+        tauWriteAll(report->fd, report->pending.data, report->pending.size);
+    if(TAU_SOME(report->trailer))
+        tauWriteAll(report->fd, report->trailer, strlen(report->trailer));
+}
+
+static void tauReportSignalHandler(int sig) {
+    tauReportSignalFlush(&tauXUnitReport);
+    tauReportSignalFlush(&tauStreamReport);
+
+    // Die the way we would have without this handler
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void tauReportRestoreSignals() {
+    if(!tauReportHandlingSignals)
+        return;
+    for(tau_ull i = 0; i < TAU_REPORT_NUM_SIGNALS_; i++)
+        signal(tauReportSignals[i], tauReportPreviousHandlers[i]);
+    tauReportHandlingSignals = 0;
+}
+#endif // TAU_UNIX_
+
+// Start writing to `file` (which was opened from `path`). Returns whether that is possible.
+static tau_bool tauReportOpen(tauReportFileStruct* const report, FILE* const file, const char* const path,
+                              const char* const trailer) {
+#ifdef TAU_UNIX_
+    report->fd = open(path, O_WRONLY | O_APPEND);
+    if(report->fd < 0)
+        return tau_false;
+#else
+    (void)path;
+#endif // TAU_UNIX_
+    report->file = file;
+    report->trailer = trailer;
+    report->lastFlush = tauClock();
+    report->open = 1;
+
+#ifdef TAU_UNIX_
+    if(!tauReportHandlingSignals) {
+        for(tau_ull i = 0; i < TAU_REPORT_NUM_SIGNALS_; i++)
+            tauReportPreviousHandlers[i] = signal(tauReportSignals[i], tauReportSignalHandler);
+        tauReportHandlingSignals = 1;
+    }
+#endif // TAU_UNIX_
+    return tau_true;
+}
+
+// Write out everything that is left. The `FILE` itself stays open.
+static void tauReportClose(tauReportFileStruct* const report) {
+#ifdef TAU_UNIX_
+    if(!tauXUnitReport.open || !tauStreamReport.open)
+        tauReportRestoreSignals();
+#endif // TAU_UNIX_
+    tauReportFlush(report);
+    tauBufferFree(&report->pending);
+    report->open = 0;
+#ifdef TAU_UNIX_
+    close(report->fd);
+    report->fd = -1;
+#endif // TAU_UNIX_
+}
+
+/**
+    XUnit/JUnit reporter (`--output=<FILE>`)
+    A test's `<testcase>` element is generated once it is done, from its duration and everything it printed to the
+    console (capped at `TAU_XUNIT_MAX_TEXT_` in the file). Complete elements go to a report file, which closes the
+    root elements if the process is killed, so that the file is valid XML even then.
+*/
+#define TAU_XUNIT_MAX_TEXT_         16384
+#define TAU_XUNIT_TRAILER_          "</testsuite>\n</testsuites>\n"
+
+// Append `text[0..size)`, escaped for use in XML text (or, if `inAttribute`, in an attribute value).
+// Console colour codes are dropped, as are control characters that XML 1.0 doesn't allow.
+static void tauXmlEscape(tauBufferStruct* const out, const char* const text, const tau_ull size,
+                         const int inAttribute) {
+    tau_ull run = 0;
+
+    for(tau_ull i = 0; i < size; i++) {
+        const unsigned char c = TAU_CAST(unsigned char, text[i]);
+        const char* entity = TAU_NULL;
+
+        if(c >= 0x20 && c != '&' && c != '<' && c != '>' && c != '"' && c != '\'')
+            continue;
+
+        tauBufferAppend(out, text + run, i - run);
+        run = i + 1;
+        switch(c) {
+            case '&':   entity = "&amp;"; break;
+            case '<':   entity = "&lt;"; break;
+            case '>':   entity = "&gt;"; break;
+            case '"':   entity = "&quot;"; break;
+            case '\'':  entity = "&apos;"; break;
+            case '\t':  entity = inAttribute ? "&#9;" : "\t"; break;
+            case '\n':  entity = inAttribute ? "&#10;" : "\n"; break;
+            case '\r':  entity = "&#13;"; break;
+            case 0x1B:
+                // Skip the rest of an ANSI escape sequence (e.g. "\033[1;31m")
+                if(i + 1 < size && text[i + 1] == '[') {
+                    i++;
+                    while(i + 1 < size && !(text[i + 1] >= '@' && text[i + 1] <= '~'))
+                        i++;
+                    i++;
+                    run = i + 1;
+                }
+                break;
+            default:    break;
+        }
+        if(TAU_SOME(entity))
+            tauBufferAppend(out, entity, strlen(entity));
+    }
+    if(run < size)
+        tauBufferAppend(out, text + run, size - run);
+}
+
+// Append the `<testcase>` element of a finished test. `text` is its console output (the failure message, if it
+// failed).
+static void tauXUnitTestCase(tauBufferStruct* const out, const tauTestSuiteStruct* const test, const char* text,
+                             tau_ull size) {
+    const char* const dot = strchr(test->name, '.');
+    const char* const name = TAU_SOME(dot) ? dot + 1 : test->name;
+    const int failed = test->result.status == TAU_TEST_FAILED_;
+    const int truncated = size > TAU_XUNIT_MAX_TEXT_;
+    tauMetricsStruct metrics;
+
+    tauTestMetrics(&metrics, &test->result);
+    if(truncated)
+        size = TAU_XUNIT_MAX_TEXT_;
+
+    tauBufferPrintf(out, "<testcase classname=\"");
+    tauXmlEscape(out, test->name, TAU_SOME(dot) ? TAU_CAST(tau_ull, dot - test->name) : 0, 1);
+    tauBufferPrintf(out, "\" name=\"");
+    tauXmlEscape(out, name, strlen(name), 1);
+    tauBufferPrintf(out, "\" file=\"");
+    tauXmlEscape(out, test->file, strlen(test->file), 1);
+    tauBufferPrintf(out, "\" line=\"%d\" time=\"%.6f\"", test->line,
+                    TAU_CAST(double, test->result.duration) / 1000000000);
+
+    if(!failed && size == 0 && metrics.numMetrics == 0) {
+        tauBufferPrintf(out, "/>\n");
+        return;
+    }
+    tauBufferPrintf(out, ">");
+
+    if(metrics.numMetrics > 0) {
+        tauBufferPrintf(out, "<properties>");
+        for(int i = 0; i < metrics.numMetrics; i++)
+            tauBufferPrintf(out, "<property name=\"%s\" value=\"%.15g\"/>", metrics.names[i], metrics.values[i]);
+        tauBufferPrintf(out, "</properties>");
+        if(!failed && size == 0) {
+            tauBufferPrintf(out, "</testcase>\n");
+            return;
+        }
+    }
+
+    if(failed) {
+        // The first line of the output is the location of the first failed assertion
+        const char* const eol = TAU_PTRCAST(const char*, memchr(text, '\n', size));
+        const tau_ull firstLine = TAU_SOME(eol) ? TAU_CAST(tau_ull, eol - text) : size;
+
+        tauBufferPrintf(out, "<failure message=\"");
+        if(firstLine > 0)
+            tauXmlEscape(out, text, firstLine, 1);
+        else
+            tauBufferPrintf(out, "FAILED");
+        tauBufferPrintf(out, "\">");
+    } else {
+        tauBufferPrintf(out, "<system-out>");
+    }
+
+    tauXmlEscape(out, text, size, 0);
+    if(truncated)
+        tauBufferPrintf(out, "\n[... output truncated]");
+    tauBufferPrintf(out, failed ? "</failure>" : "</system-out>");
+    tauBufferPrintf(out, "</testcase>\n");
+}
+
+// The spaces that pad `count` out to the most digits a `tau_u64` can have
+static int tauXUnitPadding(const tau_u64 count) {
+    int padding = 19;
+    for(tau_u64 rest = count; rest >= 10; rest /= 10)
+        padding--;
+    return padding;
+}
+
+// The counts of tests and failures are padded to the same width whatever they are, so that `tauXUnitEnd()` can
+// rewrite the header in place once the tests that actually ran are known
+static void tauXUnitHeader(tauBufferStruct* const out, const tau_u64 numTests, const tau_u64 numFailures) {
+    const int testsPadding = tauXUnitPadding(numTests);
+    const int failuresPadding = tauXUnitPadding(numFailures);
+
+    tauBufferPrintf(out, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    tauBufferPrintf(out, "<testsuites tests=\"%" TAU_PRIu64 "\"%*s failures=\"%" TAU_PRIu64 "\"%*s name=\"All\">\n",
+                    numTests, testsPadding, "", numFailures, failuresPadding, "");
+    tauBufferPrintf(out, "<testsuite name=\"Tests\" tests=\"%" TAU_PRIu64 "\"%*s failures=\"%" TAU_PRIu64 "\"%*s>\n",
+                    numTests, testsPadding, "", numFailures, failuresPadding, "");
+}
+
+// Start the XUnit file, expecting `numTests` tests
+static void tauXUnitBegin(const char* const path, const tau_u64 numTests) {
+    tauBufferStruct header;
+
+    if(!tauReportOpen(&tauXUnitReport, tauTestContext.foutput, path, TAU_XUNIT_TRAILER_)) {
+        fclose(tauTestContext.foutput);
+        tauTestContext.foutput = TAU_NULL;
+        return;
+    }
+
+    memset(&header, 0, sizeof(header));
+    tauXUnitHeader(&header, numTests, 0);
+    tauReportWrite(&tauXUnitReport, header.data, header.size);
+    tauReportFlush(&tauXUnitReport);
+    tauBufferFree(&header);
+}
+
+// Finish the XUnit file, which holds the records of `numTests` tests (as opposed to the number it was started
+// with: `--until-fail` runs an unknown number of iterations, and a timeout cuts the run short), `numFailures` of
+// which failed
+static void tauXUnitEnd(const tau_u64 numTests, const tau_u64 numFailures) {
+    tauBufferStruct header;
+
+    tauXUnitReport.trailer = TAU_NULL;
+    tauReportWrite(&tauXUnitReport, TAU_XUNIT_TRAILER_, sizeof(TAU_XUNIT_TRAILER_) - 1);
+    tauReportClose(&tauXUnitReport);
+
+    memset(&header, 0, sizeof(header));
+    tauXUnitHeader(&header, numTests, numFailures);
+    if(fseek(tauTestContext.foutput, 0, SEEK_SET) == 0) {
+        fwrite(header.data, 1, header.size, tauTestContext.foutput);
+        fflush(tauTestContext.foutput);
+    }
+    tauBufferFree(&header);
+}
+
+// Finish the XUnit file with the `<testcase>` records written so far (one per finished run of a test), and how
+// many of them failed. The runs of the current iteration count too (their results aren't in
+// `numPasses`/`numFailures` yet) if it was cut short.
+static void tauXUnitEndWithCounts(const tau_bool midIteration) {
+    tau_u64 numTests = 0, numFailures = 0;
+    for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        numTests += test->numPasses + test->numFailures;
+        numFailures += test->numFailures;
+        if(midIteration && test->result.status != TAU_TEST_NOT_RUN_) {
+            numTests++;
+            numFailures += test->result.status == TAU_TEST_FAILED_;
+        }
+    }
+    tauXUnitEnd(numTests, numFailures);
+}
+
+/**
+    Binary result stream (`--emit=bin:<FILE>`, format in <tau/stream.h>)
+    Each test's records are put together in its sink (`tauCaptureStruct::events`) and go to a report file with the
+    rest of its output; `TauConvert` turns the file into JUnit XML, JSON or TAP.
+*/
+static const char* tauStreamPath = TAU_NULL;
+
+static void tauStreamTestStart(tauBufferStruct* const events, const tauTestSuiteStruct* const test) {
+    tauStreamTestStartStruct start;
+
+    memset(&start, 0, sizeof(start));
+    start.test = test->index;
+    start.line = TAU_CAST(tau_u32, test->line);
+    start.nameSize = TAU_CAST(tau_u32, strlen(test->name));
+    start.fileSize = TAU_CAST(tau_u32, strlen(test->file));
+    tauStreamAppendRecord(events, TAU_STREAM_TEST_START, &start, sizeof(start), test->name, start.nameSize,
+                          test->file, start.fileSize);
+}
+
+static void tauStreamTestEnd(tauBufferStruct* const events, const tauTestSuiteStruct* const test) {
+    tauStreamTestEndStruct end;
+    tauMetricsStruct metrics;
+
+    tauTestMetrics(&metrics, &test->result);
+    if(metrics.numMetrics > 0) {
+        tauStreamMetricsStruct record;
+        tauBufferStruct names = { TAU_NULL, 0, 0 };
+
+        for(int i = 0; i < metrics.numMetrics; i++)
+            tauBufferPrintf(&names, i == 0 ? "%s" : ",%s", metrics.names[i]);
+        memset(&record, 0, sizeof(record));
+        record.test = test->index;
+        record.count = TAU_CAST(tau_u32, metrics.numMetrics);
+        record.namesSize = TAU_CAST(tau_u32, names.size);
+        tauStreamAppendRecord(events, TAU_STREAM_METRICS, &record, sizeof(record),
+                              TAU_PTRCAST(const char*, metrics.values), TAU_CAST(tau_u32, sizeof(double) * record.count),
+                              names.data, record.namesSize);
+        tauBufferFree(&names);
+    }
+
+    memset(&end, 0, sizeof(end));
+    end.test = test->index;
+    end.duration = test->result.duration;
+    end.status = test->result.status == TAU_TEST_FAILED_ ? TAU_STREAM_STATUS_FAILED : TAU_STREAM_STATUS_PASSED;
+    tauStreamAppendRecord(events, TAU_STREAM_TEST_END, &end, sizeof(end), TAU_NULL, 0, TAU_NULL, 0);
+}
+
+static void tauStreamEnd(const tau_u64 numTests, const tau_u64 duration) {
+    tauBufferStruct events = { TAU_NULL, 0, 0 };
+    tauStreamSummaryStruct summary;
+
+    summary.total = numTests;
+    summary.ran = tauStatsTestsRan;
+    summary.failed = tauStatsNumTestsFailed;
+    summary.skipped = tauStatsSkippedTests;
+    summary.warnings = tauStatsNumWarnings;
+    summary.duration = duration;
+    tauStreamAppendRecord(&events, TAU_STREAM_SUMMARY, &summary, sizeof(summary), TAU_NULL, 0, TAU_NULL, 0);
+
+    tauReportWrite(&tauStreamReport, events.data, events.size);
+    tauReportClose(&tauStreamReport);
+    tauBufferFree(&events);
+}
+
+// Write out (and empty) the buffers of an output sink
+static void tauSinkFlush(tauCaptureStruct* const capture) {
+    if(capture->console.size > 0) {
+        fwrite(capture->console.data + capture->written, 1, capture->console.size - capture->written, stdout);
+        capture->console.size = 0;
+        capture->written = 0;
+    }
+    if(capture->file.size > 0) {
+        tauReportWrite(&tauXUnitReport, capture->file.data, capture->file.size);
+        capture->file.size = 0;
+    }
+    if(capture->events.size > 0) {
+        tauReportWrite(&tauStreamReport, capture->events.data, capture->events.size);
+        capture->events.size = 0;
+    }
+    if(capture->benchmarks.size > 0) {
+        tauBufferAppend(&tauBenchResults, capture->benchmarks.data, capture->benchmarks.size);
+        capture->benchmarks.size = 0;
+    }
+}
+
+// Write out what a sink has printed and streamed so far, right away: on a live sink, a failure report has to come
+// out before whatever the test prints itself next, and must not be lost if the test then crashes. The console
+// buffer is kept, as the test's XUnit record and the binary stream still need it.
+static void tauSinkWriteThrough(tauCaptureStruct* const capture) {
+    fwrite(capture->console.data + capture->written, 1, capture->console.size - capture->written, stdout);
+    capture->written = capture->console.size;
+    fflush(stdout);
+    if(capture->file.size > 0) {
+        tauReportWrite(&tauXUnitReport, capture->file.data, capture->file.size);
+        capture->file.size = 0;
+    }
+    if(capture->events.size > 0) {
+        tauReportWrite(&tauStreamReport, capture->events.data, capture->events.size);
+        tauReportFlush(&tauStreamReport);
+        capture->events.size = 0;
+    }
+}
+#endif // TAU_NO_TESTING
+
+
+static inline int tauIsDigit(const char c) { return c >= '0' && c <= '9'; }
+// If the macro arguments can be decomposed further, we need to print the `In macro ..., so and so failed`.
+// This method signals whether this message should be printed.
+//
+// Note: the arguments are of type `char const*` as opposed to `char*`.
+// This helps mitigate the ``warning: ISO C++ forbids converting a string constant to 'char*'`.
+// See: https://stackoverflow.com/questions/20944784/why-is-conversion-from-string-constant-to-char-valid-in-c-but-invalid-in-c/20944858
+static inline int tauShouldDecomposeMacro(const char* const actual, const char* const expected, const int isStringCmp) {
+    // Signal that the macro can be further decomposed if either of the following symbols are present
+    int dots = 0;
+    int numActualDigits = 0;
+    int numExpectedDigits = 0;
+
+    // If not inside a string comparison, we will return `1` only if we determine that `actual` is a variable
+    // name/expression (i.e for a value, we search through each character verifying that each is a digit
+    // - for floats, we allow a maximum of 1 '.' char)
+    if(!isStringCmp) {
+        for(int i = 0; i < strlen(actual); i++) {
+            if(tauIsDigit(actual[i])) {
+                numActualDigits++;
+            } else if(actual[i] == '.') {
+                dots++;
+                if(dots > 1) { return 1; }
+            } else {
+                return 1;
+            }
+        }
+        // Do the same for `expected`
+        dots = 0;
+        for(int i=0; i < strlen(expected); i++) {
+            if(tauIsDigit(expected[i])) {
+                numExpectedDigits++;
+            } else if(expected[i] == '.') {
+                dots++;
+                if(dots > 1) { return 1; }
+            } else {
+                return 1;
+            }
+        }
+    }
+    // Inside a string comparison, we search for common expression tokens like the following:
+    // '(', ')', '-'
+    else {
+        if(strchr(actual, '(') != NULL || strchr(expected, '(') != NULL ||
+           actual[0] != '"' || expected[0] != '"' ) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+#ifdef TAU_OVERLOADABLE
+    #ifndef TAU_CAN_USE_OVERLOADABLES
+        #define TAU_CAN_USE_OVERLOADABLES
+    #endif // TAU_CAN_USE_OVERLOADABLES
+
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const float f);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const double d);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long double d);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const int i);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const unsigned int i);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long int i);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long unsigned int i);
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const void* const p);
+
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const float f) { tauPrintf("%f", TAU_CAST(double, f)); }
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const double d) { tauPrintf("%f", d); }
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long double d) { tauPrintf("%Lf", d); }
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const int i) { tauPrintf("%d", i); }
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const unsigned int i) { tauPrintf("%u", i); }
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long int i) { tauPrintf("%ld", i); }
+    TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const long unsigned int i) { tauPrintf("%lu", i); }
     TAU_WEAK TAU_OVERLOADABLE void TAU_OVERLOAD_PRINTER(const void* const p) { tauPrintf("%p", p); }
 
     // long long is in C++ only
@@ -543,166 +2075,625 @@ static inline int tauShouldDecomposeMacro(const char* const actual, const char*
         tauPrintf("If you think this was an error, please file an issue on Tau's Github repo.")
 #endif // TAU_OVERLOADABLE
 
-#ifndef TAU_NO_TESTING
-    #define TAU_FAIL_IF_INSIDE_TESTSUITE    failIfInsideTestSuite__()
-    #define TAU_ABORT_IF_INSIDE_TESTSUITE   abortIfInsideTestSuite__()
-#else
-    #define TAU_FAIL_IF_INSIDE_TESTSUITE    TAU_ABORT
-    #define TAU_ABORT_IF_INSIDE_TESTSUITE   TAU_ABORT
-#endif // TAU_NO_TESTING
-
-// ifCondFailsThenPrint is the string representation of the opposite of the truthy value of `cond`
-// For example, if `cond` is "!=", then `ifCondFailsThenPrint` will be `==`
-#if defined(TAU_CAN_USE_OVERLOADABLES)
-    #define __TAUCMP__(actual, expected, cond, space, macroName, failOrAbort)                  \
-        do {                                                                                   \
-            if(!((actual)cond(expected))) {                                                    \
-                tauPrintf("%s:%u: ", __FILE__, __LINE__);                                      \
-                tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");                          \
-                if(tauShouldDecomposeMacro(#actual, #expected, 0)) {                           \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : ");                \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "%s( %s, %s )\n",                \
-                                                                #macroName,                    \
-                                                                #actual, #expected);           \
-                }                                                                              \
-                tauPrintf("  Expected : %s", #actual);                                         \
-                printf(" %s ", #cond space);                                                   \
-                TAU_OVERLOAD_PRINTER(expected);                                                \
-                tauPrintf("\n");                                                               \
-                                                                                               \
-                tauPrintf("    Actual : %s", #actual);                                         \
-                printf(" == ");                                                                \
-                TAU_OVERLOAD_PRINTER(actual);                                                  \
-                tauPrintf("\n");                                                               \
-                failOrAbort;                                                                   \
-                if(shouldAbortTest) {                                                          \
-                    return;                                                                    \
-                }                                                                              \
-            }                                                                                  \
-        }                                                                                      \
-        while(0)
-
-// TAU_OVERLOAD_PRINTER does not work on some compilers
-#else
-    #define __TAUCMP__(actual, expected, cond, space, macroName, failOrAbort)                          \
-        do {                                                                                           \
-            if(!((actual)cond(expected))) {                                                            \
-                tauPrintf("%s:%u: ", __FILE__, __LINE__);                                              \
-                tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");                                  \
-                if(tauShouldDecomposeMacro(#actual, #expected, 0)) {                                   \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : ");                        \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "%s( %s, %s )\n",                        \
-                                                                #macroName,                            \
-                                                                #actual, #expected);                   \
-                }                                                                                      \
-                tauPrintf("  Expected : %s", #actual);                                                 \
-                printf(" %s ", #cond space);                                                           \
-                printf(#expected);                                                                     \
-                tauPrintf("\n");                                                                       \
-                                                                                                       \
-                tauPrintf("    Actual : %s", #actual);                                                 \
-                printf(" == ");                                                                        \
-                printf(#actual);                                                                       \
-                tauPrintf("\n");                                                                       \
-                failOrAbort;                                                                           \
-                if(shouldAbortTest) {                                                                  \
-                    return;                                                                            \
-                }                                                                                      \
-            }                                                                                          \
-        }                                                                                              \
-        while(0)
-#endif // TAU_CAN_USE_OVERLOADABLES
+/**
+    Failure reporting
+    An assertion only tests its condition inline. When that fails, it hands a static descriptor of itself and its
+    operands to one of the out-of-line `tauReport*Failure()` functions below, so that a passing assertion costs no
+    more than a compare and a branch, however much it would have to print otherwise.
+*/
+typedef struct tauAssertStruct {
+    const char* file;
+    unsigned line;
+    const char* call;           // The assertion as written, e.g. "CHECK_EQ( a, b )"
+    const char* actual;         // Its operands, as written
+    const char* expected;
+    const char* op;             // How `actual` should have compared to `expected`, e.g. "=="
+    const char* outcome;        // What was found instead (e.g. "not equal"); not used by CHECK_EQ and friends
+} tauAssertStruct;
+
+#define TAU_ASSERT_(call, actual, expected, op, outcome)                                           \
+    static const tauAssertStruct tau_assert_ = { __FILE__, __LINE__, call, actual, expected, op, outcome }
+
+// The operands of CHECK_EQ and friends, with their types erased. `TAU_VALUE_NONE_` if they can't be printed, in
+// which case they are shown as written.
+#define TAU_VALUE_NONE_             0
+#define TAU_VALUE_SIGNED_           1
+#define TAU_VALUE_UNSIGNED_         2
+#define TAU_VALUE_DOUBLE_           3
+#define TAU_VALUE_LONG_DOUBLE_      4
+#define TAU_VALUE_CHAR_             5
+#define TAU_VALUE_STRING_           6
+#define TAU_VALUE_POINTER_          7
+
+typedef struct tauValueStruct {
+    int type;
+    union {
+        tau_i64 i;
+        tau_u64 u;
+        double d;
+        char c;
+        const char* s;
+        const void* p;
+    } as;
+    long double ld;             // Kept out of the union: GCC notes an ABI change for unions holding a long double
+} tauValueStruct;
+
+static inline tauValueStruct tauValueNone() {
+    tauValueStruct value;
+    value.type = TAU_VALUE_NONE_;
+    value.as.u = 0;
+    value.ld = 0;
+    return value;
+}
 
-#define __TAUCMP_STR__(actual, expected, cond, ifCondFailsThenPrint, actualPrint, macroName, failOrAbort)       \
-    do {                                                                                                        \
-        if(strcmp(actual, expected) cond 0) {                                                                   \
-            tauPrintf("%s:%u: ", __FILE__, __LINE__);                                                           \
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");                                               \
-            if(tauShouldDecomposeMacro(#actual, #expected, 1)) {                                                \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : ");                                 \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "%s( %s, %s )\n",                                 \
-                                                                #macroName,                                     \
-                                                                #actual, #expected);                            \
-                }                                                                                               \
-            tauPrintf("  Expected : \"%s\" %s \"%s\"\n", actual, #ifCondFailsThenPrint, expected);              \
-            tauPrintf("    Actual : %s\n", #actualPrint);                                                       \
-            failOrAbort;                                                                                        \
-            if(shouldAbortTest) {                                                                               \
-                return;                                                                                         \
-            }                                                                                                   \
-        }                                                                                                       \
-    }                                                                                                           \
-    while(0)
+static inline tauValueStruct tauValueSigned(const tau_i64 i) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_SIGNED_;
+    value.as.i = i;
+    return value;
+}
 
+static inline tauValueStruct tauValueUnsigned(const tau_u64 u) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_UNSIGNED_;
+    value.as.u = u;
+    return value;
+}
 
-static void tauPrintColouredIfDifferent(const tau_u8 ch, const tau_u8 ref) {
-    if(ch == ref) {
-        tauPrintf("%02X", ch);
-    } else {
-        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "%02X", ch);
-    }
+static inline tauValueStruct tauValueDouble(const double d) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_DOUBLE_;
+    value.as.d = d;
+    return value;
 }
 
+static inline tauValueStruct tauValueLongDouble(const long double ld) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_LONG_DOUBLE_;
+    value.ld = ld;
+    return value;
+}
 
-static void tauPrintHexBufCmp(const void* const buff, const void* const ref, const int size) {
-    const tau_u8* const test_buff = TAU_CAST(const tau_u8* const, buff);
-    const tau_u8* const ref_buff = TAU_CAST(const tau_u8* const, ref);
+static inline tauValueStruct tauValueChar(const char c) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_CHAR_;
+    value.as.c = c;
+    return value;
+}
 
-    tauColouredPrintf(TAU_COLOUR_CYAN_,"<");
-    if(size != 0)
-        tauPrintColouredIfDifferent(test_buff[0], ref_buff[0]);
+static inline tauValueStruct tauValueString(const char* const s) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_STRING_;
+    value.as.s = s;
+    return value;
+}
 
-    for(int i = 1; i < size; ++i) {
-        printf(" ");
-        tauPrintColouredIfDifferent(test_buff[i], ref_buff[i]);
-    }
-    tauColouredPrintf(TAU_COLOUR_CYAN_,">");
+static inline tauValueStruct tauValuePointer(const void* const p) {
+    tauValueStruct value = tauValueNone();
+    value.type = TAU_VALUE_POINTER_;
+    value.as.p = p;
+    return value;
 }
 
+// `tauValue(val)` picks the constructor for the type of `val`, from the same set of types `TAU_OVERLOAD_PRINTER`
+// supports
+#ifdef TAU_OVERLOADABLE
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const float f) { return tauValueDouble(f); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const double d) { return tauValueDouble(d); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const long double d) { return tauValueLongDouble(d); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const int i) { return tauValueSigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const unsigned int i) { return tauValueUnsigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const long int i) { return tauValueSigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const long unsigned int i) { return tauValueUnsigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauValue(const void* const p) { return tauValuePointer(p); }
 
-#define __TAUCMP_BUF__(actual, expected, len, cond, ifCondFailsThenPrint, actualPrint, macroName, failOrAbort)  \
-    do {                                                                                                        \
-        if(memcmp(actual, expected, len) cond 0) {                                                              \
-            tauPrintf("%s:%u: ", __FILE__, __LINE__);                                                           \
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");                                               \
-            if(tauShouldDecomposeMacro(#actual, #expected, 1)) {                                                \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : ");                                 \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "%s( %s, %s, %s )\n",                             \
-                                                                #macroName,                                     \
-                                                                #actual, #expected, #len);                      \
-                }                                                                                               \
-            tauPrintf("  Expected : "); tauPrintHexBufCmp(actual, expected, len);                               \
-            tauPrintf(" %s ", #ifCondFailsThenPrint);                                                           \
-            tauPrintHexBufCmp(expected, actual, len);                                                           \
-            tauPrintf("\n    Actual : %s\n", #actualPrint);                                                     \
-            failOrAbort;                                                                                        \
-            if(shouldAbortTest) {                                                                               \
-                return;                                                                                         \
-            }                                                                                                   \
-        }                                                                                                       \
-    }                                                                                                           \
+    #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) || defined(__cplusplus) && (__cplusplus >= 201103L)
+        static inline TAU_OVERLOADABLE tauValueStruct tauValue(const long long int i) {
+            return tauValueSigned(i);
+        }
+        static inline TAU_OVERLOADABLE tauValueStruct tauValue(const long long unsigned int i) {
+            return tauValueUnsigned(i);
+        }
+    #endif // __STDC_VERSION__
+
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+    #define tauValue(val)                                       \
+        _Generic((val),                                         \
+                    char : tauValueChar,                        \
+                    char* : tauValueString,                     \
+                    unsigned char : tauValueUnsigned,           \
+                    short : tauValueSigned,                     \
+                    unsigned short : tauValueUnsigned,          \
+                    int : tauValueSigned,                       \
+                    unsigned int : tauValueUnsigned,            \
+                    long : tauValueSigned,                      \
+                    long long : tauValueSigned,                 \
+                    unsigned long : tauValueUnsigned,           \
+                    unsigned long long : tauValueUnsigned,      \
+                    float : tauValueDouble,                     \
+                    double : tauValueDouble,                    \
+                    long double : tauValueLongDouble,           \
+                    void* : tauValuePointer)(val)
+
+#else
+    #define tauValue(val)   tauValueNone()
+#endif // TAU_OVERLOADABLE
+
+static TAU_COLD_ void tauPrintValue(const tauValueStruct value, const char* const asWritten) {
+    switch(value.type) {
+        case TAU_VALUE_SIGNED_:         tauPrintf("%" TAU_PRId64, value.as.i); break;
+        case TAU_VALUE_UNSIGNED_:       tauPrintf("%" TAU_PRIu64, value.as.u); break;
+        case TAU_VALUE_DOUBLE_:         tauPrintf("%f", value.as.d); break;
+        case TAU_VALUE_LONG_DOUBLE_:    tauPrintf("%Lf", value.ld); break;
+        case TAU_VALUE_CHAR_:           tauPrintf("'%c'", value.as.c); break;
+        case TAU_VALUE_STRING_:         tauPrintf("%s", value.as.s); break;
+        case TAU_VALUE_POINTER_:        tauPrintf("%p", value.as.p); break;
+        default:                        tauConsolePrintf("%s", asWritten); break;
+    }
+}
+
+/**
+    Failure context (`TAU_CONTEXT(fmt, ...) { ... }`)
+    Breadcrumbs shown with every assertion that fails inside the block, outermost first. Entering the block only
+    captures the arguments, as values (so strings are captured by pointer, and must outlive the block); they are
+    formatted with `fmt` when, and only if, an assertion fails.
+    In C++ the block is left however it is left, and `break`/`continue` go to the loop around it. C has nothing to
+    run on the way out of a block but a loop of its own: `break` would only leave that, so it fails the test
+    instead; `continue` goes to the end of the block. Don't `return`/`goto` out of the block in C; if a `REQUIRE`
+    that fails does, every block is dropped.
+*/
+#define TAU_MAX_CONTEXTS_           16          // Blocks shown; any nested deeper are left out
+#define TAU_MAX_CONTEXT_ARGS_       8
+
+typedef struct tauContextStruct {
+    const char* fmt;
+    int numArgs;
+    tauValueStruct args[TAU_MAX_CONTEXT_ARGS_];
+    const char* argsAsWritten[TAU_MAX_CONTEXT_ARGS_];  // Shown instead of any argument that can't be captured
+} tauContextStruct;
+
+typedef struct tauContextStackStruct {
+    int depth;                                          // Can exceed TAU_MAX_CONTEXTS_
+    tauContextStruct contexts[TAU_MAX_CONTEXTS_];
+} tauContextStackStruct;
+
+TAU_EXTERN TAU_THREAD_LOCAL tauContextStackStruct tauContextStack;
+
+// `tauContextValue(val)` captures `val`: like `tauValue(val)`, but for everything printf() can print
+#ifdef TAU_OVERLOADABLE
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const char c) { return tauValueChar(c); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const signed char i) { return tauValueSigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const unsigned char i) { return tauValueUnsigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const short i) { return tauValueSigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const unsigned short i) {
+        return tauValueUnsigned(i);
+    }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const int i) { return tauValueSigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const unsigned int i) { return tauValueUnsigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const long int i) { return tauValueSigned(i); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const long unsigned int i) {
+        return tauValueUnsigned(i);
+    }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const float f) { return tauValueDouble(f); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const double d) { return tauValueDouble(d); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const long double d) {
+        return tauValueLongDouble(d);
+    }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const char* const s) { return tauValueString(s); }
+    static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const void* const p) { return tauValuePointer(p); }
+
+    #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) || defined(__cplusplus) && (__cplusplus >= 201103L)
+        static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const long long int i) {
+            return tauValueSigned(i);
+        }
+        static inline TAU_OVERLOADABLE tauValueStruct tauContextValue(const long long unsigned int i) {
+            return tauValueUnsigned(i);
+        }
+    #endif // __STDC_VERSION__
+
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+    #define tauContextValue(val)                                \
+        _Generic((val),                                         \
+                    _Bool : tauValueUnsigned,                   \
+                    char : tauValueChar,                        \
+                    signed char : tauValueSigned,               \
+                    unsigned char : tauValueUnsigned,           \
+                    short : tauValueSigned,                     \
+                    unsigned short : tauValueUnsigned,          \
+                    int : tauValueSigned,                       \
+                    unsigned int : tauValueUnsigned,            \
+                    long : tauValueSigned,                      \
+                    long long : tauValueSigned,                 \
+                    unsigned long : tauValueUnsigned,           \
+                    unsigned long long : tauValueUnsigned,      \
+                    float : tauValueDouble,                     \
+                    double : tauValueDouble,                    \
+                    long double : tauValueLongDouble,           \
+                    char* : tauValueString,                     \
+                    const char* : tauValueString,               \
+                    default : tauValuePointer)(val)
+
+#else
+    #define tauContextValue(val)   tauValueNone()
+#endif // TAU_OVERLOADABLE
+
+static inline void tauContextPush(const char* const fmt) {
+    tauContextStackStruct* const stack = &tauContextStack;
+    if(stack->depth < TAU_MAX_CONTEXTS_) {
+        stack->contexts[stack->depth].fmt = fmt;
+        stack->contexts[stack->depth].numArgs = 0;
+    }
+    stack->depth++;
+}
+
+static inline void tauContextArg(const tauValueStruct value, const char* const asWritten) {
+    tauContextStackStruct* const stack = &tauContextStack;
+    if(stack->depth <= TAU_MAX_CONTEXTS_) {
+        tauContextStruct* const context = &stack->contexts[stack->depth - 1];
+        if(context->numArgs < TAU_MAX_CONTEXT_ARGS_) {
+            context->args[context->numArgs] = value;
+            context->argsAsWritten[context->numArgs] = asWritten;
+            context->numArgs++;
+        }
+    }
+}
+
+// Leave a block, and any that it was left out of early (unless they were all dropped already)
+static inline int tauContextPop(const int depth) {
+    if(depth < tauContextStack.depth)
+        tauContextStack.depth = depth;
+    return -1;
+}
+
+static inline tau_bool tauIsIntegerValue(const tauValueStruct value) {
+    return value.type == TAU_VALUE_SIGNED_ || value.type == TAU_VALUE_UNSIGNED_ || value.type == TAU_VALUE_CHAR_;
+}
+
+static inline tau_i64 tauIntegerValue(const tauValueStruct value) {
+    switch(value.type) {
+        case TAU_VALUE_UNSIGNED_:   return TAU_CAST(tau_i64, value.as.u);
+        case TAU_VALUE_CHAR_:       return value.as.c;
+        default:                    return value.as.i;
+    }
+}
+
+// Print `value` with a printf() directive: `spec` holds its flags, width and precision (`size` bytes, with room
+// for 8 more), and `conversion` says what to print. Values of the wrong type are printed as assertions print them.
+static TAU_COLD_ void tauPrintContextValue(char* const spec, const tau_ull size, const char conversion,
+                                           const tauValueStruct value, const char* const asWritten) {
+    char* const end = spec + size;
+    switch(conversion) {
+        case 'd': case 'i':
+            if(tauIsIntegerValue(value)) {
+                strcpy(end, TAU_PRId64);
+                tauPrintf(spec, tauIntegerValue(value));
+                return;
+            }
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            if(tauIsIntegerValue(value)) {
+                strcpy(end, TAU_PRIu64);
+                end[strlen(end) - 1] = conversion;
+                tauPrintf(spec, TAU_CAST(tau_u64, tauIntegerValue(value)));
+                return;
+            }
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            end[0] = conversion;
+            end[1] = TAU_NULLCHAR;
+            if(value.type == TAU_VALUE_LONG_DOUBLE_) {
+                end[0] = 'L';
+                end[1] = conversion;
+                end[2] = TAU_NULLCHAR;
+                tauPrintf(spec, value.ld);
+                return;
+            } else if(value.type == TAU_VALUE_DOUBLE_) {
+                tauPrintf(spec, value.as.d);
+                return;
+            } else if(tauIsIntegerValue(value)) {
+                tauPrintf(spec, TAU_CAST(double, tauIntegerValue(value)));
+                return;
+            }
+            break;
+        case 'c':
+            if(tauIsIntegerValue(value)) {
+                strcpy(end, "c");
+                tauPrintf(spec, TAU_CAST(int, tauIntegerValue(value)));
+                return;
+            }
+            break;
+        case 's':
+            if(value.type == TAU_VALUE_STRING_) {
+                strcpy(end, "s");
+                tauPrintf(spec, value.as.s ? value.as.s : "(null)");
+                return;
+            }
+            break;
+        case 'p':
+            if(value.type == TAU_VALUE_POINTER_ || value.type == TAU_VALUE_STRING_) {
+                strcpy(end, "p");
+                tauPrintf(spec, value.type == TAU_VALUE_POINTER_ ? value.as.p : TAU_PTRCAST(const void*, value.as.s));
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    tauPrintValue(value, asWritten);
+}
+
+// Print a context as printf() would print its format and arguments. Directives it can't make sense of are printed
+// as they are written.
+static TAU_COLD_ void tauPrintContext(const tauContextStruct* const context) {
+    const char* p = context->fmt;
+    int next = 0;
+
+    while(*p != TAU_NULLCHAR) {
+        const char* const start = p;
+        char spec[64];
+        tau_ull size = 0;
+        tau_bool ok = tau_true;
+
+        if(*p != '%') {
+            while(*p != TAU_NULLCHAR && *p != '%')
+                p++;
+            tauPrintf("%.*s", TAU_CAST(int, p - start), start);
+            continue;
+        }
+        if(p[1] == '%') {
+            tauPrintf("%%");
+            p += 2;
+            continue;
+        }
+
+        // Flags, width and precision are kept; `*` takes its value from the next argument
+        spec[size++] = *p++;
+        while(*p != TAU_NULLCHAR && strchr("-+ #0", *p) != TAU_NULL && size < 16)
+            spec[size++] = *p++;
+        for(int part = 0; part < 2; part++) {
+            if(part == 1) {
+                if(*p != '.')
+                    break;
+                spec[size++] = *p++;
+            }
+            if(*p == '*') {
+                p++;
+                if(next < context->numArgs && tauIsIntegerValue(context->args[next]))
+                    size += TAU_CAST(tau_ull, snprintf(spec + size, 16, "%d",
+                                                       TAU_CAST(int, tauIntegerValue(context->args[next]))));
+                else
+                    ok = tau_false;
+                next++;
+            } else {
+                for(int digits = 0; tauIsDigit(*p); digits++, p++) {
+                    if(digits < 9)
+                        spec[size++] = *p;
+                }
+            }
+        }
+
+        // The length modifier is the captured value's, not the one written
+        while(*p != TAU_NULLCHAR && strchr("hlLqjzt", *p) != TAU_NULL)
+            p++;
+        if(*p == TAU_NULLCHAR || !ok || next >= context->numArgs) {
+            if(*p != TAU_NULLCHAR)
+                p++;
+            tauPrintf("%.*s", TAU_CAST(int, p - start), start);
+            continue;
+        }
+        spec[size] = TAU_NULLCHAR;
+        tauPrintContextValue(spec, size, *p++, context->args[next], context->argsAsWritten[next]);
+        next++;
+    }
+}
+
+// The contexts of a failed assertion, unless it went unreported
+static TAU_COLD_ void tauReportContext() {
+    const tauContextStackStruct* const stack = &tauContextStack;
+
+    if(stack->depth == 0 || !tauFailureBudget.lastReported)
+        return;
+    for(int i = 0; i < stack->depth && i < TAU_MAX_CONTEXTS_; i++) {
+        tauPrintf(i == 0 ? "   Context : " : "             ");
+        tauPrintContext(&stack->contexts[i]);
+        tauPrintf("\n");
+    }
+    if(stack->depth > TAU_MAX_CONTEXTS_)
+        tauPrintf("             ... (%d more)\n", stack->depth - TAU_MAX_CONTEXTS_);
+}
+
+// A `REQUIRE` that fails returns out of the blocks it is in. C++ leaves them on the way; C can't, and there is no
+// telling which of them were in the function that returned, so they are all dropped.
+static void tauContextAbandon() {
+#ifndef __cplusplus
+    tauContextStack.depth = 0;
+#endif // __cplusplus
+}
+
+#define TAU_CONTEXT_FMT_(fmt, ...)                      fmt
+#define TAU_CONTEXT_NTH_(fmt, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, macro, ...)  macro
+#define TAU_CONTEXT_ARG_(a)                             , tauContextArg(tauContextValue(a), #a)
+#define TAU_CONTEXT_0_(fmt)
+#define TAU_CONTEXT_1_(fmt, a)                          TAU_CONTEXT_ARG_(a)
+#define TAU_CONTEXT_2_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_1_(fmt, __VA_ARGS__)
+#define TAU_CONTEXT_3_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_2_(fmt, __VA_ARGS__)
+#define TAU_CONTEXT_4_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_3_(fmt, __VA_ARGS__)
+#define TAU_CONTEXT_5_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_4_(fmt, __VA_ARGS__)
+#define TAU_CONTEXT_6_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_5_(fmt, __VA_ARGS__)
+#define TAU_CONTEXT_7_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_6_(fmt, __VA_ARGS__)
+#define TAU_CONTEXT_8_(fmt, a, ...)                     TAU_CONTEXT_ARG_(a) TAU_CONTEXT_7_(fmt, __VA_ARGS__)
+// Names the mistake in the compiler's error (an undeclared identifier)
+#define TAU_CONTEXT_TOO_MANY_(...)                      , TAU_CONTEXT_takes_at_most_8_arguments_after_the_format
+#define TAU_CONTEXT_ARGS_(...)                                                                                  \
+    TAU_CONTEXT_NTH_(__VA_ARGS__, TAU_CONTEXT_TOO_MANY_, TAU_CONTEXT_TOO_MANY_, TAU_CONTEXT_TOO_MANY_,          \
+                     TAU_CONTEXT_TOO_MANY_, TAU_CONTEXT_TOO_MANY_, TAU_CONTEXT_TOO_MANY_, TAU_CONTEXT_TOO_MANY_,  \
+                     TAU_CONTEXT_TOO_MANY_, TAU_CONTEXT_8_, TAU_CONTEXT_7_, TAU_CONTEXT_6_, TAU_CONTEXT_5_,        \
+                     TAU_CONTEXT_4_, TAU_CONTEXT_3_, TAU_CONTEXT_2_, TAU_CONTEXT_1_, TAU_CONTEXT_0_, )(__VA_ARGS__)
+
+// Enter a block: push it, capture its arguments, and have the compiler check `fmt` against them (through an
+// unevaluated call to tauPrintf()). Evaluates to the depth to pop back to.
+#define TAU_CONTEXT_ENTER_(...)                                                                 \
+    (tauContextPush(TAU_CONTEXT_FMT_(__VA_ARGS__, )) TAU_CONTEXT_ARGS_(__VA_ARGS__),            \
+     TAU_CAST(void, sizeof(tauPrintf(__VA_ARGS__))), tauContextStack.depth - 1)
+
+#ifdef __cplusplus
+// Pops its block on the way out, whichever way that is. It converts to `false` so that the block can be the
+// `else` branch of the `if` that declares it, which keeps it alive and isn't a loop `break` could leave.
+struct tauContextGuardStruct {
+    int depth;
+    ~tauContextGuardStruct() { tauContextPop(depth); }
+    operator bool() const { return false; }
+};
+
+#define TAU_CONTEXT(...)                                                                                    \
+    if(const tauContextGuardStruct& tau_context_ = tauContextGuardStruct{ TAU_CONTEXT_ENTER_(__VA_ARGS__) }) { \
+    } else
+#else
+// The outer loop pops the block. The inner one only runs it once; if it was left with `break`, the outer one
+// still finds it open.
+#define TAU_CONTEXT(...)                                                                                    \
+    for(int tau_context_ = TAU_CONTEXT_ENTER_(__VA_ARGS__), tau_context_open_ = 1; tau_context_ >= 0;        \
+        tau_context_ = tauContextLeave(tau_context_, tau_context_open_, __FILE__, __LINE__))                \
+        for(; tau_context_open_; tau_context_open_ = 0)
+#endif // __cplusplus
+
+// Whether to report a failed assertion at `file`:`line`. Once the current test has used up its budget, the failure
+// is only counted.
+static int tauFailureWithinBudget(const char* const file, const unsigned line) {
+    tauFailureBudgetStruct* const budget = &tauFailureBudget;
+    tauFailureSiteStruct* site;
+
+    budget->lastReported = tauMaxFailuresPerTest == 0 || budget->reported < tauMaxFailuresPerTest;
+    if(budget->lastReported) {
+        budget->reported++;
+        return 1;
+    }
+    for(tau_u64 i = 0; i < budget->numSites; i++) {
+        site = &budget->sites[i];
+        if(site->line == line && (site->file == file || strcmp(site->file, file) == 0)) {
+            site->count++;
+            return 0;
+        }
+    }
+    if(budget->numSites == TAU_MAX_FAILURE_SITES_) {
+        budget->elsewhere++;
+        return 0;
+    }
+    site = &budget->sites[budget->numSites++];
+    site->file = file;
+    site->line = line;
+    site->count = 1;
+    return 0;
+}
+
+// "file:line: FAILED", followed by the assertion as written if its operands aren't just literals. Returns 0,
+// without printing anything, if the failure is over the test's budget.
+static int tauReportFailureStart(const tauAssertStruct* const assertion, const int showCall) {
+    if(!tauFailureWithinBudget(assertion->file, assertion->line))
+        return 0;
+    tauPrintf("%s:%u: ", assertion->file, assertion->line);
+    tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");
+    if(showCall)
+        tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : %s\n", assertion->call);
+    return 1;
+}
+
+static TAU_COLD_ void tauReportCmpFailure(const tauAssertStruct* const assertion, const tauValueStruct actual,
+                                          const tauValueStruct expected) {
+    if(!tauReportFailureStart(assertion, tauShouldDecomposeMacro(assertion->actual, assertion->expected, 0)))
+        return;
+    tauPrintf("  Expected : %s", assertion->actual);
+    tauConsolePrintf(" %s ", assertion->op);
+    tauPrintValue(expected, assertion->expected);
+    tauPrintf("\n");
+
+    tauPrintf("    Actual : %s", assertion->actual);
+    tauConsolePrintf(" == ");
+    tauPrintValue(actual, assertion->actual);
+    tauPrintf("\n");
+}
+
+// The message of CHECKF(), CHECK_EQ_MSG() and friends, formatted only once they fail. The macros only call this
+// when the failure was reported in full, so the arguments of suppressed failures aren't evaluated at all
+static TAU_COLD_ void TAU_ATTRIBUTE_(format (printf, 1, 2))
+tauReportMessage(const char* const fmt, ...) {
+    va_list args;
+
+    tauPrintf("   Message : ");
+    va_start(args, fmt);
+    tauConsoleVPrintf(fmt, args);
+    va_end(args);
+    tauPrintf("\n");
+}
+
+#ifndef TAU_NO_TESTING
+    #define TAU_FAIL_IF_INSIDE_TESTSUITE(file, line)    failIfInsideTestSuite__(file, line)
+    #define TAU_ABORT_IF_INSIDE_TESTSUITE(file, line)   abortIfInsideTestSuite__(file, line)
+#else
+    #define TAU_FAIL_IF_INSIDE_TESTSUITE(file, line)    TAU_ABORT
+    #define TAU_ABORT_IF_INSIDE_TESTSUITE(file, line)   TAU_ABORT
+#endif // TAU_NO_TESTING
+
+#ifndef __cplusplus
+// Leave the `TAU_CONTEXT()` block at `file`:`line`, which fails the test if it is still `open` (i.e. it was left
+// with a `break`, which meant to leave a loop around the block)
+static int tauContextLeave(const int depth, const int open, const char* const file, const unsigned line) {
+    if(open) {
+        if(tauFailureWithinBudget(file, line)) {
+            tauPrintf("%s:%u: ", file, line);
+            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");
+            tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In block : TAU_CONTEXT\n");
+            tauPrintf("    Reason : `break` only leaves the block in C, not the loop around it\n");
+        }
+        TAU_FAIL_IF_INSIDE_TESTSUITE(file, line);
+    }
+    return tauContextPop(depth);
+}
+#endif // __cplusplus
+
+#define __TAUCMP__(actual, expected, cond, space, macroName, failOrAbort)                          \
+    do {                                                                                           \
+        tauAssertionCount++;                                                                       \
+        if(TAU_UNLIKELY(!((actual)cond(expected)))) {                                              \
+            TAU_ASSERT_(#macroName "( " #actual ", " #expected " )", #actual, #expected,           \
+                        #cond space, TAU_NULL);                                                    \
+            tauReportCmpFailure(&tau_assert_, tauValue(actual), tauValue(expected));               \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                       \
+            if(shouldAbortTest) {                                                                  \
+                return;                                                                            \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
     while(0)
 
-#define __TAUCMP_STRN__(actual, expected, n, cond, ifCondFailsThenPrint, actualPrint, macroName, failOrAbort)   \
+// Like __TAUCMP__, followed by a message (printf() arguments) that's only evaluated if the comparison fails
+#define __TAUCMP_MSG__(actual, expected, cond, space, macroName, failOrAbort, ...)                 \
+    do {                                                                                           \
+        tauAssertionCount++;                                                                       \
+        if(TAU_UNLIKELY(!((actual)cond(expected)))) {                                              \
+            TAU_ASSERT_(#macroName "( " #actual ", " #expected " )", #actual, #expected,           \
+                        #cond space, TAU_NULL);                                                    \
+            tauReportCmpFailure(&tau_assert_, tauValue(actual), tauValue(expected));               \
+            if(tauFailureBudget.lastReported)                                                      \
+                tauReportMessage(__VA_ARGS__);                                                     \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                       \
+            if(shouldAbortTest) {                                                                  \
+                return;                                                                            \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+    while(0)
+
+// ifCondFailsThenPrint is the string representation of the opposite of the truthy value of `cond`
+// For example, if `cond` is "!=", then `ifCondFailsThenPrint` will be `==`
+#define __TAUCMP_STR__(actual, expected, cond, ifCondFailsThenPrint, actualPrint, macroName, failOrAbort)       \
     do {                                                                                                        \
-        if(TAU_CAST(int, n) < 0) {                                                                              \
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "`n` cannot be negative\n");                               \
-            TAU_ABORT;                                                                                          \
-        }                                                                                                       \
-        if(strncmp(actual, expected, n) cond 0) {                                                               \
-            tauPrintf("%s:%u: ", __FILE__, __LINE__);                                                           \
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");                                               \
-            if(tauShouldDecomposeMacro(#actual, #expected, 1)) {                                                \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : ");                                 \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "%s( %s, %s, %s)\n",                              \
-                                                                #macroName,                                     \
-                                                                #actual, #expected, #n);                        \
-                }                                                                                               \
-            tauPrintf("  Expected : \"%.*s\" %s \"%.*s\"\n", TAU_CAST(int, n), actual,                          \
-                                                              #ifCondFailsThenPrint,                            \
-                                                              TAU_CAST(int, n), expected);                      \
-            tauPrintf("    Actual : %s\n", #actualPrint);                                                       \
-            failOrAbort;                                                                                        \
+        tauAssertionCount++;                                                                                    \
+        if(TAU_UNLIKELY(strcmp(actual, expected) cond 0)) {                                                     \
+            TAU_ASSERT_(#macroName "( " #actual ", " #expected " )", #actual, #expected,                        \
+                        #ifCondFailsThenPrint, #actualPrint);                                                   \
+            tauReportStrFailure(&tau_assert_, actual, expected);                                                \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                                    \
             if(shouldAbortTest) {                                                                               \
                 return;                                                                                         \
             }                                                                                                   \
@@ -711,461 +2702,4363 @@ static void tauPrintHexBufCmp(const void* const buff, const void* const ref, con
     while(0)
 
 
-#define __TAUCMP_TF(cond, actual, expected, negateSign, macroName, failOrAbort)     \
-    do {                                                                            \
-        if(negateSign(cond)) {                                                      \
-            tauPrintf("%s:%u: ", __FILE__, __LINE__);                               \
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");                   \
-            if(tauShouldDecomposeMacro(#actual, TAU_NULL, 0)) {                     \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In macro : ");     \
-                    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "%s( %s )\n",         \
-                                                                #macroName,         \
-                                                                #cond);             \
-                }                                                                   \
-            tauPrintf("  Expected : %s\n", #expected);                              \
-            tauPrintf("    Actual : %s\n", #actual);                                \
-            failOrAbort;                                                            \
-            if(shouldAbortTest) {                                                   \
-                return;                                                             \
-            }                                                                       \
-        }                                                                           \
-    } while(0)
+static void tauPrintColouredIfDifferent(const tau_u8 ch, const tau_u8 ref) {
+    if(ch == ref) {
+        tauPrintf("%02X", ch);
+    } else {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "%02X", ch);
+    }
+}
+
+
+static void tauPrintHexBufCmp(const void* const buff, const void* const ref, const int size) {
+    const tau_u8* const test_buff = TAU_CAST(const tau_u8* const, buff);
+    const tau_u8* const ref_buff = TAU_CAST(const tau_u8* const, ref);
+
+    tauColouredPrintf(TAU_COLOUR_CYAN_,"<");
+    if(size != 0)
+        tauPrintColouredIfDifferent(test_buff[0], ref_buff[0]);
+
+    for(int i = 1; i < size; ++i) {
+        tauConsolePrintf(" ");
+        tauPrintColouredIfDifferent(test_buff[i], ref_buff[i]);
+    }
+    tauColouredPrintf(TAU_COLOUR_CYAN_,">");
+}
+
 
 /**
-############################################
-          {CHECK|REQUIRE} Macros
-############################################
+    Buffer diffs (CHECK_BUF_EQ and friends)
+    Buffers of up to `2 * TAU_BUF_DIFF_CONTEXT` bytes are printed in full. Larger ones are only shown around each
+    run of differing bytes, with `TAU_BUF_DIFF_CONTEXT` bytes of context on either side, for at most
+    `TAU_BUF_DIFF_MAX_RUNS` runs. The runs are found with vector compares where available, so that reporting a
+    mismatch costs about as much as the `memcmp()` that found it, however large the buffers are.
 */
-#define CHECK_EQ(actual, expected)      __TAUCMP__(actual, expected, ==, "", CHECK_EQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_NE(actual, expected)      __TAUCMP__(actual, expected, !=, "", CHECK_NE, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_LT(actual, expected)      __TAUCMP__(actual, expected, < , " ", CHECK_LT, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_LE(actual, expected)      __TAUCMP__(actual, expected, <=, "", CHECK_LE, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_GT(actual, expected)      __TAUCMP__(actual, expected, > , " ", CHECK_GT, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_GE(actual, expected)      __TAUCMP__(actual, expected, >=, "", CHECK_GE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#ifndef TAU_BUF_DIFF_CONTEXT
+    #define TAU_BUF_DIFF_CONTEXT    16
+#endif // TAU_BUF_DIFF_CONTEXT
+#ifndef TAU_BUF_DIFF_MAX_RUNS
+    #define TAU_BUF_DIFF_MAX_RUNS   8
+#endif // TAU_BUF_DIFF_MAX_RUNS
+#define TAU_BUF_ROW_SIZE_           16
+
+// Index of the lowest bit set in `x` (which mustn't be 0)
+static inline int tauLowestBit(tau_u32 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    for(; (x & 1) == 0; x >>= 1)
+        n++;
+    return n;
+#endif // __GNUC__
+}
 
-#define REQUIRE_EQ(actual, expected)    __TAUCMP__(actual, expected, ==, "", REQUIRE_EQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_NE(actual, expected)    __TAUCMP__(actual, expected, !=, "", REQUIRE_NE, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_LT(actual, expected)    __TAUCMP__(actual, expected, < , " ", REQUIRE_LT, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_LE(actual, expected)    __TAUCMP__(actual, expected, <=, "", REQUIRE_LE, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_GT(actual, expected)    __TAUCMP__(actual, expected, > , " ", REQUIRE_GT, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_GE(actual, expected)    __TAUCMP__(actual, expected, >=, "", REQUIRE_GE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+// Index of the highest bit set in `x` (which mustn't be 0)
+static inline int tauHighestBit(tau_u32 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - __builtin_clz(x);
+#else
+    int n = 0;
+    while(x >>= 1)
+        n++;
+    return n;
+#endif // __GNUC__
+}
 
-// Whole-string checks
-#define CHECK_STREQ(actual, expected)   __TAUCMP_STR__(actual, expected, !=, ==, not equal, CHECK_STREQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_STRNE(actual, expected)   __TAUCMP_STR__(actual, expected, ==, !=, equal, CHECK_STRNE, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define REQUIRE_STREQ(actual, expected) __TAUCMP_STR__(actual, expected, !=, ==, not equal, REQUIRE_STREQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_STRNE(actual, expected) __TAUCMP_STR__(actual, expected, ==, !=, equal, REQUIRE_STRNE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+static inline int tauPopCount(tau_u32 x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return TAU_CAST(int, (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif // __GNUC__
+}
 
-// Substring Checks
-#define CHECK_SUBSTREQ(actual, expected, n)     __TAUCMP_STRN__(actual, expected, n, !=, ==, unequal substrings, CHECK_SUBSTREQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_SUBSTRNE(actual, expected, n)     __TAUCMP_STRN__(actual, expected, n, ==, !=, equal substrings, CHECK_SUBSTRNE, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define REQUIRE_SUBSTREQ(actual, expected, n)   __TAUCMP_STRN__(actual, expected, n, !=, ==, unequal substrings, REQUIRE_SUBSTREQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_SUBSTRNE(actual, expected, n)   __TAUCMP_STRN__(actual, expected, n, ==, !=, equal substrings, REQUIRE_SUBSTRNE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+// Offset of the first byte at or after `from` that differs between `a` and `b` (or, if `differs` is 0, that is
+// the same in both); `size` if there is none
+static tau_ull tauBufScan(const tau_u8* const a, const tau_u8* const b, tau_ull from, const tau_ull size,
+                          const int differs) {
+#if defined(TAU_HAS_AVX2_)
+    for(; from + 32 <= size; from += 32) {
+        const __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(TAU_PTRCAST(const __m256i*, a + from)),
+                                             _mm256_loadu_si256(TAU_PTRCAST(const __m256i*, b + from)));
+        tau_u32 mask = TAU_CAST(tau_u32, _mm256_movemask_epi8(eq));
+        if(differs)
+            mask = ~mask;
+        if(mask != 0)
+            return from + TAU_CAST(tau_ull, tauLowestBit(mask));
+    }
+#elif defined(TAU_HAS_SSE2_)
+    for(; from + 16 <= size; from += 16) {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(TAU_PTRCAST(const __m128i*, a + from)),
+                                          _mm_loadu_si128(TAU_PTRCAST(const __m128i*, b + from)));
+        tau_u32 mask = TAU_CAST(tau_u32, _mm_movemask_epi8(eq));
+        if(differs)
+            mask = ~mask & 0xFFFF;
+        if(mask != 0)
+            return from + TAU_CAST(tau_ull, tauLowestBit(mask));
+    }
+#elif defined(TAU_HAS_NEON_)
+    // No movemask on NEON: find the block, then the byte within it
+    for(; from + 16 <= size; from += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(a + from), vld1q_u8(b + from));
+        if(differs)
+            eq = vmvnq_u8(eq);
+        if(vmaxvq_u8(eq) != 0)
+            break;
+    }
+#endif // TAU_HAS_AVX2_
+    for(; from < size; from++) {
+        if((a[from] != b[from]) == (differs != 0))
+            return from;
+    }
+    return size;
+}
 
-// Buffer Checks
-#define CHECK_BUF_EQ(actual, expected, n)       __TAUCMP_BUF__(actual, expected, n, !=, ==, not equal, CHECK_BUF_EQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_BUF_NE(actual, expected, n)       __TAUCMP_BUF__(actual, expected, n, ==, !=, equal, CHECK_BUF_NE, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define REQUIRE_BUF_EQ(actual, expected, n)     __TAUCMP_BUF__(actual, expected, n, !=, ==, not equal, REQUIRE_BUF_EQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_BUF_NE(actual, expected, n)     __TAUCMP_BUF__(actual, expected, n, ==, !=, equal, REQUIRE_BUF_NE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+// Number of bytes that differ between `a` and `b`; `*last` is set to the offset of the last of them
+static tau_ull tauBufCountMismatches(const tau_u8* const a, const tau_u8* const b, const tau_ull size,
+                                     tau_ull* const last) {
+    tau_ull count = 0;
+    tau_ull i = 0;
+
+#if defined(TAU_HAS_AVX2_)
+    for(; i + 32 <= size; i += 32) {
+        const __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(TAU_PTRCAST(const __m256i*, a + i)),
+                                             _mm256_loadu_si256(TAU_PTRCAST(const __m256i*, b + i)));
+        const tau_u32 mask = ~TAU_CAST(tau_u32, _mm256_movemask_epi8(eq));
+        if(mask != 0) {
+            count += TAU_CAST(tau_ull, tauPopCount(mask));
+            *last = i + TAU_CAST(tau_ull, tauHighestBit(mask));
+        }
+    }
+#elif defined(TAU_HAS_SSE2_)
+    for(; i + 16 <= size; i += 16) {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(TAU_PTRCAST(const __m128i*, a + i)),
+                                          _mm_loadu_si128(TAU_PTRCAST(const __m128i*, b + i)));
+        const tau_u32 mask = ~TAU_CAST(tau_u32, _mm_movemask_epi8(eq)) & 0xFFFF;
+        if(mask != 0) {
+            count += TAU_CAST(tau_ull, tauPopCount(mask));
+            *last = i + TAU_CAST(tau_ull, tauHighestBit(mask));
+        }
+    }
+#elif defined(TAU_HAS_NEON_)
+    for(; i + 16 <= size; i += 16) {
+        // 1 for every byte that differs
+        const uint8x16_t ne = vandq_u8(vmvnq_u8(vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i))), vdupq_n_u8(1));
+        const tau_u32 n = vaddvq_u8(ne);
+        if(n != 0) {
+            count += n;
+            for(int j = 15; j >= 0; j--) {
+                if(a[i + j] != b[i + j]) {
+                    *last = i + TAU_CAST(tau_ull, j);
+                    break;
+                }
+            }
+        }
+    }
+#endif // TAU_HAS_AVX2_
+    for(; i < size; i++) {
+        if(a[i] != b[i]) {
+            count++;
+            *last = i;
+        }
+    }
+    return count;
+}
 
-// Note: The negate sign `!` must be there for {CHECK|REQUIRE}_TRUE
-// Do not remove it
-#define CHECK_TRUE(cond)      __TAUCMP_TF(cond, false, true, !, CHECK_TRUE, TAU_FAIL_IF_INSIDE_TESTSUITE)
-#define CHECK_FALSE(cond)     __TAUCMP_TF(cond, true, false, , CHECK_FALSE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+// `buf[from, to)` as one row of a dump starting at `row`: in hex, then as ASCII, highlighting the bytes that
+// differ from `ref`
+static void tauPrintBufRow(const tau_u8* const buf, const tau_u8* const ref, const tau_ull row, const tau_ull from,
+                           const tau_ull to) {
+    for(tau_ull i = row; i < row + TAU_BUF_ROW_SIZE_; i++) {
+        if(i < from || i >= to) {
+            tauPrintf("   ");
+        } else {
+            tauPrintf(" ");
+            tauPrintColouredIfDifferent(buf[i], ref[i]);
+        }
+    }
+    tauPrintf("  |");
+    for(tau_ull i = row; i < row + TAU_BUF_ROW_SIZE_; i++) {
+        const char c = i < from || i >= to ? ' ' : buf[i] >= 0x20 && buf[i] < 0x7F ? TAU_CAST(char, buf[i]) : '.';
+        if(i >= from && i < to && buf[i] != ref[i])
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "%c", c);
+        else
+            tauPrintf("%c", c);
+    }
+    tauPrintf("|\n");
+}
 
-#define REQUIRE_TRUE(cond)    __TAUCMP_TF(cond, false, true, !, REQUIRE_TRUE, TAU_ABORT_IF_INSIDE_TESTSUITE)
-#define REQUIRE_FALSE(cond)   __TAUCMP_TF(cond, true, false, , REQUIRE_FALSE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+static void tauPrintBufRows(const tau_u8* const actual, const tau_u8* const expected, const tau_ull from,
+                            const tau_ull to) {
+    for(tau_ull row = from - from % TAU_BUF_ROW_SIZE_; row < to; row += TAU_BUF_ROW_SIZE_) {
+        tauPrintf("    %08" TAU_PRIx64 "  actual  ", TAU_CAST(tau_u64, row));
+        tauPrintBufRow(actual, expected, row, from, to);
+        tauPrintf("              expected");
+        tauPrintBufRow(expected, actual, row, from, to);
+    }
+}
 
-#define __TAUCHECKREQUIRE__(cond, failOrAbort, macroName, ...)                                 \
-    do {                                                                                       \
-        if(!(cond)) {                                                                          \
-            tauPrintf("%s:%u: ", __FILE__, __LINE__);                                          \
-            if((sizeof(char[]){__VA_ARGS__}) <= 1)                                             \
-                tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED");                            \
-            else                                                                               \
-                tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, __VA_ARGS__);                         \
-            printf("\n");                                                                      \
-            printf("The following assertion failed: \n");                                      \
-            tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "    %s( %s )\n", #macroName, #cond);    \
-            failOrAbort;                                                                       \
-            if(shouldAbortTest) {                                                              \
-                return;                                                                        \
-            }                                                                                  \
-        }                                                                                      \
-    }                                                                                          \
-    while(0)
+// The runs of differing bytes, with some context around each
+static void tauPrintBufDiff(const tau_u8* const actual, const tau_u8* const expected, const tau_ull size,
+                            const tau_ull last) {
+    tau_ull pos = tauBufScan(actual, expected, 0, size, 1);
 
-// This is a little hack that allows a form of "polymorphism" to a macro - it allows a user to optionally pass
-// an extra argument to a macro in {CHECK|REQUIRE}.
-// The first argument is always the condition to check/assert. If this condition fails, by default a `FAILED`
-// message is sent to STDOUT. If a second argument is passed to the macro (a string), this will be outputted
-// instead.
-//
-// The MACRO_CHOOSER uses the list of arguments twice, first to form the name of the helper macro, and then to
-// pass the arguments to that helper macro. It uses a standard trick to count the number of arguments to a macro.
-//
-// Neat hack from:
-// https://stackoverflow.com/questions/3046889/optional-parameters-with-c-macros, and
-// https://stackoverflow.com/questions/11761703/overloading-macro-on-number-of-arguments
-#define GET_3RD_ARG(arg1, arg2, arg3, ...)   arg3
+    for(int runs = 0; pos < size; runs++) {
+        tau_ull end, next;
 
-#define CHECK_1_ARGS(cond)              __TAUCHECKREQUIRE__(cond, TAU_FAIL_IF_INSIDE_TESTSUITE, CHECK, "FAILED")
-#define CHECK_2_ARGS(cond, message)     __TAUCHECKREQUIRE__(cond, TAU_FAIL_IF_INSIDE_TESTSUITE, CHECK, message)
-#define CHECK_MACRO_CHOOSER(...)        GET_3RD_ARG(__VA_ARGS__, CHECK_2_ARGS, CHECK_1_ARGS, )
+        if(runs == TAU_BUF_DIFF_MAX_RUNS) {
+            tauPrintf("    ... (more differences, up to offset %" TAU_PRIu64 ")\n", TAU_CAST(tau_u64, last));
+            break;
+        }
+        if(runs > 0)
+            tauPrintf("    ...\n");
+
+        // Take in the runs that follow closely enough for their context to overlap with this one's
+        end = tauBufScan(actual, expected, pos, size, 0);
+        next = tauBufScan(actual, expected, end, size, 1);
+        while(next < size && next - end <= 2 * TAU_BUF_DIFF_CONTEXT) {
+            end = tauBufScan(actual, expected, next, size, 0);
+            next = tauBufScan(actual, expected, end, size, 1);
+        }
 
-#define REQUIRE_1_ARGS(cond)            __TAUCHECKREQUIRE__(cond, TAU_ABORT_IF_INSIDE_TESTSUITE, REQUIRE, "FAILED")
-#define REQUIRE_2_ARGS(cond, message)   __TAUCHECKREQUIRE__(cond, TAU_ABORT_IF_INSIDE_TESTSUITE, REQUIRE, message)
+        const tau_ull from = pos > TAU_BUF_DIFF_CONTEXT ? pos - TAU_BUF_DIFF_CONTEXT : 0;
+        const tau_ull to = end + TAU_BUF_DIFF_CONTEXT < size ? end + TAU_BUF_DIFF_CONTEXT : size;
+        if(end - pos > 2 * TAU_BUF_DIFF_CONTEXT) {
+            // A long run: only show how it starts and ends
+            tauPrintBufRows(actual, expected, from, pos + TAU_BUF_DIFF_CONTEXT);
+            tauPrintf("    ... (%" TAU_PRIu64 " bytes)\n", TAU_CAST(tau_u64, end - pos - 2 * TAU_BUF_DIFF_CONTEXT));
+            tauPrintBufRows(actual, expected, end - TAU_BUF_DIFF_CONTEXT, to);
+        } else {
+            tauPrintBufRows(actual, expected, from, to);
+        }
+        pos = next;
+    }
+}
+
+static TAU_COLD_ void tauReportBufFailure(const tauAssertStruct* const assertion, const void* const actual,
+                                          const void* const expected, const tau_ull size) {
+    const tau_u8* const a = TAU_PTRCAST(const tau_u8*, actual);
+    const tau_u8* const b = TAU_PTRCAST(const tau_u8*, expected);
+
+    if(!tauReportFailureStart(assertion, tauShouldDecomposeMacro(assertion->actual, assertion->expected, 1)))
+        return;
+    if(size <= 2 * TAU_BUF_DIFF_CONTEXT) {
+        tauPrintf("  Expected : "); tauPrintHexBufCmp(actual, expected, TAU_CAST(int, size));
+        tauPrintf(" %s ", assertion->op);
+        tauPrintHexBufCmp(expected, actual, TAU_CAST(int, size));
+        tauPrintf("\n    Actual : %s\n", assertion->outcome);
+        return;
+    }
+
+    tau_ull last = 0;
+    const tau_ull numDiffering = tauBufCountMismatches(a, b, size, &last);
+    tauPrintf("  Expected : %s %s %s (%" TAU_PRIu64 " bytes)\n", assertion->actual, assertion->op,
+              assertion->expected, TAU_CAST(tau_u64, size));
+    if(numDiffering == 0) {
+        tauPrintf("    Actual : %s\n", assertion->outcome);
+        return;
+    }
+    if(numDiffering == 1) {
+        tauPrintf("    Actual : %s (1 byte differs, at offset %" TAU_PRIu64 ")\n", assertion->outcome,
+                  TAU_CAST(tau_u64, last));
+    } else {
+        tauPrintf("    Actual : %s (%" TAU_PRIu64 " bytes differ, from offset %" TAU_PRIu64 " to %" TAU_PRIu64 ")\n",
+                  assertion->outcome, TAU_CAST(tau_u64, numDiffering), TAU_CAST(tau_u64, tauBufScan(a, b, 0, size, 1)),
+                  TAU_CAST(tau_u64, last));
+    }
+    tauPrintBufDiff(a, b, size, last);
+}
+
+/**
+    String diffs (CHECK_STREQ and friends)
+    Strings that fit on a line are printed in full. Longer ones are compared with Myers' O(ND) diff, in its
+    linear-space form (bisecting on the "middle snake"): line by line if either spans several lines, character by
+    character otherwise. The result is printed as unified diff hunks with `TAU_STR_DIFF_CONTEXT` lines of context,
+    for at most `TAU_STR_DIFF_MAX_LINES` lines of at most `TAU_STR_DIFF_WIDTH` characters, however large the
+    strings are.
+
+    The lines the strings start and end with are skipped before anything is allocated, so the memory used only
+    depends on the part that differs. If more than `TAU_STR_DIFF_MAX_TOKENS` lines (or characters) are left, or if
+    the diff takes more than `TAU_STR_DIFF_MAX_COST` steps, only the first difference is shown instead.
+*/
+#ifndef TAU_STR_DIFF_CONTEXT
+    #define TAU_STR_DIFF_CONTEXT        3
+#endif // TAU_STR_DIFF_CONTEXT
+#ifndef TAU_STR_DIFF_MAX_LINES
+    #define TAU_STR_DIFF_MAX_LINES      40
+#endif // TAU_STR_DIFF_MAX_LINES
+#ifndef TAU_STR_DIFF_WIDTH
+    #define TAU_STR_DIFF_WIDTH          100
+#endif // TAU_STR_DIFF_WIDTH
+#ifndef TAU_STR_DIFF_MAX_TOKENS
+    #define TAU_STR_DIFF_MAX_TOKENS     100000
+#endif // TAU_STR_DIFF_MAX_TOKENS
+#ifndef TAU_STR_DIFF_MAX_COST
+    #define TAU_STR_DIFF_MAX_COST       10000000
+#endif // TAU_STR_DIFF_MAX_COST
+#define TAU_STR_DIFF_CHAR_CONTEXT_      16          // Characters of context, when diffing character by character
+
+// A line (including its '\n', if it has one) or a single character of one of the strings
+typedef struct tauDiffTokenStruct {
+    const char* data;
+    tau_ull size;
+    tau_u32 hash;
+} tauDiffTokenStruct;
+
+typedef struct tauDiffStruct {
+    const tauDiffTokenStruct* a;    // Expected
+    const tauDiffTokenStruct* b;    // Actual
+    char* deleted;                  // Which tokens of `a` aren't in `b`...
+    char* inserted;                 // ...and which tokens of `b` aren't in `a`
+    tau_ll* forward;                // Furthest x reached on each diagonal (k = x - y), searching forward...
+    tau_ll* backward;               // ...and backward. Both are indexed by k, which can be negative.
+    tau_u64 cost;                   // Steps taken so far
+} tauDiffStruct;
+
+// Split `str[0, size)` into lines, or into characters if `byChar`. Returns the number of tokens; `tokens` may be
+// NULL to only count them.
+static tau_ull tauDiffTokenize(const char* const str, const tau_ull size, const int byChar,
+                               tauDiffTokenStruct* const tokens) {
+    tau_ull count = 0;
+    tau_ull start = 0;
+
+    for(tau_ull i = 0; i < size; i++) {
+        if(!byChar && str[i] != '\n' && i + 1 < size)
+            continue;
+        if(tokens != TAU_NULL) {
+            tauDiffTokenStruct* const token = &tokens[count];
+            token->data = str + start;
+            token->size = i + 1 - start;
+            token->hash = 2166136261u;  // FNV-1a
+            for(tau_ull j = 0; j < token->size; j++)
+                token->hash = (token->hash ^ TAU_CAST(tau_u8, token->data[j])) * 16777619u;
+        }
+        count++;
+        start = i + 1;
+    }
+    return count;
+}
+
+static inline int tauDiffTokensEqual(const tauDiffStruct* const d, const tau_ll x, const tau_ll y) {
+    const tauDiffTokenStruct* const a = &d->a[x];
+    const tauDiffTokenStruct* const b = &d->b[y];
+    return a->hash == b->hash && a->size == b->size && memcmp(a->data, b->data, a->size) == 0;
+}
+
+// Find a point (*midX, *midY) on a shortest edit path through a[xLo, xHi) and b[yLo, yHi), by searching from both
+// ends at once until the two searches meet. Neither sequence may be empty, and they must differ in their first
+// and last tokens. Returns 0 if that took the diff over its budget.
+static int tauDiffMiddleSnake(tauDiffStruct* const d, const tau_ll xLo, const tau_ll xHi, const tau_ll yLo,
+                              const tau_ll yHi, tau_ll* const midX, tau_ll* const midY) {
+    tau_ll* const fd = d->forward;
+    tau_ll* const bd = d->backward;
+    const tau_ll kLo = xLo - yHi;
+    const tau_ll kHi = xHi - yLo;
+    const tau_ll fMid = xLo - yLo;
+    const tau_ll bMid = xHi - yHi;
+    const int odd = TAU_CAST(int, (fMid - bMid) & 1);
+    const tau_ll farAway = xHi + 1;
+    tau_ll fMin = fMid, fMax = fMid;
+    tau_ll bMin = bMid, bMax = bMid;
+
+    fd[fMid] = xLo;
+    bd[bMid] = xHi;
+    for(;;) {
+        tau_ll k, x, y;
+
+        // One more edit, from the top left...
+        if(fMin > kLo) fd[--fMin - 1] = -1; else ++fMin;
+        if(fMax < kHi) fd[++fMax + 1] = -1; else --fMax;
+        for(k = fMax; k >= fMin; k -= 2) {
+            x = fd[k - 1] >= fd[k + 1] ? fd[k - 1] + 1 : fd[k + 1];
+            y = x - k;
+            while(x < xHi && y < yHi && tauDiffTokensEqual(d, x, y)) {
+                x++;
+                y++;
+                d->cost++;
+            }
+            fd[k] = x;
+            if(odd && bMin <= k && k <= bMax && bd[k] <= x) {
+                *midX = x;
+                *midY = y;
+                return 1;
+            }
+        }
+
+        // ...and from the bottom right
+        if(bMin > kLo) bd[--bMin - 1] = farAway; else ++bMin;
+        if(bMax < kHi) bd[++bMax + 1] = farAway; else --bMax;
+        for(k = bMax; k >= bMin; k -= 2) {
+            x = bd[k - 1] < bd[k + 1] ? bd[k - 1] : bd[k + 1] - 1;
+            y = x - k;
+            while(x > xLo && y > yLo && tauDiffTokensEqual(d, x - 1, y - 1)) {
+                x--;
+                y--;
+                d->cost++;
+            }
+            bd[k] = x;
+            if(!odd && fMin <= k && k <= fMax && x <= fd[k]) {
+                *midX = x;
+                *midY = y;
+                return 1;
+            }
+        }
+
+        d->cost += TAU_CAST(tau_u64, (fMax - fMin) + (bMax - bMin) + 2);
+        if(d->cost > TAU_STR_DIFF_MAX_COST)
+            return 0;
+    }
+}
+
+// Mark what has to be deleted from a[xLo, xHi) and inserted from b[yLo, yHi) to turn one into the other. Returns 0
+// if the diff went over its budget.
+static int tauDiffCompare(tauDiffStruct* const d, tau_ll xLo, tau_ll xHi, tau_ll yLo, tau_ll yHi) {
+    tau_ll x, y;
+
+    while(xLo < xHi && yLo < yHi && tauDiffTokensEqual(d, xLo, yLo)) {
+        xLo++;
+        yLo++;
+    }
+    while(xLo < xHi && yLo < yHi && tauDiffTokensEqual(d, xHi - 1, yHi - 1)) {
+        xHi--;
+        yHi--;
+    }
+
+    if(xLo == xHi) {
+        while(yLo < yHi)
+            d->inserted[yLo++] = 1;
+        return 1;
+    }
+    if(yLo == yHi) {
+        while(xLo < xHi)
+            d->deleted[xLo++] = 1;
+        return 1;
+    }
+    if(!tauDiffMiddleSnake(d, xLo, xHi, yLo, yHi, &x, &y))
+        return 0;
+    return tauDiffCompare(d, xLo, x, yLo, y) && tauDiffCompare(d, x, xHi, y, yHi);
+}
+
+// One line of a hunk, from column `from` on, clipped to TAU_STR_DIFF_WIDTH characters
+static void tauPrintDiffLine(const char sign, const char* const data, tau_ull size, tau_ull from) {
+    if(size > 0 && data[size - 1] == '\n')
+        size--;
+    if(from > size)
+        from = size;
+
+    const tau_ull width = size - from < TAU_STR_DIFF_WIDTH ? size - from : TAU_STR_DIFF_WIDTH;
+    const int colour = sign == '-' ? TAU_COLOUR_BRIGHTRED_ : sign == '+' ? TAU_COLOUR_BRIGHTGREEN_ :
+                                                                           TAU_COLOUR_DEFAULT_;
+    tauColouredPrintf(colour, "    %c%s%.*s%s\n", sign, from > 0 ? "..." : "", TAU_CAST(int, width), data + from,
+                      from + width < size ? "..." : "");
+}
+
+// One side of a hunk of a character diff, with the characters only it has highlighted
+static void tauPrintDiffChars(const char sign, const tauDiffTokenStruct* const chars, const char* const changed,
+                              const tau_ull from, const tau_ull to) {
+    const tau_ull end = to - from > TAU_STR_DIFF_WIDTH ? from + TAU_STR_DIFF_WIDTH : to;
+    const int colour = sign == '-' ? TAU_COLOUR_BRIGHTRED_ : TAU_COLOUR_BRIGHTGREEN_;
+
+    tauPrintf("    %c", sign);
+    for(tau_ull i = from, j; i < end; i = j) {
+        for(j = i; j < end && changed[j] == changed[i]; j++) {}
+        if(changed[i])
+            tauColouredPrintf(colour, "%.*s", TAU_CAST(int, j - i), chars[i].data);
+        else
+            tauPrintf("%.*s", TAU_CAST(int, j - i), chars[i].data);
+    }
+    tauPrintf("%s\n", end < to ? "..." : "");
+}
+
+// The diff as unified diff hunks. `base` is the number of the first line (or character) of `d->a` and `d->b`.
+static void tauPrintDiffHunks(const tauDiffStruct* const d, const tau_ull n, const tau_ull m, const int byChar,
+                              const tau_ull base) {
+    const tau_ull context = byChar ? TAU_STR_DIFF_CHAR_CONTEXT_ : TAU_STR_DIFF_CONTEXT;
+    tau_ull x = 0, y = 0;
+    tau_u64 numSkipped = 0;
+    int numLines = 0;
+
+    while(x < n || y < m) {
+        if(x < n && y < m && !d->deleted[x] && !d->inserted[y]) {
+            x++;
+            y++;
+            continue;
+        }
+
+        // A hunk: this change, and the ones that follow closely enough for their context to overlap with it
+        const tau_ull before = x < context ? x : context;
+        const tau_ull xFrom = x - before, yFrom = y - before;
+        tau_ull xTo = x, yTo = y, run;
+        for(;;) {
+            while(xTo < n && d->deleted[xTo]) xTo++;
+            while(yTo < m && d->inserted[yTo]) yTo++;
+            for(run = 0; run <= 2 * context && xTo + run < n && yTo + run < m &&
+                         !d->deleted[xTo + run] && !d->inserted[yTo + run]; run++) {}
+            if(run > 2 * context || (xTo + run == n && yTo + run == m))
+                break;
+            xTo += run;
+            yTo += run;
+        }
+        run = run < context ? run : context;
+        xTo += run;
+        yTo += run;
+        x = xTo;
+        y = yTo;
+
+        if(numLines >= TAU_STR_DIFF_MAX_LINES) {
+            numSkipped++;
+            continue;
+        }
+        tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "    @@ -%" TAU_PRIu64 ",%" TAU_PRIu64 " +%" TAU_PRIu64 ",%"
+                          TAU_PRIu64 " @@\n", TAU_CAST(tau_u64, base + xFrom), TAU_CAST(tau_u64, xTo - xFrom),
+                          TAU_CAST(tau_u64, base + yFrom), TAU_CAST(tau_u64, yTo - yFrom));
+        numLines++;
+
+        if(byChar) {
+            tauPrintDiffChars('-', d->a, d->deleted, xFrom, xTo);
+            tauPrintDiffChars('+', d->b, d->inserted, yFrom, yTo);
+            numLines += 2;
+            continue;
+        }
+
+        // Long lines are shown from a little before where the first changed ones start to differ
+        tau_ull p = xFrom, q = yFrom, from = 0;
+        while(p < xTo && !d->deleted[p]) p++;
+        while(q < yTo && !d->inserted[q]) q++;
+        if(p < xTo && q < yTo) {
+            const tauDiffTokenStruct* const a = &d->a[p];
+            const tauDiffTokenStruct* const b = &d->b[q];
+            tau_ull column = 0;
+            while(column < a->size && column < b->size && a->data[column] == b->data[column])
+                column++;
+            if((a->size > TAU_STR_DIFF_WIDTH || b->size > TAU_STR_DIFF_WIDTH) && column > TAU_STR_DIFF_WIDTH / 2)
+                from = column - TAU_STR_DIFF_WIDTH / 2;
+        }
+
+        for(p = xFrom, q = yFrom; p < xTo || q < yTo; numLines++) {
+            const tauDiffTokenStruct* token;
+            if(numLines >= TAU_STR_DIFF_MAX_LINES) {
+                tauPrintf("    ...\n");
+                break;
+            }
+            if(p < xTo && d->deleted[p]) {
+                token = &d->a[p++];
+                tauPrintDiffLine('-', token->data, token->size, from);
+            } else if(q < yTo && d->inserted[q]) {
+                token = &d->b[q++];
+                tauPrintDiffLine('+', token->data, token->size, from);
+            } else {
+                token = &d->a[p++];
+                q++;
+                tauPrintDiffLine(' ', token->data, token->size, from);
+            }
+            // Only the last line of a string can lack a '\n'
+            if(token->data[token->size - 1] != '\n')
+                tauPrintf("    \\ No newline at end\n");
+        }
+    }
+    if(numSkipped > 0)
+        tauPrintf("    ... (%" TAU_PRIu64 " more hunks)\n", numSkipped);
+}
+
+// Diff expected[from, expectedTo) against actual[from, actualTo). Returns 0, having printed nothing, if that's
+// too large or too costly a diff.
+static int tauPrintStrDiff(const char* const actual, const tau_ull actualTo, const char* const expected,
+                           const tau_ull expectedTo, const tau_ull from, const int byChar, const tau_ull base) {
+    const tau_ull n = tauDiffTokenize(expected + from, expectedTo - from, byChar, TAU_NULL);
+    const tau_ull m = tauDiffTokenize(actual + from, actualTo - from, byChar, TAU_NULL);
+    tauDiffStruct d;
+    int ok = 0;
+
+    if(n > TAU_STR_DIFF_MAX_TOKENS || m > TAU_STR_DIFF_MAX_TOKENS)
+        return 0;
+
+    tauDiffTokenStruct* const a = TAU_PTRCAST(tauDiffTokenStruct*, tauMalloc((n + m) * sizeof(tauDiffTokenStruct)));
+    char* const changed = TAU_PTRCAST(char*, tauCalloc(n + m, 1));
+    tau_ll* const diagonals = TAU_PTRCAST(tau_ll*, tauMalloc(2 * (n + m + 3) * sizeof(tau_ll)));
+    if(a != TAU_NULL && changed != TAU_NULL && diagonals != TAU_NULL) {
+        tauDiffTokenize(expected + from, expectedTo - from, byChar, a);
+        tauDiffTokenize(actual + from, actualTo - from, byChar, a + n);
+        d.a = a;
+        d.b = a + n;
+        d.deleted = changed;
+        d.inserted = changed + n;
+        d.forward = diagonals + m + 1;
+        d.backward = diagonals + (n + m + 3) + m + 1;
+        d.cost = 0;
+
+        ok = tauDiffCompare(&d, 0, TAU_CAST(tau_ll, n), 0, TAU_CAST(tau_ll, m));
+        if(ok) {
+            tauPrintf("    --- expected\n");
+            tauPrintf("    +++ actual\n");
+            tauPrintDiffHunks(&d, n, m, byChar, base);
+        }
+    }
+    tauFree(a);
+    tauFree(changed);
+    tauFree(diagonals);
+    return ok;
+}
+
+// The lines of `actual` and `expected` (of which the first `at` characters are the same) where they first differ
+static void tauPrintStrDivergence(const char* const actual, const tau_ull actualSize, const char* const expected,
+                                  const tau_ull expectedSize, const tau_ull at) {
+    tau_ull lineStart = at, actualEnd = at, expectedEnd = at;
+
+    while(lineStart > 0 && expected[lineStart - 1] != '\n')
+        lineStart--;
+    while(actualEnd < actualSize && actual[actualEnd] != '\n')
+        actualEnd++;
+    while(expectedEnd < expectedSize && expected[expectedEnd] != '\n')
+        expectedEnd++;
+
+    const tau_ull column = at - lineStart;
+    const tau_ull from = column > TAU_STR_DIFF_WIDTH / 2 ? column - TAU_STR_DIFF_WIDTH / 2 : 0;
+    tauPrintf("    (too many differences to diff, showing where they start)\n");
+    tauPrintDiffLine('-', expected + lineStart, expectedEnd - lineStart, from);
+    tauPrintDiffLine('+', actual + lineStart, actualEnd - lineStart, from);
+}
+
+static TAU_COLD_ void tauReportStrDiff(const tauAssertStruct* const assertion, const char* const actual,
+                                       const tau_ull actualSize, const char* const expected,
+                                       const tau_ull expectedSize) {
+    const tau_ull shorter = actualSize < expectedSize ? actualSize : expectedSize;
+    const int byChar = memchr(actual, '\n', actualSize) == TAU_NULL &&
+                       memchr(expected, '\n', expectedSize) == TAU_NULL;
+
+    if(!tauReportFailureStart(assertion, tauShouldDecomposeMacro(assertion->actual, assertion->expected, 1)))
+        return;
+    if(byChar && actualSize + expectedSize <= TAU_STR_DIFF_WIDTH) {
+        tauPrintf("  Expected : \"%.*s\" %s \"%.*s\"\n", TAU_CAST(int, actualSize), actual, assertion->op,
+                  TAU_CAST(int, expectedSize), expected);
+        tauPrintf("    Actual : %s\n", assertion->outcome);
+        return;
+    }
+
+    tauPrintf("  Expected : %s %s %s\n", assertion->actual, assertion->op, assertion->expected);
+    if(assertion->op[0] != '=') {
+        tauPrintf("    Actual : %s (both are %" TAU_PRIu64 " characters long)\n", assertion->outcome,
+                  TAU_CAST(tau_u64, actualSize));
+        return;
+    }
+
+    // Where the strings start to differ, and how much of them is the same after that
+    const tau_ull at = tauBufScan(TAU_PTRCAST(const tau_u8*, actual), TAU_PTRCAST(const tau_u8*, expected), 0,
+                                  shorter, 1);
+    tau_ull same = 0;
+    while(same < shorter - at && actual[actualSize - same - 1] == expected[expectedSize - same - 1])
+        same++;
+
+    if(byChar) {
+        // Keep enough of what's the same around the differences for their context
+        const tau_ull from = at > TAU_STR_DIFF_CHAR_CONTEXT_ ? at - TAU_STR_DIFF_CHAR_CONTEXT_ : 0;
+        same = same > TAU_STR_DIFF_CHAR_CONTEXT_ ? same - TAU_STR_DIFF_CHAR_CONTEXT_ : 0;
+        tauPrintf("    Actual : %s (first difference at offset %" TAU_PRIu64 ")\n", assertion->outcome,
+                  TAU_CAST(tau_u64, at));
+        if(!tauPrintStrDiff(actual, actualSize - same, expected, expectedSize - same, from, 1, from + 1))
+            tauPrintStrDivergence(actual, actualSize, expected, expectedSize, at);
+        return;
+    }
+
+    // Only diff whole lines, starting and ending TAU_STR_DIFF_CONTEXT lines away from the differences
+    tau_ull from = at, line = 1, column, base;
+    tau_ull actualTo = actualSize - same, expectedTo = expectedSize - same;
+    while(from > 0 && expected[from - 1] != '\n')
+        from--;
+    for(tau_ull i = 0; i < from; i++)
+        line += expected[i] == '\n';
+    column = at - from + 1;
+    for(base = line; base > 1 && base + TAU_STR_DIFF_CONTEXT > line; base--) {
+        for(from--; from > 0 && expected[from - 1] != '\n'; from--) {}
+    }
+    while(expectedTo < expectedSize && !((expectedTo == from || expected[expectedTo - 1] == '\n') &&
+                                         (actualTo == from || actual[actualTo - 1] == '\n'))) {
+        expectedTo++;
+        actualTo++;
+    }
+    for(int i = 0; i < TAU_STR_DIFF_CONTEXT && expectedTo < expectedSize; i++) {
+        for(expectedTo++, actualTo++; expectedTo < expectedSize && expected[expectedTo - 1] != '\n';
+            expectedTo++, actualTo++) {}
+    }
+
+    tauPrintf("    Actual : %s (first difference at line %" TAU_PRIu64 ", column %" TAU_PRIu64 ")\n",
+              assertion->outcome, TAU_CAST(tau_u64, line), TAU_CAST(tau_u64, column));
+    if(!tauPrintStrDiff(actual, actualTo, expected, expectedTo, from, 0, base))
+        tauPrintStrDivergence(actual, actualSize, expected, expectedSize, at);
+}
+
+static TAU_COLD_ void tauReportStrFailure(const tauAssertStruct* const assertion, const char* const actual,
+                                          const char* const expected) {
+    tauReportStrDiff(assertion, actual, strlen(actual), expected, strlen(expected));
+}
+
+static TAU_COLD_ void tauReportStrnFailure(const tauAssertStruct* const assertion, const char* const actual,
+                                           const char* const expected, const int n) {
+    tau_ull actualSize = 0, expectedSize = 0;
+    while(actualSize < TAU_CAST(tau_ull, n) && actual[actualSize] != '\0')
+        actualSize++;
+    while(expectedSize < TAU_CAST(tau_ull, n) && expected[expectedSize] != '\0')
+        expectedSize++;
+    tauReportStrDiff(assertion, actual, actualSize, expected, expectedSize);
+}
+
+/**
+    Array comparisons (CHECK_ARRAY_EQ and friends)
+    The arrays are walked with vector compares where available, so a passing check costs about as much as reading
+    both arrays once. Only the elements a vector compare can't vouch for are looked at one at a time, by the same
+    test the failure report uses. A failure reports how many elements differ, the first `TAU_ARRAY_DIFF_MAX_ELEMS`
+    of them, and the largest absolute and relative errors over the whole array.
+*/
+#ifndef TAU_ARRAY_DIFF_MAX_ELEMS
+    #define TAU_ARRAY_DIFF_MAX_ELEMS    10
+#endif // TAU_ARRAY_DIFF_MAX_ELEMS
+
+// Element types
+#define TAU_ARRAY_UNKNOWN_      0           // No way to tell without C11 or overloading
+#define TAU_ARRAY_FLOAT_        1
+#define TAU_ARRAY_DOUBLE_       2
+#define TAU_ARRAY_SIGNED_       3
+#define TAU_ARRAY_UNSIGNED_     4
+#define TAU_ARRAY_OTHER_        5           // Compared byte by byte
+
+// What counts as a match
+#define TAU_ARRAY_EQ_           1
+#define TAU_ARRAY_NEAR_         2
+#define TAU_ARRAY_ULP_          3
+
+typedef struct tauArrayCmpStruct {
+    int type;                   // TAU_ARRAY_*_ type of the elements of both arrays
+    tau_ull size;               // sizeof an element
+    int mode;                   // TAU_ARRAY_EQ_, TAU_ARRAY_NEAR_ or TAU_ARRAY_ULP_
+    double absTol;              // NEAR: |actual - expected| <= absTol + relTol * |expected|
+    double relTol;
+    float absTolF;              // The same, for float arrays
+    float relTolF;
+    tau_u64 ulps;               // ULP: at most this many representable values apart
+    const char* misuse;         // Why the arrays can't be compared, if they can't
+} tauArrayCmpStruct;
+
+// `tauArrayType(ptr)` is the TAU_ARRAY_*_ type of what `ptr` points to
+#ifdef TAU_OVERLOADABLE
+    static inline TAU_OVERLOADABLE int tauArrayType(const float* const p) { (void)p; return TAU_ARRAY_FLOAT_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const double* const p) { (void)p; return TAU_ARRAY_DOUBLE_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const char* const p) {
+        (void)p;
+        return TAU_CAST(char, -1) < 0 ? TAU_ARRAY_SIGNED_ : TAU_ARRAY_UNSIGNED_;
+    }
+    static inline TAU_OVERLOADABLE int tauArrayType(const signed char* const p) { (void)p; return TAU_ARRAY_SIGNED_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const short* const p) { (void)p; return TAU_ARRAY_SIGNED_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const int* const p) { (void)p; return TAU_ARRAY_SIGNED_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const long* const p) { (void)p; return TAU_ARRAY_SIGNED_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const long long* const p) { (void)p; return TAU_ARRAY_SIGNED_; }
+    static inline TAU_OVERLOADABLE int tauArrayType(const unsigned char* const p) {
+        (void)p;
+        return TAU_ARRAY_UNSIGNED_;
+    }
+    static inline TAU_OVERLOADABLE int tauArrayType(const unsigned short* const p) {
+        (void)p;
+        return TAU_ARRAY_UNSIGNED_;
+    }
+    static inline TAU_OVERLOADABLE int tauArrayType(const unsigned int* const p) {
+        (void)p;
+        return TAU_ARRAY_UNSIGNED_;
+    }
+    static inline TAU_OVERLOADABLE int tauArrayType(const unsigned long* const p) {
+        (void)p;
+        return TAU_ARRAY_UNSIGNED_;
+    }
+    static inline TAU_OVERLOADABLE int tauArrayType(const unsigned long long* const p) {
+        (void)p;
+        return TAU_ARRAY_UNSIGNED_;
+    }
+    static inline TAU_OVERLOADABLE int tauArrayType(const void* const p) { (void)p; return TAU_ARRAY_OTHER_; }
+
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+    #define tauArrayType(ptr)                                                   \
+        _Generic(*(ptr),                                                        \
+                    float : TAU_ARRAY_FLOAT_,                                   \
+                    double : TAU_ARRAY_DOUBLE_,                                 \
+                    char : (TAU_CAST(char, -1) < 0 ? TAU_ARRAY_SIGNED_ :        \
+                                                     TAU_ARRAY_UNSIGNED_),      \
+                    signed char : TAU_ARRAY_SIGNED_,                            \
+                    short : TAU_ARRAY_SIGNED_,                                  \
+                    int : TAU_ARRAY_SIGNED_,                                    \
+                    long : TAU_ARRAY_SIGNED_,                                   \
+                    long long : TAU_ARRAY_SIGNED_,                              \
+                    unsigned char : TAU_ARRAY_UNSIGNED_,                        \
+                    unsigned short : TAU_ARRAY_UNSIGNED_,                       \
+                    unsigned int : TAU_ARRAY_UNSIGNED_,                         \
+                    unsigned long : TAU_ARRAY_UNSIGNED_,                        \
+                    unsigned long long : TAU_ARRAY_UNSIGNED_,                   \
+                    default : TAU_ARRAY_OTHER_)
+
+#else
+    #define tauArrayType(ptr)   TAU_ARRAY_UNKNOWN_
+#endif // TAU_OVERLOADABLE
+
+static tauArrayCmpStruct tauArrayCmp(const int actualType, const tau_ull actualSize, const int expectedType,
+                                     const tau_ull expectedSize, const int mode, const double absTol,
+                                     const double relTol, const tau_u64 ulps) {
+    tauArrayCmpStruct cmp;
+    cmp.type = expectedType;
+    cmp.size = expectedSize;
+    cmp.mode = mode;
+    cmp.absTol = absTol;
+    cmp.relTol = relTol;
+    cmp.absTolF = TAU_CAST(float, absTol);
+    cmp.relTolF = TAU_CAST(float, relTol);
+    cmp.ulps = ulps;
+    cmp.misuse = TAU_NULL;
+
+    if(actualType != expectedType || actualSize != expectedSize) {
+        cmp.misuse = "the arrays have different element types";
+        return cmp;
+    }
+    // Without type information, go by size: only floating point tolerances make sense anyway
+    if(cmp.type == TAU_ARRAY_UNKNOWN_) {
+        if(mode == TAU_ARRAY_EQ_)
+            cmp.type = TAU_ARRAY_OTHER_;
+        else if(cmp.size == sizeof(float))
+            cmp.type = TAU_ARRAY_FLOAT_;
+        else if(cmp.size == sizeof(double))
+            cmp.type = TAU_ARRAY_DOUBLE_;
+    }
+    if(mode == TAU_ARRAY_ULP_ && cmp.type != TAU_ARRAY_FLOAT_ && cmp.type != TAU_ARRAY_DOUBLE_)
+        cmp.misuse = "ULP comparisons need arrays of float or double";
+    else if(mode == TAU_ARRAY_NEAR_ && (cmp.type == TAU_ARRAY_OTHER_ || cmp.type == TAU_ARRAY_UNKNOWN_))
+        cmp.misuse = "tolerances need arrays of numbers";
+    else if(mode == TAU_ARRAY_NEAR_ && (absTol < 0 || relTol < 0))
+        cmp.misuse = "tolerances can't be negative";
+    return cmp;
+}
+
+// How many representable values apart `a` and `b` are (the maximum if either is a NaN)
+static tau_u64 tauUlpsBetweenFloats(const float a, const float b) {
+    tau_i32 x, y;
+    if(a != a || b != b)
+        return ~TAU_CAST(tau_u64, 0);
+    memcpy(&x, &a, sizeof(x));
+    memcpy(&y, &b, sizeof(y));
+
+    // Sign and magnitude: the distance is that between the magnitudes, or their sum across zero
+    const tau_u64 magX = TAU_CAST(tau_u64, x & 0x7FFFFFFF);
+    const tau_u64 magY = TAU_CAST(tau_u64, y & 0x7FFFFFFF);
+    if((x < 0) != (y < 0))
+        return magX + magY;
+    return magX > magY ? magX - magY : magY - magX;
+}
+
+static tau_u64 tauUlpsBetweenDoubles(const double a, const double b) {
+    tau_i64 x, y;
+    if(a != a || b != b)
+        return ~TAU_CAST(tau_u64, 0);
+    memcpy(&x, &a, sizeof(x));
+    memcpy(&y, &b, sizeof(y));
+
+    const tau_u64 magX = TAU_CAST(tau_u64, x) & 0x7FFFFFFFFFFFFFFFull;
+    const tau_u64 magY = TAU_CAST(tau_u64, y) & 0x7FFFFFFFFFFFFFFFull;
+    if((x < 0) != (y < 0))
+        return magX + magY;
+    return magX > magY ? magX - magY : magY - magX;
+}
+
+// Whether `actual` matches `expected`. This is what decides; the vector compares below only skip ahead.
+static inline int tauFloatsMatch(const tauArrayCmpStruct* const cmp, const float actual, const float expected) {
+    if(actual == expected)
+        return 1;
+    if(cmp->mode == TAU_ARRAY_NEAR_) {
+        // An infinite difference is never near (`diff - diff` is a NaN then)
+        const float diff = actual > expected ? actual - expected : expected - actual;
+        return diff - diff == 0 && diff <= cmp->absTolF + cmp->relTolF * (expected < 0 ? -expected : expected);
+    }
+    if(cmp->mode == TAU_ARRAY_ULP_)
+        return tauUlpsBetweenFloats(actual, expected) <= cmp->ulps;
+    return 0;
+}
+
+static inline int tauDoublesMatch(const tauArrayCmpStruct* const cmp, const double actual, const double expected) {
+    if(actual == expected)
+        return 1;
+    if(cmp->mode == TAU_ARRAY_NEAR_) {
+        const double diff = actual > expected ? actual - expected : expected - actual;
+        return diff - diff == 0 && diff <= cmp->absTol + cmp->relTol * (expected < 0 ? -expected : expected);
+    }
+    if(cmp->mode == TAU_ARRAY_ULP_)
+        return tauUlpsBetweenDoubles(actual, expected) <= cmp->ulps;
+    return 0;
+}
+
+// Element `i` of an integer array, widened
+static tau_i64 tauArraySigned(const void* const data, const tau_ull size, const tau_ull i) {
+    const tau_u8* const p = TAU_PTRCAST(const tau_u8*, data) + i * size;
+    tau_i8 i8; tau_i16 i16; tau_i32 i32; tau_i64 i64;
+    switch(size) {
+        case 1:     memcpy(&i8, p, 1); return i8;
+        case 2:     memcpy(&i16, p, 2); return i16;
+        case 4:     memcpy(&i32, p, 4); return i32;
+        default:    memcpy(&i64, p, 8); return i64;
+    }
+}
+
+static tau_u64 tauArrayUnsigned(const void* const data, const tau_ull size, const tau_ull i) {
+    const tau_u8* const p = TAU_PTRCAST(const tau_u8*, data) + i * size;
+    tau_u8 u8; tau_u16 u16; tau_u32 u32; tau_u64 u64;
+    switch(size) {
+        case 1:     memcpy(&u8, p, 1); return u8;
+        case 2:     memcpy(&u16, p, 2); return u16;
+        case 4:     memcpy(&u32, p, 4); return u32;
+        default:    memcpy(&u64, p, 8); return u64;
+    }
+}
+
+// Element `i` of a numeric array, as a double
+static double tauArrayNumber(const tauArrayCmpStruct* const cmp, const void* const data, const tau_ull i) {
+    switch(cmp->type) {
+        case TAU_ARRAY_FLOAT_:      return TAU_PTRCAST(const float*, data)[i];
+        case TAU_ARRAY_DOUBLE_:     return TAU_PTRCAST(const double*, data)[i];
+        case TAU_ARRAY_SIGNED_:     return TAU_CAST(double, tauArraySigned(data, cmp->size, i));
+        default:                    return TAU_CAST(double, tauArrayUnsigned(data, cmp->size, i));
+    }
+}
+
+static int tauArrayElemsMatch(const tauArrayCmpStruct* const cmp, const void* const actual,
+                              const void* const expected, const tau_ull i) {
+    switch(cmp->type) {
+        case TAU_ARRAY_FLOAT_:
+            return tauFloatsMatch(cmp, TAU_PTRCAST(const float*, actual)[i], TAU_PTRCAST(const float*, expected)[i]);
+        case TAU_ARRAY_DOUBLE_:
+            return tauDoublesMatch(cmp, TAU_PTRCAST(const double*, actual)[i],
+                                   TAU_PTRCAST(const double*, expected)[i]);
+        case TAU_ARRAY_SIGNED_:
+        case TAU_ARRAY_UNSIGNED_:
+            if(cmp->mode == TAU_ARRAY_NEAR_) {
+                const double a = tauArrayNumber(cmp, actual, i), b = tauArrayNumber(cmp, expected, i);
+                return a == b || (a > b ? a - b : b - a) <= cmp->absTol + cmp->relTol * (b < 0 ? -b : b);
+            }
+            /* fallthrough */
+        default:
+            return memcmp(TAU_PTRCAST(const tau_u8*, actual) + i * cmp->size,
+                          TAU_PTRCAST(const tau_u8*, expected) + i * cmp->size, cmp->size) == 0;
+    }
+}
+
+// Index of the first float at or after `i` that doesn't match; `n` if there is none
+static tau_ull tauArrayFindFloat(const tauArrayCmpStruct* const cmp, const float* const a, const float* const b,
+                                 tau_ull i, const tau_ull n) {
+    const tau_i32 ulps = cmp->ulps < 0x7FFFFFFF ? TAU_CAST(tau_i32, cmp->ulps) : 0x7FFFFFFF;
+#if defined(TAU_HAS_AVX2_)
+    const __m256 absTol = _mm256_set1_ps(cmp->absTolF);
+    const __m256 relTol = _mm256_set1_ps(cmp->relTolF);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 infinity = _mm256_castsi256_ps(_mm256_set1_epi32(0x7F800000));
+    for(; i + 8 <= n; i += 8) {
+        const __m256 x = _mm256_loadu_ps(a + i);
+        const __m256 y = _mm256_loadu_ps(b + i);
+        __m256 ok = _mm256_cmp_ps(x, y, _CMP_EQ_OQ);
+        if(cmp->mode == TAU_ARRAY_NEAR_) {
+            const __m256 diff = _mm256_andnot_ps(signBit, _mm256_sub_ps(x, y));
+            const __m256 bound = _mm256_add_ps(absTol, _mm256_mul_ps(relTol, _mm256_andnot_ps(signBit, y)));
+            ok = _mm256_or_ps(ok, _mm256_and_ps(_mm256_cmp_ps(diff, bound, _CMP_LE_OQ),
+                                                _mm256_cmp_ps(diff, infinity, _CMP_LT_OQ)));
+        } else if(cmp->mode == TAU_ARRAY_ULP_) {
+            // Between numbers of the same sign, the difference of their bits is their distance in ULPs
+            const __m256i xi = _mm256_castps_si256(x);
+            const __m256i yi = _mm256_castps_si256(y);
+            const __m256i sameSign = _mm256_cmpgt_epi32(_mm256_xor_si256(xi, yi), _mm256_set1_epi32(-1));
+            const __m256i far = _mm256_cmpgt_epi32(_mm256_abs_epi32(_mm256_sub_epi32(xi, yi)),
+                                                   _mm256_set1_epi32(ulps));
+            const __m256 close = _mm256_castsi256_ps(_mm256_andnot_si256(far, sameSign));
+            ok = _mm256_or_ps(ok, _mm256_and_ps(close, _mm256_cmp_ps(x, y, _CMP_ORD_Q)));
+        }
+        for(tau_u32 suspects = ~TAU_CAST(tau_u32, _mm256_movemask_ps(ok)) & 0xFF; suspects != 0;
+            suspects &= suspects - 1) {
+            const tau_ull j = i + TAU_CAST(tau_ull, tauLowestBit(suspects));
+            if(!tauFloatsMatch(cmp, a[j], b[j]))
+                return j;
+        }
+    }
+#elif defined(TAU_HAS_SSE2_)
+    const __m128 absTol = _mm_set1_ps(cmp->absTolF);
+    const __m128 relTol = _mm_set1_ps(cmp->relTolF);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 infinity = _mm_castsi128_ps(_mm_set1_epi32(0x7F800000));
+    for(; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_loadu_ps(a + i);
+        const __m128 y = _mm_loadu_ps(b + i);
+        __m128 ok = _mm_cmpeq_ps(x, y);
+        if(cmp->mode == TAU_ARRAY_NEAR_) {
+            const __m128 diff = _mm_andnot_ps(signBit, _mm_sub_ps(x, y));
+            const __m128 bound = _mm_add_ps(absTol, _mm_mul_ps(relTol, _mm_andnot_ps(signBit, y)));
+            ok = _mm_or_ps(ok, _mm_and_ps(_mm_cmple_ps(diff, bound), _mm_cmplt_ps(diff, infinity)));
+        } else if(cmp->mode == TAU_ARRAY_ULP_) {
+            const __m128i xi = _mm_castps_si128(x);
+            const __m128i yi = _mm_castps_si128(y);
+            const __m128i sameSign = _mm_cmpgt_epi32(_mm_xor_si128(xi, yi), _mm_set1_epi32(-1));
+            const __m128i diff = _mm_sub_epi32(xi, yi);
+            const __m128i negative = _mm_srai_epi32(diff, 31);
+            const __m128i far = _mm_cmpgt_epi32(_mm_sub_epi32(_mm_xor_si128(diff, negative), negative),
+                                                _mm_set1_epi32(ulps));
+            const __m128 close = _mm_castsi128_ps(_mm_andnot_si128(far, sameSign));
+            ok = _mm_or_ps(ok, _mm_and_ps(close, _mm_cmpord_ps(x, y)));
+        }
+        for(tau_u32 suspects = ~TAU_CAST(tau_u32, _mm_movemask_ps(ok)) & 0xF; suspects != 0;
+            suspects &= suspects - 1) {
+            const tau_ull j = i + TAU_CAST(tau_ull, tauLowestBit(suspects));
+            if(!tauFloatsMatch(cmp, a[j], b[j]))
+                return j;
+        }
+    }
+#elif defined(TAU_HAS_NEON_)
+    const float32x4_t absTol = vdupq_n_f32(cmp->absTolF);
+    const float32x4_t relTol = vdupq_n_f32(cmp->relTolF);
+    const float32x4_t infinity = vreinterpretq_f32_u32(vdupq_n_u32(0x7F800000));
+    for(; i + 4 <= n; i += 4) {
+        const float32x4_t x = vld1q_f32(a + i);
+        const float32x4_t y = vld1q_f32(b + i);
+        uint32x4_t ok = vceqq_f32(x, y);
+        if(cmp->mode == TAU_ARRAY_NEAR_) {
+            const float32x4_t bound = vaddq_f32(absTol, vmulq_f32(relTol, vabsq_f32(y)));
+            const float32x4_t diff = vabdq_f32(x, y);
+            ok = vorrq_u32(ok, vandq_u32(vcleq_f32(diff, bound), vcltq_f32(diff, infinity)));
+        } else if(cmp->mode == TAU_ARRAY_ULP_) {
+            const int32x4_t xi = vreinterpretq_s32_f32(x);
+            const int32x4_t yi = vreinterpretq_s32_f32(y);
+            const uint32x4_t sameSign = vcgezq_s32(veorq_s32(xi, yi));
+            const uint32x4_t close = vcleq_s32(vabsq_s32(vsubq_s32(xi, yi)), vdupq_n_s32(ulps));
+            const uint32x4_t ordered = vandq_u32(vceqq_f32(x, x), vceqq_f32(y, y));
+            ok = vorrq_u32(ok, vandq_u32(vandq_u32(sameSign, close), ordered));
+        }
+        // No movemask on NEON: check the whole block
+        if(vminvq_u32(ok) == 0) {
+            for(tau_ull j = i; j < i + 4; j++) {
+                if(!tauFloatsMatch(cmp, a[j], b[j]))
+                    return j;
+            }
+        }
+    }
+#endif // TAU_HAS_AVX2_
+    (void)ulps;
+    for(; i < n; i++) {
+        if(!tauFloatsMatch(cmp, a[i], b[i]))
+            return i;
+    }
+    return n;
+}
+
+static tau_ull tauArrayFindDouble(const tauArrayCmpStruct* const cmp, const double* const a, const double* const b,
+                                  tau_ull i, const tau_ull n) {
+#if defined(TAU_HAS_AVX2_)
+    const tau_i64 ulps = cmp->ulps < 0x7FFFFFFFFFFFFFFFull ? TAU_CAST(tau_i64, cmp->ulps) : 0x7FFFFFFFFFFFFFFFll;
+    const __m256d absTol = _mm256_set1_pd(cmp->absTol);
+    const __m256d relTol = _mm256_set1_pd(cmp->relTol);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d infinity = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FF0000000000000ll));
+    for(; i + 4 <= n; i += 4) {
+        const __m256d x = _mm256_loadu_pd(a + i);
+        const __m256d y = _mm256_loadu_pd(b + i);
+        __m256d ok = _mm256_cmp_pd(x, y, _CMP_EQ_OQ);
+        if(cmp->mode == TAU_ARRAY_NEAR_) {
+            const __m256d diff = _mm256_andnot_pd(signBit, _mm256_sub_pd(x, y));
+            const __m256d bound = _mm256_add_pd(absTol, _mm256_mul_pd(relTol, _mm256_andnot_pd(signBit, y)));
+            ok = _mm256_or_pd(ok, _mm256_and_pd(_mm256_cmp_pd(diff, bound, _CMP_LE_OQ),
+                                                _mm256_cmp_pd(diff, infinity, _CMP_LT_OQ)));
+        } else if(cmp->mode == TAU_ARRAY_ULP_) {
+            const __m256i xi = _mm256_castpd_si256(x);
+            const __m256i yi = _mm256_castpd_si256(y);
+            const __m256i sameSign = _mm256_cmpgt_epi64(_mm256_xor_si256(xi, yi), _mm256_set1_epi64x(-1));
+            const __m256i diff = _mm256_sub_epi64(xi, yi);
+            const __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), diff);
+            const __m256i far = _mm256_cmpgt_epi64(_mm256_sub_epi64(_mm256_xor_si256(diff, negative), negative),
+                                                   _mm256_set1_epi64x(ulps));
+            const __m256d close = _mm256_castsi256_pd(_mm256_andnot_si256(far, sameSign));
+            ok = _mm256_or_pd(ok, _mm256_and_pd(close, _mm256_cmp_pd(x, y, _CMP_ORD_Q)));
+        }
+        for(tau_u32 suspects = ~TAU_CAST(tau_u32, _mm256_movemask_pd(ok)) & 0xF; suspects != 0;
+            suspects &= suspects - 1) {
+            const tau_ull j = i + TAU_CAST(tau_ull, tauLowestBit(suspects));
+            if(!tauDoublesMatch(cmp, a[j], b[j]))
+                return j;
+        }
+    }
+#elif defined(TAU_HAS_SSE2_)
+    // No 64-bit compares before SSE4.2: ULP comparisons only skip over equal elements here
+    const __m128d absTol = _mm_set1_pd(cmp->absTol);
+    const __m128d relTol = _mm_set1_pd(cmp->relTol);
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    const __m128d infinity = _mm_castsi128_pd(_mm_set1_epi64x(0x7FF0000000000000ll));
+    for(; i + 2 <= n; i += 2) {
+        const __m128d x = _mm_loadu_pd(a + i);
+        const __m128d y = _mm_loadu_pd(b + i);
+        __m128d ok = _mm_cmpeq_pd(x, y);
+        if(cmp->mode == TAU_ARRAY_NEAR_) {
+            const __m128d diff = _mm_andnot_pd(signBit, _mm_sub_pd(x, y));
+            const __m128d bound = _mm_add_pd(absTol, _mm_mul_pd(relTol, _mm_andnot_pd(signBit, y)));
+            ok = _mm_or_pd(ok, _mm_and_pd(_mm_cmple_pd(diff, bound), _mm_cmplt_pd(diff, infinity)));
+        }
+        for(tau_u32 suspects = ~TAU_CAST(tau_u32, _mm_movemask_pd(ok)) & 0x3; suspects != 0;
+            suspects &= suspects - 1) {
+            const tau_ull j = i + TAU_CAST(tau_ull, tauLowestBit(suspects));
+            if(!tauDoublesMatch(cmp, a[j], b[j]))
+                return j;
+        }
+    }
+#elif defined(TAU_HAS_NEON_)
+    const tau_i64 ulps = cmp->ulps < 0x7FFFFFFFFFFFFFFFull ? TAU_CAST(tau_i64, cmp->ulps) : 0x7FFFFFFFFFFFFFFFll;
+    const float64x2_t absTol = vdupq_n_f64(cmp->absTol);
+    const float64x2_t relTol = vdupq_n_f64(cmp->relTol);
+    const float64x2_t infinity = vreinterpretq_f64_u64(vdupq_n_u64(0x7FF0000000000000ull));
+    for(; i + 2 <= n; i += 2) {
+        const float64x2_t x = vld1q_f64(a + i);
+        const float64x2_t y = vld1q_f64(b + i);
+        uint64x2_t ok = vceqq_f64(x, y);
+        if(cmp->mode == TAU_ARRAY_NEAR_) {
+            const float64x2_t bound = vaddq_f64(absTol, vmulq_f64(relTol, vabsq_f64(y)));
+            const float64x2_t diff = vabdq_f64(x, y);
+            ok = vorrq_u64(ok, vandq_u64(vcleq_f64(diff, bound), vcltq_f64(diff, infinity)));
+        } else if(cmp->mode == TAU_ARRAY_ULP_) {
+            const int64x2_t xi = vreinterpretq_s64_f64(x);
+            const int64x2_t yi = vreinterpretq_s64_f64(y);
+            const uint64x2_t sameSign = vcgezq_s64(veorq_s64(xi, yi));
+            const uint64x2_t close = vcleq_s64(vabsq_s64(vsubq_s64(xi, yi)), vdupq_n_s64(ulps));
+            const uint64x2_t ordered = vandq_u64(vceqq_f64(x, x), vceqq_f64(y, y));
+            ok = vorrq_u64(ok, vandq_u64(vandq_u64(sameSign, close), ordered));
+        }
+        if(vminvq_u32(vreinterpretq_u32_u64(ok)) == 0) {
+            for(tau_ull j = i; j < i + 2; j++) {
+                if(!tauDoublesMatch(cmp, a[j], b[j]))
+                    return j;
+            }
+        }
+    }
+#endif // TAU_HAS_AVX2_
+    for(; i < n; i++) {
+        if(!tauDoublesMatch(cmp, a[i], b[i]))
+            return i;
+    }
+    return n;
+}
+
+// Index of the first element at or after `i` that doesn't match; `n` if there is none
+static tau_ull tauArrayFind(const tauArrayCmpStruct* const cmp, const void* const actual, const void* const expected,
+                            tau_ull i, const tau_ull n) {
+    switch(cmp->type) {
+        case TAU_ARRAY_FLOAT_:
+            return tauArrayFindFloat(cmp, TAU_PTRCAST(const float*, actual), TAU_PTRCAST(const float*, expected), i, n);
+        case TAU_ARRAY_DOUBLE_:
+            return tauArrayFindDouble(cmp, TAU_PTRCAST(const double*, actual), TAU_PTRCAST(const double*, expected),
+                                      i, n);
+        default:
+            break;
+    }
+    if(cmp->mode == TAU_ARRAY_NEAR_) {
+        for(; i < n; i++) {
+            if(!tauArrayElemsMatch(cmp, actual, expected, i))
+                return i;
+        }
+        return n;
+    }
+
+    // Everything else is equal only if it's the same bytes
+    const tau_ull at = tauBufScan(TAU_PTRCAST(const tau_u8*, actual), TAU_PTRCAST(const tau_u8*, expected),
+                                  i * cmp->size, n * cmp->size, 1);
+    return at / cmp->size;
+}
+
+static void tauPrintArrayElem(const tauArrayCmpStruct* const cmp, const void* const data, const tau_ull i) {
+    switch(cmp->type) {
+        case TAU_ARRAY_FLOAT_:      tauPrintf("%.9g", TAU_CAST(double, TAU_PTRCAST(const float*, data)[i])); break;
+        case TAU_ARRAY_DOUBLE_:     tauPrintf("%.17g", TAU_PTRCAST(const double*, data)[i]); break;
+        case TAU_ARRAY_SIGNED_:     tauPrintf("%" TAU_PRId64, tauArraySigned(data, cmp->size, i)); break;
+        case TAU_ARRAY_UNSIGNED_:   tauPrintf("%" TAU_PRIu64, tauArrayUnsigned(data, cmp->size, i)); break;
+        default:
+            tauPrintHexBufCmp(TAU_PTRCAST(const tau_u8*, data) + i * cmp->size,
+                              TAU_PTRCAST(const tau_u8*, data) + i * cmp->size, TAU_CAST(int, cmp->size));
+            break;
+    }
+}
+
+static TAU_COLD_ void tauReportArrayFailure(const tauAssertStruct* const assertion, const tauArrayCmpStruct* const cmp,
+                                            const void* const actual, const void* const expected, const tau_ull n) {
+    if(!tauReportFailureStart(assertion, 1))
+        return;
+    tauPrintf("  Expected : %s == %s (%" TAU_PRIu64 " elements", assertion->actual, assertion->expected,
+              TAU_CAST(tau_u64, n));
+    if(cmp->mode == TAU_ARRAY_NEAR_)
+        tauPrintf(", to within %g + %g * |%s|", cmp->absTol, cmp->relTol, assertion->expected);
+    else if(cmp->mode == TAU_ARRAY_ULP_)
+        tauPrintf(", to within %" TAU_PRIu64 " ULPs", cmp->ulps);
+    tauPrintf(")\n");
+    if(cmp->misuse != TAU_NULL) {
+        tauPrintf("    Actual : %s\n", cmp->misuse);
+        return;
+    }
+
+    tau_ull first = tauArrayFind(cmp, actual, expected, 0, n), last = first, count = 0;
+    for(tau_ull i = first; i < n; i = tauArrayFind(cmp, actual, expected, i + 1, n)) {
+        last = i;
+        count++;
+    }
+    if(count == 1) {
+        tauPrintf("    Actual : 1 element differs, at index %" TAU_PRIu64 "\n", TAU_CAST(tau_u64, first));
+    } else {
+        tauPrintf("    Actual : %" TAU_PRIu64 " elements differ, from index %" TAU_PRIu64 " to %" TAU_PRIu64 "\n",
+                  TAU_CAST(tau_u64, count), TAU_CAST(tau_u64, first), TAU_CAST(tau_u64, last));
+    }
+
+    // The largest errors, over the whole array
+    if(cmp->type != TAU_ARRAY_OTHER_) {
+        double maxAbs = 0, maxRel = 0;
+        tau_ull maxAbsAt = first, maxRelAt = first;
+        for(tau_ull i = 0; i < n; i++) {
+            const double a = tauArrayNumber(cmp, actual, i), b = tauArrayNumber(cmp, expected, i);
+            if(a == b)
+                continue;
+            const double absError = a > b ? a - b : b - a;
+            const double relError = absError / (b < 0 ? -b : b);
+            if(absError > maxAbs) {
+                maxAbs = absError;
+                maxAbsAt = i;
+            }
+            if(relError > maxRel) {
+                maxRel = relError;
+                maxRelAt = i;
+            }
+        }
+        tauPrintf("             max. absolute error %g (at index %" TAU_PRIu64 "), max. relative error %g (at index %"
+                  TAU_PRIu64 ")\n", maxAbs, TAU_CAST(tau_u64, maxAbsAt), maxRel, TAU_CAST(tau_u64, maxRelAt));
+    }
+
+    tau_ull shown = 0;
+    for(tau_ull i = first; i < n && shown < TAU_ARRAY_DIFF_MAX_ELEMS;
+        i = tauArrayFind(cmp, actual, expected, i + 1, n)) {
+        tauPrintf("    %s[%" TAU_PRIu64 "] == ", assertion->actual, TAU_CAST(tau_u64, i));
+        tauPrintArrayElem(cmp, actual, i);
+        tauPrintf(", %s[%" TAU_PRIu64 "] == ", assertion->expected, TAU_CAST(tau_u64, i));
+        tauPrintArrayElem(cmp, expected, i);
+        tauPrintf("\n");
+        shown++;
+    }
+    if(count > shown)
+        tauPrintf("    ... (%" TAU_PRIu64 " more)\n", TAU_CAST(tau_u64, count - shown));
+}
+
+static TAU_COLD_ void tauReportBoolFailure(const tauAssertStruct* const assertion) {
+    if(!tauReportFailureStart(assertion, 1))
+        return;
+    tauPrintf("  Expected : %s\n", assertion->expected);
+    tauPrintf("    Actual : %s\n", assertion->outcome);
+}
+
+static TAU_COLD_ void tauReportCheckFailure(const tauAssertStruct* const assertion, const char* const message) {
+    if(!tauFailureWithinBudget(assertion->file, assertion->line))
+        return;
+    tauPrintf("%s:%u: ", assertion->file, assertion->line);
+    tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "%s", *message ? message : "FAILED");
+    tauConsolePrintf("\n");
+    tauConsolePrintf("The following assertion failed: \n");
+    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "    %s\n", assertion->call);
+}
+
+
+#define __TAUCMP_BUF__(actual, expected, len, cond, ifCondFailsThenPrint, actualPrint, macroName, failOrAbort)  \
+    do {                                                                                                        \
+        tauAssertionCount++;                                                                                    \
+        if(TAU_UNLIKELY(memcmp(actual, expected, len) cond 0)) {                                                \
+            TAU_ASSERT_(#macroName "( " #actual ", " #expected ", " #len " )", #actual, #expected,              \
+                        #ifCondFailsThenPrint, #actualPrint);                                                   \
+            tauReportBufFailure(&tau_assert_, actual, expected, TAU_CAST(tau_ull, len));                        \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                                    \
+            if(shouldAbortTest) {                                                                               \
+                return;                                                                                         \
+            }                                                                                                   \
+        }                                                                                                       \
+    }                                                                                                           \
+    while(0)
+
+#define __TAUCMP_STRN__(actual, expected, n, cond, ifCondFailsThenPrint, actualPrint, macroName, failOrAbort)   \
+    do {                                                                                                        \
+        tauAssertionCount++;                                                                                    \
+        if(TAU_UNLIKELY(TAU_CAST(int, n) < 0)) {                                                                \
+            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "`n` cannot be negative\n");                               \
+            TAU_ABORT;                                                                                          \
+        }                                                                                                       \
+        if(TAU_UNLIKELY(strncmp(actual, expected, n) cond 0)) {                                                 \
+            TAU_ASSERT_(#macroName "( " #actual ", " #expected ", " #n " )", #actual, #expected,                \
+                        #ifCondFailsThenPrint, #actualPrint);                                                   \
+            tauReportStrnFailure(&tau_assert_, actual, expected, TAU_CAST(int, n));                             \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                                    \
+            if(shouldAbortTest) {                                                                               \
+                return;                                                                                         \
+            }                                                                                                   \
+        }                                                                                                       \
+    }                                                                                                           \
+    while(0)
+
+
+#define __TAUCMP_ARRAY__(actual, expected, n, mode, absTol, relTol, ulps, args, macroName, failOrAbort)        \
+    do {                                                                                                        \
+        tauAssertionCount++;                                                                                    \
+        const tauArrayCmpStruct tau_cmp_ = tauArrayCmp(tauArrayType(actual), sizeof(*(actual)),                 \
+                                                       tauArrayType(expected), sizeof(*(expected)),             \
+                                                       mode, absTol, relTol, ulps);                             \
+        const tau_ull tau_n_ = TAU_CAST(tau_ull, n);                                                            \
+        if(TAU_UNLIKELY(tau_cmp_.misuse != TAU_NULL ||                                                          \
+                        tauArrayFind(&tau_cmp_, actual, expected, 0, tau_n_) < tau_n_)) {                       \
+            TAU_ASSERT_(#macroName "( " args " )", #actual, #expected, "==", "not equal");                      \
+            tauReportArrayFailure(&tau_assert_, &tau_cmp_, actual, expected, tau_n_);                           \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                                    \
+            if(shouldAbortTest) {                                                                               \
+                return;                                                                                         \
+            }                                                                                                   \
+        }                                                                                                       \
+    }                                                                                                           \
+    while(0)
+
+
+#define __TAUCMP_TF(cond, actual, expected, negateSign, macroName, failOrAbort)     \
+    do {                                                                            \
+        tauAssertionCount++;                                                        \
+        if(TAU_UNLIKELY(negateSign(cond))) {                                        \
+            TAU_ASSERT_(#macroName "( " #cond " )", #cond, #expected, TAU_NULL,     \
+                        #actual);                                                   \
+            tauReportBoolFailure(&tau_assert_);                                     \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                        \
+            if(shouldAbortTest) {                                                   \
+                return;                                                             \
+            }                                                                       \
+        }                                                                           \
+    } while(0)
+
+/**
+############################################
+          {CHECK|REQUIRE} Macros
+############################################
+*/
+#define CHECK_EQ(actual, expected)      __TAUCMP__(actual, expected, ==, "", CHECK_EQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_NE(actual, expected)      __TAUCMP__(actual, expected, !=, "", CHECK_NE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_LT(actual, expected)      __TAUCMP__(actual, expected, < , " ", CHECK_LT, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_LE(actual, expected)      __TAUCMP__(actual, expected, <=, "", CHECK_LE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_GT(actual, expected)      __TAUCMP__(actual, expected, > , " ", CHECK_GT, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_GE(actual, expected)      __TAUCMP__(actual, expected, >=, "", CHECK_GE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+
+#define REQUIRE_EQ(actual, expected)    __TAUCMP__(actual, expected, ==, "", REQUIRE_EQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_NE(actual, expected)    __TAUCMP__(actual, expected, !=, "", REQUIRE_NE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_LT(actual, expected)    __TAUCMP__(actual, expected, < , " ", REQUIRE_LT, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_LE(actual, expected)    __TAUCMP__(actual, expected, <=, "", REQUIRE_LE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_GT(actual, expected)    __TAUCMP__(actual, expected, > , " ", REQUIRE_GT, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_GE(actual, expected)    __TAUCMP__(actual, expected, >=, "", REQUIRE_GE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+
+// With a printf()-style message, e.g. CHECK_EQ_MSG(a[i], b[i], "at index %d", i)
+#define CHECK_EQ_MSG(actual, expected, ...)     __TAUCMP_MSG__(actual, expected, ==, "", CHECK_EQ_MSG, TAU_FAIL_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define CHECK_NE_MSG(actual, expected, ...)     __TAUCMP_MSG__(actual, expected, !=, "", CHECK_NE_MSG, TAU_FAIL_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define CHECK_LT_MSG(actual, expected, ...)     __TAUCMP_MSG__(actual, expected, < , " ", CHECK_LT_MSG, TAU_FAIL_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define CHECK_LE_MSG(actual, expected, ...)     __TAUCMP_MSG__(actual, expected, <=, "", CHECK_LE_MSG, TAU_FAIL_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define CHECK_GT_MSG(actual, expected, ...)     __TAUCMP_MSG__(actual, expected, > , " ", CHECK_GT_MSG, TAU_FAIL_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define CHECK_GE_MSG(actual, expected, ...)     __TAUCMP_MSG__(actual, expected, >=, "", CHECK_GE_MSG, TAU_FAIL_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+
+#define REQUIRE_EQ_MSG(actual, expected, ...)   __TAUCMP_MSG__(actual, expected, ==, "", REQUIRE_EQ_MSG, TAU_ABORT_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define REQUIRE_NE_MSG(actual, expected, ...)   __TAUCMP_MSG__(actual, expected, !=, "", REQUIRE_NE_MSG, TAU_ABORT_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define REQUIRE_LT_MSG(actual, expected, ...)   __TAUCMP_MSG__(actual, expected, < , " ", REQUIRE_LT_MSG, TAU_ABORT_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define REQUIRE_LE_MSG(actual, expected, ...)   __TAUCMP_MSG__(actual, expected, <=, "", REQUIRE_LE_MSG, TAU_ABORT_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define REQUIRE_GT_MSG(actual, expected, ...)   __TAUCMP_MSG__(actual, expected, > , " ", REQUIRE_GT_MSG, TAU_ABORT_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+#define REQUIRE_GE_MSG(actual, expected, ...)   __TAUCMP_MSG__(actual, expected, >=, "", REQUIRE_GE_MSG, TAU_ABORT_IF_INSIDE_TESTSUITE, __VA_ARGS__)
+
+// Whole-string checks
+#define CHECK_STREQ(actual, expected)   __TAUCMP_STR__(actual, expected, !=, ==, not equal, CHECK_STREQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_STRNE(actual, expected)   __TAUCMP_STR__(actual, expected, ==, !=, equal, CHECK_STRNE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define REQUIRE_STREQ(actual, expected) __TAUCMP_STR__(actual, expected, !=, ==, not equal, REQUIRE_STREQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_STRNE(actual, expected) __TAUCMP_STR__(actual, expected, ==, !=, equal, REQUIRE_STRNE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+
+// Substring Checks
+#define CHECK_SUBSTREQ(actual, expected, n)     __TAUCMP_STRN__(actual, expected, n, !=, ==, unequal substrings, CHECK_SUBSTREQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_SUBSTRNE(actual, expected, n)     __TAUCMP_STRN__(actual, expected, n, ==, !=, equal substrings, CHECK_SUBSTRNE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define REQUIRE_SUBSTREQ(actual, expected, n)   __TAUCMP_STRN__(actual, expected, n, !=, ==, unequal substrings, REQUIRE_SUBSTREQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_SUBSTRNE(actual, expected, n)   __TAUCMP_STRN__(actual, expected, n, ==, !=, equal substrings, REQUIRE_SUBSTRNE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+
+// Buffer Checks
+#define CHECK_BUF_EQ(actual, expected, n)       __TAUCMP_BUF__(actual, expected, n, !=, ==, not equal, CHECK_BUF_EQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_BUF_NE(actual, expected, n)       __TAUCMP_BUF__(actual, expected, n, ==, !=, equal, CHECK_BUF_NE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define REQUIRE_BUF_EQ(actual, expected, n)     __TAUCMP_BUF__(actual, expected, n, !=, ==, not equal, REQUIRE_BUF_EQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_BUF_NE(actual, expected, n)     __TAUCMP_BUF__(actual, expected, n, ==, !=, equal, REQUIRE_BUF_NE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+
+// Array Checks: `n` elements of float, double or an integer type (anything else is compared byte by byte)
+#define CHECK_ARRAY_EQ(actual, expected, n)                         __TAUCMP_ARRAY__(actual, expected, n, TAU_ARRAY_EQ_, 0, 0, 0, #actual ", " #expected ", " #n, CHECK_ARRAY_EQ, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_ARRAY_NEAR(actual, expected, n, absTol, relTol)       __TAUCMP_ARRAY__(actual, expected, n, TAU_ARRAY_NEAR_, absTol, relTol, 0, #actual ", " #expected ", " #n ", " #absTol ", " #relTol, CHECK_ARRAY_NEAR, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_ARRAY_ULP(actual, expected, n, ulps)                  __TAUCMP_ARRAY__(actual, expected, n, TAU_ARRAY_ULP_, 0, 0, ulps, #actual ", " #expected ", " #n ", " #ulps, CHECK_ARRAY_ULP, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define REQUIRE_ARRAY_EQ(actual, expected, n)                       __TAUCMP_ARRAY__(actual, expected, n, TAU_ARRAY_EQ_, 0, 0, 0, #actual ", " #expected ", " #n, REQUIRE_ARRAY_EQ, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_ARRAY_NEAR(actual, expected, n, absTol, relTol)     __TAUCMP_ARRAY__(actual, expected, n, TAU_ARRAY_NEAR_, absTol, relTol, 0, #actual ", " #expected ", " #n ", " #absTol ", " #relTol, REQUIRE_ARRAY_NEAR, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_ARRAY_ULP(actual, expected, n, ulps)                __TAUCMP_ARRAY__(actual, expected, n, TAU_ARRAY_ULP_, 0, 0, ulps, #actual ", " #expected ", " #n ", " #ulps, REQUIRE_ARRAY_ULP, TAU_ABORT_IF_INSIDE_TESTSUITE)
+
+// Note: The negate sign `!` must be there for {CHECK|REQUIRE}_TRUE
+// Do not remove it
+#define CHECK_TRUE(cond)      __TAUCMP_TF(cond, false, true, !, CHECK_TRUE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+#define CHECK_FALSE(cond)     __TAUCMP_TF(cond, true, false, , CHECK_FALSE, TAU_FAIL_IF_INSIDE_TESTSUITE)
+
+#define REQUIRE_TRUE(cond)    __TAUCMP_TF(cond, false, true, !, REQUIRE_TRUE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+#define REQUIRE_FALSE(cond)   __TAUCMP_TF(cond, true, false, , REQUIRE_FALSE, TAU_ABORT_IF_INSIDE_TESTSUITE)
+
+#define __TAUCHECKREQUIRE__(cond, failOrAbort, macroName, ...)                                 \
+    do {                                                                                       \
+        tauAssertionCount++;                                                                   \
+        if(TAU_UNLIKELY(!(cond))) {                                                            \
+            TAU_ASSERT_(#macroName "( " #cond " )", #cond, TAU_NULL, TAU_NULL, TAU_NULL);      \
+            tauReportCheckFailure(&tau_assert_, __VA_ARGS__);                                  \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                   \
+            if(shouldAbortTest) {                                                              \
+                return;                                                                        \
+            }                                                                                  \
+        }                                                                                      \
+    }                                                                                          \
+    while(0)
+
+// This is a little hack that allows a form of "polymorphism" to a macro - it allows a user to optionally pass
+// an extra argument to a macro in {CHECK|REQUIRE}.
+// The first argument is always the condition to check/assert. If this condition fails, by default a `FAILED`
+// message is sent to STDOUT. If a second argument is passed to the macro (a string), this will be outputted
+// instead.
+//
+// The MACRO_CHOOSER uses the list of arguments twice, first to form the name of the helper macro, and then to
+// pass the arguments to that helper macro. It uses a standard trick to count the number of arguments to a macro.
+//
+// Neat hack from:
+// https://stackoverflow.com/questions/3046889/optional-parameters-with-c-macros, and
+// https://stackoverflow.com/questions/11761703/overloading-macro-on-number-of-arguments
+#define GET_3RD_ARG(arg1, arg2, arg3, ...)   arg3
+
+#define CHECK_1_ARGS(cond)              __TAUCHECKREQUIRE__(cond, TAU_FAIL_IF_INSIDE_TESTSUITE, CHECK, "FAILED")
+#define CHECK_2_ARGS(cond, message)     __TAUCHECKREQUIRE__(cond, TAU_FAIL_IF_INSIDE_TESTSUITE, CHECK, message)
+#define CHECK_MACRO_CHOOSER(...)        GET_3RD_ARG(__VA_ARGS__, CHECK_2_ARGS, CHECK_1_ARGS, )
+
+#define REQUIRE_1_ARGS(cond)            __TAUCHECKREQUIRE__(cond, TAU_ABORT_IF_INSIDE_TESTSUITE, REQUIRE, "FAILED")
+#define REQUIRE_2_ARGS(cond, message)   __TAUCHECKREQUIRE__(cond, TAU_ABORT_IF_INSIDE_TESTSUITE, REQUIRE, message)
 #define REQUIRE_MACRO_CHOOSER(...)      GET_3RD_ARG(__VA_ARGS__, REQUIRE_2_ARGS, REQUIRE_1_ARGS, )
 
-#define CHECK(...)      CHECK_MACRO_CHOOSER(__VA_ARGS__)(__VA_ARGS__)
-#define REQUIRE(...)    REQUIRE_MACRO_CHOOSER(__VA_ARGS__)(__VA_ARGS__)
+#define CHECK(...)      CHECK_MACRO_CHOOSER(__VA_ARGS__)(__VA_ARGS__)
+#define REQUIRE(...)    REQUIRE_MACRO_CHOOSER(__VA_ARGS__)(__VA_ARGS__)
+
+// Like CHECK(cond, message), with a printf()-style message that's only evaluated if `cond` fails, e.g.
+// CHECKF(n > 0, "%s: got %d items", name, n)
+#define __TAUCHECKREQUIREF__(cond, failOrAbort, macroName, ...)                                \
+    do {                                                                                       \
+        tauAssertionCount++;                                                                   \
+        if(TAU_UNLIKELY(!(cond))) {                                                            \
+            TAU_ASSERT_(#macroName "( " #cond " )", #cond, TAU_NULL, TAU_NULL, TAU_NULL);      \
+            tauReportCheckFailure(&tau_assert_, "FAILED");                                     \
+            if(tauFailureBudget.lastReported)                                                  \
+                tauReportMessage(__VA_ARGS__);                                                 \
+            failOrAbort(tau_assert_.file, tau_assert_.line);                                   \
+            if(shouldAbortTest) {                                                              \
+                return;                                                                        \
+            }                                                                                  \
+        }                                                                                      \
+    }                                                                                          \
+    while(0)
+
+#define CHECKF(cond, ...)       __TAUCHECKREQUIREF__(cond, TAU_FAIL_IF_INSIDE_TESTSUITE, CHECKF, __VA_ARGS__)
+#define REQUIREF(cond, ...)     __TAUCHECKREQUIREF__(cond, TAU_ABORT_IF_INSIDE_TESTSUITE, REQUIREF, __VA_ARGS__)
+
+#define CHECK_NULL(val)       CHECK(val == TAU_NULL)
+#define CHECK_NOT_NULL(val)   CHECK(val != TAU_NULL)
+
+#define WARN(msg)                                                        \
+    incrementWarnings();                                                 \
+    tauColouredPrintf(TAU_COLOUR_YELLOW_, "%s:%u:\nWARNING: %s\n", __FILE__, __LINE__, #msg)
+
+/**
+    Allocation assertions (need the TauAlloc library, see <tau/alloc.h>)
+    `CHECK_NO_ALLOC { ... }` and `CHECK_ALLOCS_LE(max) { ... }` fail the test if the block they introduce made more
+    than 0 (or `max`) allocations on the calling thread. Don't `break`/`return`/`goto` out of the block: the check
+    is made when it completes.
+*/
+typedef struct tauAllocScopeStruct {
+    tau_u64 allocs;
+    tau_u64 bytes;
+    int done;
+} tauAllocScopeStruct;
+
+static inline tauAllocScopeStruct tauAllocScopeBegin() {
+    tauAllocScopeStruct scope;
+    scope.allocs = tauAllocStats.allocs;
+    scope.bytes = tauAllocStats.bytes;
+    scope.done = 0;
+    return scope;
+}
+
+static void tauAllocScopeEnd(tauAllocScopeStruct* const scope, const tau_u64 max, const char* const macroName,
+                             const char* const maxStr, const char* const file, const unsigned line) {
+    static int warned = 0;
+    const tau_u64 allocs = tauAllocStats.allocs - scope->allocs;
+
+    tauAssertionCount++;
+    scope->done = 1;
+    if(!tauAllocInterposed) {
+        if(!warned) {
+            warned = 1;
+            incrementWarnings();
+            tauColouredPrintf(TAU_COLOUR_YELLOW_, "%s:%u:\nWARNING: %s needs the TauAlloc library to be linked in\n",
+                              file, line, macroName);
+        }
+        return;
+    }
+    if(allocs <= max)
+        return;
+
+    if(!tauFailureWithinBudget(file, line)) {
+        TAU_FAIL_IF_INSIDE_TESTSUITE(file, line);
+        return;
+    }
+    tauPrintf("%s:%u: ", file, line);
+    tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED\n");
+    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "  In block : %s%s%s%s\n", macroName, *maxStr ? "( " : "", maxStr,
+                      *maxStr ? " )" : "");
+    tauPrintf("  Expected : at most %" TAU_PRIu64 " allocations\n", max);
+    tauPrintf("    Actual : %" TAU_PRIu64 " allocations (%" TAU_PRIu64 " bytes)\n", allocs,
+              tauAllocStats.bytes - scope->bytes);
+    TAU_FAIL_IF_INSIDE_TESTSUITE(file, line);
+}
+
+#define __TAUALLOCSCOPE__(max, macroName, maxStr)                                                  \
+    for(tauAllocScopeStruct tau_alloc_scope_ = tauAllocScopeBegin(); !tau_alloc_scope_.done;       \
+        tauAllocScopeEnd(&tau_alloc_scope_, TAU_CAST(tau_u64, max), macroName, maxStr, __FILE__, __LINE__))
+
+#define CHECK_NO_ALLOC          __TAUALLOCSCOPE__(0, "CHECK_NO_ALLOC", "")
+#define CHECK_ALLOCS_LE(max)    __TAUALLOCSCOPE__(max, "CHECK_ALLOCS_LE", #max)
+
+#ifdef __cplusplus
+    #define SECTION(...)    \
+        if(1)
+    #define STATIC_REQUIRE(...)                  \
+        static_assert(__VA_ARGS__, #__VA_ARGS__)
+    #define STATIC_REQUIRE_FALSE(...)            \
+        static_assert(!(__VA_ARGS__), "!(" #__VA_ARGS__ ")")
+#else
+    #define SECTION(...)                                            \
+        WARN(Using "SECTION" in C results in limited diagnostics.); \
+        if(1)
+    #define STATIC_REQUIRE(...)                                              \
+        WARN(Usage of "STATIC_REQUIRE" is not supported in C source files.)
+    #define STATIC_REQUIRE_FALSE(...)                                        \
+        WARN(Usage of "STATIC_REQUIRE_FALSE" is not supported in C source files.)
+#endif // __cplusplus
+
+/**
+#########################################
+             Implementation
+#########################################
+*/
+
+#ifndef TAU_NO_TESTING
+#ifdef _MSC_VER
+    #define TAU_SNPRINTF(BUFFER, N, ...)   _snprintf_s(BUFFER, N, N, __VA_ARGS__)
+#else
+    #define TAU_SNPRINTF(...)              snprintf(__VA_ARGS__)
+#endif // _MSC_VER
+
+static void tauRegisterTest(tauTestSuiteStruct* const test, const tau_testsuite_t func, const char* const name,
+                            const char* const file, const int line);
+static void tauRegisterTest(tauTestSuiteStruct* const test, const tau_testsuite_t func, const char* const name,
+                            const char* const file, const int line) {
+    test->func = func;
+    test->name = name;
+    test->file = file;
+    test->line = line;
+    test->index = tauTestContext.numTestSuites++;
+    test->next = TAU_NULL;
+    if(tauTestContext.lastTest)
+        tauTestContext.lastTest->next = test;
+    else
+        tauTestContext.tests = test;
+    tauTestContext.lastTest = test;
+}
+
+#if defined(TAU_SECTION_REGISTRY) && defined(TAU_HAS_TEST_SECTION_)
+    #define TAU_REGISTER_TEST_(NODE, FUNC, NAME)                                                   \
+        static const tauTestDescriptorStruct NODE##_descriptor_                                    \
+            __attribute__((used, section("tau_tests"), aligned(sizeof(void*)))) =                 \
+            { &NODE, &FUNC, NAME, __FILE__, __LINE__ };
+#else
+    #define TAU_REGISTER_TEST_(NODE, FUNC, NAME)                                                   \
+        TAU_TEST_INITIALIZER(NODE##_register_) {                                                   \
+            tauRegisterTest(&NODE, &FUNC, NAME, __FILE__, __LINE__);                               \
+        }
+#endif // TAU_SECTION_REGISTRY
+
+#ifdef TAU_HAS_TEST_SECTION_
+// Defined by the linker around the `tau_tests` section. Weak, so that they resolve to NULL if it doesn't exist
+TAU_EXTERN const tauTestDescriptorStruct __start_tau_tests[] __attribute__((weak));
+TAU_EXTERN const tauTestDescriptorStruct __stop_tau_tests[] __attribute__((weak));
+
+typedef struct tauSectionEntryStruct {
+    const tauTestDescriptorStruct* desc;
+    tau_ull run;                // Which object file (i.e. contiguous run of descriptors) it came from
+} tauSectionEntryStruct;
+
+static int tauCompareSectionEntries(const void* const a, const void* const b) {
+    const tauSectionEntryStruct* const lhs = TAU_PTRCAST(const tauSectionEntryStruct*, a);
+    const tauSectionEntryStruct* const rhs = TAU_PTRCAST(const tauSectionEntryStruct*, b);
+
+    if(lhs->run != rhs->run)
+        return lhs->run < rhs->run ? -1 : 1;
+    if(lhs->desc->line != rhs->desc->line)
+        return lhs->desc->line < rhs->desc->line ? -1 : 1;
+    return lhs->desc < rhs->desc ? -1 : (lhs->desc > rhs->desc ? 1 : 0);
+}
+
+// The linker keeps each object file's descriptors together, but the compiler is free to emit them in any order
+// (GCC reverses them when optimizing), so each object file's tests are put back into source order.
+static void tauRegisterSectionTests() {
+    const tau_ull count = TAU_CAST(tau_ull, __stop_tau_tests - __start_tau_tests);
+    tauSectionEntryStruct* entries;
+    tau_ull run = 0;
+
+    if(count == 0)
+        return;
+
+    entries = TAU_PTRCAST(tauSectionEntryStruct*, tauMalloc(sizeof(tauSectionEntryStruct) * count));
+    if(TAU_NONE(entries)) {
+        for(const tauTestDescriptorStruct* desc = __start_tau_tests; desc < __stop_tau_tests; desc++)
+            tauRegisterTest(desc->test, desc->func, desc->name, desc->file, desc->line);
+        return;
+    }
+
+    for(tau_ull i = 0; i < count; i++) {
+        if(i > 0 && strcmp(__start_tau_tests[i].file, __start_tau_tests[i - 1].file) != 0)
+            run++;
+        entries[i].desc = &__start_tau_tests[i];
+        entries[i].run = run;
+    }
+    qsort(entries, count, sizeof(tauSectionEntryStruct), tauCompareSectionEntries);
+
+    for(tau_ull i = 0; i < count; i++) {
+        const tauTestDescriptorStruct* const desc = entries[i].desc;
+        tauRegisterTest(desc->test, desc->func, desc->name, desc->file, desc->line);
+    }
+    tauFree(TAU_PTRCAST(void*, entries));
+}
+#endif // TAU_HAS_TEST_SECTION_
+
+/**
+    Micro-benchmarks (`BENCH()`, `BENCH_F()`)
+    A benchmark is a test whose body is the operation to measure. It is registered, filtered and reported like
+    any other test, but its body is run in a timed loop: the number of iterations per sample is scaled up until
+    a sample takes `TAU_BENCH_SAMPLE_TIME`, a few warmup samples are thrown away, and `TAU_BENCH_SAMPLES` samples
+    are then taken. Their min/median/p99/stddev (in time per operation) are printed before the `[ OK ]` line.
+
+    Use `tau_do_not_optimize(value)` on results the benchmark doesn't otherwise use, and `tau_clobber()` to make
+    the compiler assume memory was read and written, so that it can't delete (or hoist out of the loop) the work
+    being measured.
+*/
+#ifndef TAU_BENCH_SAMPLES
+    #define TAU_BENCH_SAMPLES       100
+#endif // TAU_BENCH_SAMPLES
+#ifndef TAU_BENCH_SAMPLE_TIME
+    #define TAU_BENCH_SAMPLE_TIME   2000000     // In nanoseconds
+#endif // TAU_BENCH_SAMPLE_TIME
+#define TAU_BENCH_WARMUP_SAMPLES_   3
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define tau_do_not_optimize(value)  __asm__ __volatile__("" : : "g"(value) : "memory")
+    #define tau_clobber()               __asm__ __volatile__("" : : : "memory")
+#elif defined(_MSC_VER)
+    // No inline assembly on MSVC: settle for a compiler barrier
+    #define tau_do_not_optimize(value)  ((void)(value), _ReadWriteBarrier())
+    #define tau_clobber()               _ReadWriteBarrier()
+#else
+    #define tau_do_not_optimize(value)  ((void)(value))
+    #define tau_clobber()
+#endif // __GNUC__
+
+// Runs a benchmark's body `iterations` times, and returns how long that took (in nanoseconds)
+typedef tau_u64 (*tau_benchloop_t)(void* const arg, const tau_u64 iterations);
+
+static int tauCompareDoubles(const void* const a, const void* const b) {
+    const double lhs = *TAU_PTRCAST(const double*, a);
+    const double rhs = *TAU_PTRCAST(const double*, b);
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+// Newton's method, so that Tau doesn't need to be linked against libm
+static double tauSqrt(const double x) {
+    double root = x > 1 ? x : 1;
+    if(x <= 0)
+        return 0;
+    for(int i = 0; i < 64; i++) {
+        const double next = (root + x / root) / 2;
+        if(next >= root)
+            break;
+        root = next;
+    }
+    return root;
+}
+
+static void tauBenchPrintTime(const double nanoseconds) {
+    if(nanoseconds < 1000)
+        tauConsolePrintf("%.2fns", nanoseconds);
+    else if(nanoseconds < 1000000)
+        tauConsolePrintf("%.2fus", nanoseconds / 1000);
+    else if(nanoseconds < 1000000000)
+        tauConsolePrintf("%.2fms", nanoseconds / 1000000);
+    else
+        tauConsolePrintf("%.2fs", nanoseconds / 1000000000);
+}
+
+static void tauRunBenchmark(const tau_benchloop_t loop, void* const arg) {
+    double samples[TAU_BENCH_SAMPLES];
+    tau_u64 iterations = 1;
+    tau_u64 elapsed = loop(arg, iterations);
+    double mean = 0;
+    double variance = 0;
+    tau_u64 before[TAU_MAX_COUNTERS_];
+    tau_u64 after[TAU_MAX_COUNTERS_];
+    double counts[TAU_MAX_COUNTERS_] = {0};
+    tau_bool counting = tauCounterGroup.state == 1 && tauCounterConfig.numEvents > 0;
+
+    // Scale the iteration count up until a sample takes long enough (which doubles as the first warmup round)
+    while(elapsed < TAU_BENCH_SAMPLE_TIME && hasCurrentTestFailed == 0) {
+        const tau_u64 factor = elapsed > 0 ? TAU_BENCH_SAMPLE_TIME * 3 / (elapsed * 2) + 1 : 100;
+        iterations *= factor < 100 ? factor : 100;
+        elapsed = loop(arg, iterations);
+    }
+    for(int i = 0; i < TAU_BENCH_WARMUP_SAMPLES_ && hasCurrentTestFailed == 0; i++)
+        loop(arg, iterations);
+
+    for(int i = 0; i < TAU_BENCH_SAMPLES; i++) {
+        if(hasCurrentTestFailed == 1)
+            return;
+        // Read the counters outside of the sample's timer
+        counting = counting && tauCountersRead(before);
+        samples[i] = TAU_CAST(double, loop(arg, iterations)) / TAU_CAST(double, iterations);
+        mean += samples[i];
+        counting = counting && tauCountersRead(after);
+        for(int j = 0; counting && j < tauCounterConfig.numEvents; j++)
+            counts[j] += TAU_CAST(double, after[j] - before[j]);
+    }
+    mean /= TAU_BENCH_SAMPLES;
+    for(int i = 0; i < TAU_BENCH_SAMPLES; i++)
+        variance += (samples[i] - mean) * (samples[i] - mean);
+    variance /= TAU_BENCH_SAMPLES > 1 ? TAU_BENCH_SAMPLES - 1 : 1;
+    qsort(samples, TAU_BENCH_SAMPLES, sizeof(double), tauCompareDoubles);
+
+    tauColouredPrintf(TAU_COLOUR_BRIGHTCYAN_, "[  BENCH   ] ");
+    tauConsolePrintf("min ");
+    tauBenchPrintTime(samples[0]);
+    tauConsolePrintf(", median ");
+    tauBenchPrintTime(samples[TAU_BENCH_SAMPLES / 2]);
+    tauConsolePrintf(", p99 ");
+    // Nearest rank
+    tauBenchPrintTime(samples[(TAU_BENCH_SAMPLES * 99 + 99) / 100 - 1]);
+    tauConsolePrintf(", stddev ");
+    tauBenchPrintTime(tauSqrt(variance));
+    tauConsolePrintf(" per op (%d samples of %" TAU_PRIu64 " ops)\n", TAU_BENCH_SAMPLES, iterations);
+    if(counting) {
+        tauMetricsStruct metrics;
+        for(int j = 0; j < tauCounterConfig.numEvents; j++)
+            counts[j] /= TAU_CAST(double, iterations) * TAU_BENCH_SAMPLES;
+        tauCounterMetrics(&metrics, counts, tauCounterConfig.numEvents);
+        tauCountersPrint(&metrics, tau_true);
+    }
+
+    // For `--bench-save` and `--bench-compare`
+    if(tauCurrentCapture && tauCurrentCapture->currentTest) {
+        tauBufferStruct* const line = &tauCurrentCapture->benchmarks;
+        tauBufferPrintf(line, "%s %d", tauCurrentCapture->currentTest->name, TAU_BENCH_SAMPLES);
+        for(int i = 0; i < TAU_BENCH_SAMPLES; i++)
+            tauBufferPrintf(line, " %.6g", samples[i]);
+        tauBufferPrintf(line, "\n");
+    }
+}
+
+#define TEST(TESTSUITE, TESTNAME)                                                              \
+    static void _TAU_TEST_FUNC_##TESTSUITE##_##TESTNAME(void);                                 \
+    static tauTestSuiteStruct _TAU_TEST_NODE_##TESTSUITE##_##TESTNAME;                         \
+    TAU_REGISTER_TEST_(_TAU_TEST_NODE_##TESTSUITE##_##TESTNAME,                                \
+                       _TAU_TEST_FUNC_##TESTSUITE##_##TESTNAME,                                \
+                       #TESTSUITE "." #TESTNAME)                                               \
+    void _TAU_TEST_FUNC_##TESTSUITE##_##TESTNAME(void)
+
+// Give the test that is running `ms` milliseconds (counted from its start) before the watchdog fails it, instead
+// of what `--timeout` says. Meant to go at the top of a test's body.
+#define TEST_TIMEOUT(ms)    tauWatchSetLimit(TAU_CAST(tau_u64, ms))
+
+
+#define TEST_F_SETUP(FIXTURE)                                                  \
+    static void __TAU_TEST_FIXTURE_SETUP_##FIXTURE(struct FIXTURE* const tau)
+
+#define TEST_F_TEARDOWN(FIXTURE)                                               \
+    static void __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(struct FIXTURE* const tau)
+
+#define TEST_F(FIXTURE, NAME)                                                                            \
+    static void __TAU_TEST_FIXTURE_SETUP_##FIXTURE(struct FIXTURE* const);                               \
+    static void __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(struct FIXTURE* const);                            \
+    static void __TAU_TEST_FIXTURE_RUN_##FIXTURE##_##NAME(struct FIXTURE* const);                        \
+                                                                                                         \
+    static void __TAU_TEST_FIXTURE_##FIXTURE##_##NAME() {                                                \
+        struct FIXTURE fixture;                                                                          \
+        memset(&fixture, 0, sizeof(fixture));                                                            \
+        __TAU_TEST_FIXTURE_SETUP_##FIXTURE(&fixture);                                                    \
+        if(hasCurrentTestFailed == 1) {                                                                  \
+            return;                                                                                      \
+        }                                                                                                \
+                                                                                                         \
+        __TAU_TEST_FIXTURE_RUN_##FIXTURE##_##NAME(&fixture);                                             \
+        tauContextStack.depth = 0;                                                                       \
+        __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(&fixture);                                                 \
+    }                                                                                                    \
+                                                                                                         \
+    static tauTestSuiteStruct __TAU_TEST_NODE_##FIXTURE##_##NAME;                                        \
+    TAU_REGISTER_TEST_(__TAU_TEST_NODE_##FIXTURE##_##NAME,                                               \
+                       __TAU_TEST_FIXTURE_##FIXTURE##_##NAME,                                            \
+                       #FIXTURE "." #NAME)                                                               \
+    static void __TAU_TEST_FIXTURE_RUN_##FIXTURE##_##NAME(struct FIXTURE* const tau)
+
+#define BENCH(SUITE, NAME)                                                                       \
+    static void _TAU_BENCH_OP_##SUITE##_##NAME(void);                                              \
+    static tau_u64 _TAU_BENCH_LOOP_##SUITE##_##NAME(void* const arg, const tau_u64 iterations) {   \
+        const tau_u64 start = tauClock();                                                          \
+        (void)arg;                                                                                 \
+        for(tau_u64 i = 0; i < iterations; i++)                                                    \
+            _TAU_BENCH_OP_##SUITE##_##NAME();                                                      \
+        return tauClockSince(start);                                                               \
+    }                                                                                              \
+    static void _TAU_TEST_FUNC_##SUITE##_##NAME(void) {                                            \
+        tauRunBenchmark(_TAU_BENCH_LOOP_##SUITE##_##NAME, TAU_NULL);                               \
+    }                                                                                              \
+                                                                                                   \
+    static tauTestSuiteStruct _TAU_TEST_NODE_##SUITE##_##NAME;                                     \
+    TAU_REGISTER_TEST_(_TAU_TEST_NODE_##SUITE##_##NAME,                                            \
+                       _TAU_TEST_FUNC_##SUITE##_##NAME,                                            \
+                       #SUITE "." #NAME)                                                           \
+    static void _TAU_BENCH_OP_##SUITE##_##NAME(void)
+
+// Like `TEST_F()`, the fixture is set up before (and torn down after) the benchmark, not around every operation
+#define BENCH_F(FIXTURE, NAME)                                                                           \
+    static void __TAU_TEST_FIXTURE_SETUP_##FIXTURE(struct FIXTURE* const);                               \
+    static void __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(struct FIXTURE* const);                            \
+    static void __TAU_BENCH_FIXTURE_OP_##FIXTURE##_##NAME(struct FIXTURE* const);                        \
+                                                                                                         \
+    static tau_u64 __TAU_BENCH_FIXTURE_LOOP_##FIXTURE##_##NAME(void* const arg,                          \
+                                                               const tau_u64 iterations) {               \
+        struct FIXTURE* const fixture = TAU_PTRCAST(struct FIXTURE*, arg);                               \
+        const tau_u64 start = tauClock();                                                                \
+        for(tau_u64 i = 0; i < iterations; i++)                                                          \
+            __TAU_BENCH_FIXTURE_OP_##FIXTURE##_##NAME(fixture);                                          \
+        return tauClockSince(start);                                                                     \
+    }                                                                                                    \
+                                                                                                         \
+    static void __TAU_TEST_FIXTURE_##FIXTURE##_##NAME() {                                                \
+        struct FIXTURE fixture;                                                                          \
+        memset(&fixture, 0, sizeof(fixture));                                                            \
+        __TAU_TEST_FIXTURE_SETUP_##FIXTURE(&fixture);                                                    \
+        if(hasCurrentTestFailed == 1) {                                                                  \
+            return;                                                                                      \
+        }                                                                                                \
+                                                                                                         \
+        tauRunBenchmark(__TAU_BENCH_FIXTURE_LOOP_##FIXTURE##_##NAME, &fixture);                          \
+        tauContextStack.depth = 0;                                                                       \
+        __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(&fixture);                                                 \
+    }                                                                                                    \
+                                                                                                         \
+    static tauTestSuiteStruct __TAU_TEST_NODE_##FIXTURE##_##NAME;                                        \
+    TAU_REGISTER_TEST_(__TAU_TEST_NODE_##FIXTURE##_##NAME,                                               \
+                       __TAU_TEST_FIXTURE_##FIXTURE##_##NAME,                                            \
+                       #FIXTURE "." #NAME)                                                               \
+    static void __TAU_BENCH_FIXTURE_OP_##FIXTURE##_##NAME(struct FIXTURE* const tau)
+
+
+/**
+    Test filter (`--filter=POSITIVE[-NEGATIVE]`)
+    Both halves are ':'-separated lists of glob patterns, where '*' matches any string and '?' any single
+    character. A test runs if it matches at least one positive pattern (all tests, if there are none) and no
+    negative one; e.g. `A*:B.*-*Slow*`.
+
+    The filter is compiled once, before any test runs, and its verdict is cached in every test's `selected`
+    flag. Each pattern is matched as a sequence of literal segments separated by '*' (the first one anchored at
+    the start of the name, the last one at the end, the ones in between at their leftmost position), which never
+    backtracks. Patterns that start with a literal prefix only look at the tests in the matching range of a
+    sorted index of test names, so selecting a few tests out of a large binary doesn't touch all of them.
+*/
+typedef struct tauFilterPatternStruct {
+    const char* text;           // Points into the `--filter` string; not NUL-terminated
+    tau_ull length;
+    tau_ull prefixLength;       // Length of the literal (wildcard-free) prefix of `text`
+} tauFilterPatternStruct;
+
+// Does `str` start with `segment[0..length)`, where '?' matches any character? `str` must hold `length` chars
+static tau_bool tauFilterSegmentMatches(const char* const segment, const tau_ull length, const char* const str) {
+    for(tau_ull i = 0; i < length; i++) {
+        if(segment[i] != '?' && segment[i] != str[i])
+            return tau_false;
+    }
+    return tau_true;
+}
+
+static tau_bool tauFilterPatternMatches(const tauFilterPatternStruct* const pattern, const char* const name) {
+    const char* pat = pattern->text;
+    const char* const patEnd = pattern->text + pattern->length;
+    const char* lastStar = patEnd;
+    const char* str = name;
+    const char* strEnd = name + strlen(name);
+    tau_ull segmentLength;
+
+    while(lastStar > pat && lastStar[-1] != '*')
+        lastStar--;
+
+    // No wildcard run at all: the whole name has to match
+    if(lastStar == pat) {
+        return TAU_CAST(tau_ull, strEnd - str) == pattern->length &&
+               tauFilterSegmentMatches(pat, pattern->length, str);
+    }
+    lastStar--;
+
+    // The segment before the first '*' is anchored at the start of the name...
+    segmentLength = 0;
+    while(pat[segmentLength] != '*')
+        segmentLength++;
+    if(segmentLength > TAU_CAST(tau_ull, strEnd - str) || !tauFilterSegmentMatches(pat, segmentLength, str))
+        return tau_false;
+    str += segmentLength;
+    pat += segmentLength + 1;
+
+    // ... and the one after the last '*' at its end
+    segmentLength = TAU_CAST(tau_ull, patEnd - lastStar - 1);
+    if(segmentLength > TAU_CAST(tau_ull, strEnd - str) ||
+       !tauFilterSegmentMatches(lastStar + 1, segmentLength, strEnd - segmentLength))
+        return tau_false;
+    strEnd -= segmentLength;
+
+    // Everything in between is matched greedily, at the leftmost position it fits
+    while(pat < lastStar) {
+        const char* segmentEnd = pat;
+        while(segmentEnd < lastStar && *segmentEnd != '*')
+            segmentEnd++;
+        segmentLength = TAU_CAST(tau_ull, segmentEnd - pat);
+
+        if(segmentLength > 0) {
+            while(TAU_CAST(tau_ull, strEnd - str) >= segmentLength &&
+                  !tauFilterSegmentMatches(pat, segmentLength, str))
+                str++;
+            if(TAU_CAST(tau_ull, strEnd - str) < segmentLength)
+                return tau_false;
+            str += segmentLength;
+        }
+        pat = segmentEnd + 1;
+    }
+    return tau_true;
+}
+
+static int tauCompareTestNames(const void* const a, const void* const b) {
+    return strcmp((*TAU_PTRCAST(tauTestSuiteStruct* const*, a))->name,
+                  (*TAU_PTRCAST(tauTestSuiteStruct* const*, b))->name);
+}
+
+// Set `selected` to `select` on every test matching `pattern`, keeping `*numSelected` up to date.
+// `index` holds all tests sorted by name (or is NULL, in which case the registry is scanned in full).
+static void tauFilterMark(const tauFilterPatternStruct* const pattern, tauTestSuiteStruct* const* const index,
+                          const tau_ull size, const tau_bool select, tau_ull* const numSelected) {
+    if(TAU_SOME(index)) {
+        tau_ull begin = 0;
+        tau_ull end = size;
+
+        // Narrow [begin, end) down to the names that start with the pattern's literal prefix
+        if(pattern->prefixLength > 0) {
+            tau_ull lo = 0;
+            tau_ull hi = size;
+            while(lo < hi) {
+                const tau_ull mid = lo + (hi - lo) / 2;
+                if(strncmp(index[mid]->name, pattern->text, pattern->prefixLength) < 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            begin = lo;
+            for(hi = size; lo < hi;) {
+                const tau_ull mid = lo + (hi - lo) / 2;
+                if(strncmp(index[mid]->name, pattern->text, pattern->prefixLength) <= 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            end = lo;
+        }
+
+        for(tau_ull i = begin; i < end; i++) {
+            if(index[i]->selected != select && tauFilterPatternMatches(pattern, index[i]->name)) {
+                index[i]->selected = select;
+                *numSelected = select ? *numSelected + 1 : *numSelected - 1;
+            }
+        }
+    } else {
+        for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+            if(test->selected != select && tauFilterPatternMatches(pattern, test->name)) {
+                test->selected = select;
+                *numSelected = select ? *numSelected + 1 : *numSelected - 1;
+            }
+        }
+    }
+}
+
+// Compiles `filter`, and caches its verdict in the `selected` flag of every test. Returns the number of tests
+// selected.
+static tau_ull tauApplyFilter(const char* const filter) {
+    static const tauFilterPatternStruct matchAll = { "*", 1, 0 };
+    tauFilterPatternStruct* patterns;
+    tauTestSuiteStruct** index = TAU_NULL;
+    tau_ull numPatterns = 0;
+    tau_ull numPositive = 0;
+    tau_ull numSelected = 0;
+    tau_bool wantIndex = tau_false;
+    tau_bool negative = tau_false;
+    const char* curr;
+
+    if(TAU_NONE(filter) || *filter == TAU_NULLCHAR) {
+        for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next)
+            test->selected = tau_true;
+        return tauTestContext.numTestSuites;
+    }
+
+    // There are at most as many patterns as separators, plus one
+    numPatterns = 1;
+    for(curr = filter; *curr != TAU_NULLCHAR; curr++) {
+        if(*curr == ':' || *curr == '-')
+            numPatterns++;
+    }
+    patterns = TAU_PTRCAST(tauFilterPatternStruct*, tauMalloc(sizeof(tauFilterPatternStruct) * numPatterns));
+    if(TAU_NONE(patterns)) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "ERROR: Out of memory\n");
+        return 0;
+    }
+
+    // Split the filter into patterns: positive ones first, then (after the first '-') negative ones
+    numPatterns = 0;
+    for(curr = filter;; curr++) {
+        const char* const begin = curr;
+        tau_ull prefixLength = 0;
+
+        while(*curr != TAU_NULLCHAR && *curr != ':' && !(*curr == '-' && !negative))
+            curr++;
+        if(curr > begin) {
+            while(prefixLength < TAU_CAST(tau_ull, curr - begin) && begin[prefixLength] != '*' &&
+                  begin[prefixLength] != '?')
+                prefixLength++;
+            patterns[numPatterns].text = begin;
+            patterns[numPatterns].length = TAU_CAST(tau_ull, curr - begin);
+            patterns[numPatterns].prefixLength = prefixLength;
+            wantIndex = wantIndex || prefixLength > 0;
+            numPatterns++;
+            if(!negative)
+                numPositive++;
+        }
+
+        if(*curr == TAU_NULLCHAR)
+            break;
+        if(*curr == '-')
+            negative = tau_true;
+    }
+
+    if(wantIndex) {
+        index = TAU_PTRCAST(tauTestSuiteStruct**, tauMalloc(sizeof(tauTestSuiteStruct*) * (tauTestContext.numTestSuites + 1)));
+        if(TAU_SOME(index)) {
+            tau_ull i = 0;
+            for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next)
+                index[i++] = test;
+            qsort(index, tauTestContext.numTestSuites, sizeof(tauTestSuiteStruct*), tauCompareTestNames);
+        }
+    }
+
+    for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next)
+        test->selected = tau_false;
+
+    if(numPositive == 0)
+        tauFilterMark(&matchAll, index, tauTestContext.numTestSuites, tau_true, &numSelected);
+    for(tau_ull p = 0; p < numPatterns; p++)
+        tauFilterMark(&patterns[p], index, tauTestContext.numTestSuites, p < numPositive, &numSelected);
+
+    tauFree(TAU_PTRCAST(void*, index));
+    tauFree(TAU_PTRCAST(void*, patterns));
+    return numSelected;
+}
+
+static inline FILE* tau_fopen(const char* const filename, const char* const mode) {
+#ifdef _MSC_VER
+    FILE* file;
+    if(fopen_s(&file, filename, mode) == 0) {
+        return file;
+    } else {
+        return TAU_NULL;
+    }
+#else
+    return fopen(filename, mode);
+#endif // _MSC_VER
+}
+
+// Open the binary result stream and write its header
+static int tauStreamBegin(const char* const path) {
+    FILE* const file = tau_fopen(path, "wb");
+    tauStreamHeaderStruct header;
+
+    if(TAU_NONE(file))
+        return 0;
+    if(!tauReportOpen(&tauStreamReport, file, path, TAU_NULL)) {
+        fclose(file);
+        return 0;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TAU_STREAM_MAGIC, sizeof(header.magic));
+    header.version = TAU_STREAM_VERSION;
+    header.byteOrder = TAU_STREAM_BYTE_ORDER;
+    tauReportWrite(&tauStreamReport, TAU_PTRCAST(const char*, &header), sizeof(header));
+    tauReportFlush(&tauStreamReport);
+    return 1;
+}
+
+
+static void tau_help_() {
+    printf("Usage: %s [options] [test...]\n", tau_argv0_);
+    printf("\n");
+    printf("Run the specified unit tests; or if the option '--skip' is used, run all\n");
+    printf("tests in the suite but those listed. By default, if no tests are specified\n");
+    printf("on the command line, all unit tests in the suite are run.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --failed-output-only     Output only failed Test Suites\n");
+    printf("  --filter=<filter>        Filter the test suites to run (e.g: Suite1*.a\n");
+    printf("                             would run Suite1Case.a but not Suite1Case.b).\n");
+    printf("                             Separate patterns with ':', and put the ones to\n");
+    printf("                             exclude after a '-' (e.g: A*:B.*-*Slow*)\n");
+    printf("  --time=TIMER             Time tests with the given clock: 'real' (monotonic,\n");
+#ifdef TAU_HAS_CYCLE_COUNTER_
+    printf("                             the default), 'cpu' (process CPU time) or 'cycles'\n");
+    printf("                             (the CPU's cycle counter, for very short tests)\n");
+#else
+    printf("                             the default) or 'cpu' (process CPU time)\n");
+#endif // TAU_HAS_CYCLE_COUNTER_
+#ifdef TAU_HAS_THREADS_
+    printf("  --jobs[=N]               Run tests concurrently on N worker threads\n");
+    printf("                             (defaults to the number of CPUs)\n");
+#endif // TAU_HAS_THREADS_
+#ifdef TAU_HAS_FORK_
+    printf("  --isolate                Run tests in a separate process, so that a crashing\n");
+    printf("                             test is reported as failed instead of ending the run\n");
+    printf("  --shards=N               Like --isolate, but spread tests over N processes\n");
+#endif // TAU_HAS_FORK_
+    printf("  --timeout=MS             Fail tests that take longer than MS milliseconds; see also\n");
+    printf("                             TEST_TIMEOUT()\n");
+    printf("  --max-failures-per-test=N\n");
+    printf("                           Report at most N failed assertions per test and only count\n");
+    printf("                             the rest (default: %d; 0 for no limit)\n", TAU_MAX_FAILURES_PER_TEST_);
+    printf("  --counters[=EVENTS]      Count hardware events while tests run (Linux only); EVENTS\n");
+    printf("                             is a comma-separated list of cycles, instructions,\n");
+    printf("                             cache-references, cache-misses, branches, branch-misses\n");
+    printf("                             and page-faults (default: " TAU_DEFAULT_COUNTERS_ ")\n");
+    printf("  --resources              Report the memory, page faults and context switches of\n");
+    printf("                             each test (Unix only)\n");
+    printf("  --top=N                  List the N heaviest tests by duration, assertions, resource\n");
+    printf("                             usage and allocations at the end of the summary\n");
+    printf("  --shard-index=I          With --shard-count, run only the I-th (from 0) of N\n");
+    printf("  --shard-count=N            shares of the tests, to split a run across machines\n");
+    printf("                             (default: $TAU_SHARD_INDEX and $TAU_TOTAL_SHARDS, or\n");
+    printf("                             $GTEST_SHARD_INDEX and $GTEST_TOTAL_SHARDS)\n");
+    printf("  --shard-by=MODE          Split tests by 'count' (the default), or by 'duration', as\n");
+    printf("                             recorded in the --durations file\n");
+    printf("  --shuffle[=SEED]         Run tests in a random order; the seed is printed, so that\n");
+    printf("                             the order can be reproduced\n");
+    printf("  --repeat=N               Run the tests N times, and report the tests that both\n");
+    printf("                             passed and failed as flaky\n");
+    printf("  --until-fail             Repeat the tests until one of them fails (at most N times\n");
+    printf("                             with --repeat=N)\n");
+    printf("  --durations=<FILE>       Record test durations in FILE; durations from a previous\n");
+    printf("                             run are used to schedule the longest tests first\n");
+    printf("  --bench-save=<FILE>      Save the samples of every benchmark that ran to FILE\n");
+    printf("  --bench-compare=<FILE>   Compare benchmarks against the samples saved in FILE, and\n");
+    printf("                             fail the run if any of them got significantly slower\n");
+    printf("  --bench-threshold=PCT    Slowdown (in percent) that counts as a regression (default: 5)\n");
+    printf("  --no-summary             Suppress printing of test results summary\n");
+    printf("  --output=<FILE>          Write an XUnit XML file to Enable XUnit output\n");
+    printf("                             to the given file\n");
+    printf("  --emit=bin:<FILE>        Write results to FILE in Tau's binary stream format\n");
+    printf("                             (convert it with TauConvert)\n");
+    printf("  --list                   List unit tests in the suite and exit\n");
+    printf("  --no-color               Disable coloured output\n");
+    printf("  --help                   Display this help and exit\n");
+}
+
+
+/**
+    Splitting a run across machines (`--shard-index=I --shard-count=N`)
+    Every machine runs the same binary with the same filter, and keeps only its own share of the tests that pass
+    the filter, so that between them the N machines run each of those tests exactly once. Shares are worked out
+    from the registry and (with `--shard-by=duration`) the `--durations` file alone, so every machine must be given
+    the same file:
+        count       The i-th test that passes the filter (in registration order) goes to share `i % N`
+        duration    Longest processing time first: tests are dealt out longest first (as recorded in the
+                    `--durations` file), each to the share with the least work so far. Tests without a recorded
+                    duration are taken to be as long as the average test that has one.
+
+    CI systems that split jobs across machines tend to pass the index and count in `TAU_SHARD_INDEX` and
+    `TAU_TOTAL_SHARDS` (or GoogleTest's `GTEST_SHARD_INDEX` and `GTEST_TOTAL_SHARDS`); the command line wins.
+*/
+typedef struct tauPartitionItemStruct {
+    tauTestSuiteStruct* test;
+    tau_i64 weight;
+} tauPartitionItemStruct;
+
+// Heaviest first, then in registration order
+static int tauComparePartitionItems(const void* const a, const void* const b) {
+    const tauPartitionItemStruct* const lhs = TAU_PTRCAST(const tauPartitionItemStruct*, a);
+    const tauPartitionItemStruct* const rhs = TAU_PTRCAST(const tauPartitionItemStruct*, b);
+
+    if(lhs->weight != rhs->weight)
+        return lhs->weight > rhs->weight ? -1 : 1;
+    return lhs->test->index < rhs->test->index ? -1 : (lhs->test->index > rhs->test->index ? 1 : 0);
+}
+
+// Read an index or count from the environment. Returns false if the variable is set, but not to a number.
+static tau_bool tauPartitionEnv(const char* const name, const char* const gtestName, tau_ull* const value,
+                                tau_bool* const found) {
+    const char* str = getenv(name);
+    char* end;
+
+    if(TAU_NONE(str))
+        str = getenv(gtestName);
+    if(TAU_NONE(str))
+        return tau_true;
+    *value = TAU_CAST(tau_ull, strtoull(str, &end, 10));
+    *found = tau_true;
+    if(!tauIsDigit(*str) || *end != TAU_NULLCHAR) {
+        printf("ERROR: Invalid value for %s: %s\n", TAU_SOME(getenv(name)) ? name : gtestName, str);
+        return tau_false;
+    }
+    return tau_true;
+}
+
+// Fill in whatever the command line didn't say about the split from the environment, and check it
+static tau_bool tauPartitionInit(const tau_bool haveIndex, const tau_bool haveCount) {
+    tau_bool foundIndex = haveIndex;
+    tau_bool foundCount = haveCount;
+    const char* statusFile;
+
+    if((!haveIndex && !tauPartitionEnv("TAU_SHARD_INDEX", "GTEST_SHARD_INDEX", &tauPartitionIndex, &foundIndex)) ||
+       (!haveCount && !tauPartitionEnv("TAU_TOTAL_SHARDS", "GTEST_TOTAL_SHARDS", &tauPartitionCount, &foundCount)))
+        return tau_false;
+    if(!foundIndex && !foundCount)
+        return tau_true;
+
+    if(!foundIndex || !foundCount) {
+        printf("ERROR: A shard needs both an index and a count\n");
+        return tau_false;
+    }
+    if(tauPartitionCount == 0 || tauPartitionIndex >= tauPartitionCount) {
+        printf("ERROR: Invalid shard: index %" TAU_PRIu64 " of %" TAU_PRIu64 " (expected an index below a count "
+               "greater than 0)\n", TAU_CAST(tau_u64, tauPartitionIndex), TAU_CAST(tau_u64, tauPartitionCount));
+        return tau_false;
+    }
+
+    // Tells GoogleTest-aware runners that the binary knows how to shard itself
+    statusFile = getenv("GTEST_SHARD_STATUS_FILE");
+    if(TAU_SOME(statusFile)) {
+        FILE* const file = tau_fopen(statusFile, "w");
+        if(TAU_SOME(file))
+            fclose(file);
+    }
+    return tau_true;
+}
+
+// Deselect the tests that belong to the other machines. Returns the number of tests left to run here.
+static tau_ull tauApplyPartition() {
+    tauPartitionItemStruct* items = TAU_NULL;
+    tau_u64* loads = TAU_NULL;
+    tau_ull numItems = 0;
+    tau_ull numSelected = 0;
+
+    if(tauPartitionByDuration) {
+        items = TAU_PTRCAST(tauPartitionItemStruct*, tauMalloc(sizeof(tauPartitionItemStruct) *
+                                                            (tauTestContext.numTestSuites + 1)));
+        loads = TAU_PTRCAST(tau_u64*, tauCalloc(tauPartitionCount, sizeof(tau_u64)));
+    }
+
+    if(TAU_SOME(items) && TAU_SOME(loads)) {
+        tau_i64 total = 0;
+        tau_i64 numKnown = 0;
+
+        for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+            if(!test->selected)
+                continue;
+            items[numItems].test = test;
+            items[numItems++].weight = test->result.previousDuration;
+            if(test->result.previousDuration >= 0) {
+                total += test->result.previousDuration;
+                numKnown++;
+            }
+        }
+        for(tau_ull i = 0; i < numItems; i++) {
+            if(items[i].weight < 0)
+                items[i].weight = numKnown > 0 ? total / numKnown : 1;
+            if(items[i].weight == 0)
+                items[i].weight = 1;    // Even instant tests should be spread out
+        }
+        qsort(items, numItems, sizeof(tauPartitionItemStruct), tauComparePartitionItems);
+
+        for(tau_ull i = 0; i < numItems; i++) {
+            tau_ull lightest = 0;
+            for(tau_ull share = 1; share < tauPartitionCount; share++) {
+                if(loads[share] < loads[lightest])
+                    lightest = share;
+            }
+            loads[lightest] += TAU_CAST(tau_u64, items[i].weight);
+            items[i].test->selected = lightest == tauPartitionIndex;
+            numSelected += items[i].test->selected ? 1 : 0;
+        }
+    } else {
+        if(tauPartitionByDuration)
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Out of memory; sharding tests by count\n");
+        for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+            if(!test->selected)
+                continue;
+            test->selected = numItems++ % tauPartitionCount == tauPartitionIndex;
+            numSelected += test->selected ? 1 : 0;
+        }
+    }
+
+    tauFree(TAU_PTRCAST(void*, items));
+    tauFree(TAU_PTRCAST(void*, loads));
+    return numSelected;
+}
+
+// Set up `tauCounterConfig` from a comma-separated list of event names
+static tau_bool tauParseCounters(const char* events) {
+    tauCounterConfig.numEvents = 0;
+    while(*events != TAU_NULLCHAR) {
+        const char* const comma = strchr(events, ',');
+        const tau_ull length = TAU_SOME(comma) ? TAU_CAST(tau_ull, comma - events) : strlen(events);
+        tau_ull event = 0;
+        int seen = 0;
+
+        while(event < TAU_NUM_COUNTER_EVENTS_ && (strlen(tauCounterEvents[event].name) != length ||
+                                                  strncmp(tauCounterEvents[event].name, events, length) != 0))
+            event++;
+        if(event == TAU_NUM_COUNTER_EVENTS_ || tauCounterConfig.numEvents == TAU_MAX_COUNTERS_)
+            return tau_false;
+        for(int i = 0; i < tauCounterConfig.numEvents; i++)
+            seen |= tauCounterConfig.events[i] == TAU_CAST(int, event);
+        if(!seen)
+            tauCounterConfig.events[tauCounterConfig.numEvents++] = TAU_CAST(int, event);
+
+        events += length;
+        if(*events == ',')
+            events++;
+    }
+    return tauCounterConfig.numEvents > 0;
+}
+
+static tau_bool tauCmdLineRead(const int argc, const char* const * const argv) {
+    // Coloured output
+#ifdef TAU_UNIX_
+    tauShouldColourizeOutput = isatty(STDOUT_FILENO);
+#elif defined TAU_WIN_
+    #ifdef _BORLANDC_
+        tauShouldColourizeOutput = isatty(_fileno(stdout));
+    #else
+        tauShouldColourizeOutput = _isatty(_fileno(stdout));
+    #endif // _BORLANDC_
+#else
+    tauShouldColourizeOutput = isatty(STDOUT_FILENO);
+#endif // TAU_UNIX_
+
+    tau_bool haveShardIndex = tau_false;
+    tau_bool haveRepeat = tau_false;
+    tau_bool haveShardCount = tau_false;
+
+    // loop through all arguments looking for our options
+    for(tau_ull i = 1; i < TAU_CAST(tau_ull, argc); i++) {
+        /* Informational switches */
+        const char* const helpStr = "--help";
+        const char* const listStr = "--list";
+        const char* const colourStr = "--no-color";
+        const char* const summaryStr = "--no-summary";
+        const char* const onlyFailedOutput = "--failed-output-only";
+        /* Test config switches */
+        const char* const filterStr = "--filter=";
+        const char* const XUnitOutput = "--output=";
+        const char* const jobsStr = "--jobs";
+        const char* const isolateStr = "--isolate";
+        const char* const shardsStr = "--shards=";
+        const char* const durationsStr = "--durations=";
+        const char* const emitStr = "--emit=";
+        const char* const timeStr = "--time";
+        const char* const countersStr = "--counters";
+        const char* const resourcesStr = "--resources";
+        const char* const topStr = "--top=";
+        const char* const timeoutStr = "--timeout=";
+        const char* const maxFailuresStr = "--max-failures-per-test=";
+        const char* const shardIndexStr = "--shard-index=";
+        const char* const shardCountStr = "--shard-count=";
+        const char* const shardByStr = "--shard-by=";
+        const char* const shuffleStr = "--shuffle";
+        const char* const repeatStr = "--repeat=";
+        const char* const untilFailStr = "--until-fail";
+        const char* const benchSaveStr = "--bench-save=";
+        const char* const benchCompareStr = "--bench-compare=";
+        const char* const benchThresholdStr = "--bench-threshold=";
+
+        // Help
+        if(strncmp(argv[i], helpStr, strlen(helpStr)) == 0) {
+            tau_help_();
+            return tau_false;
+        }
+
+        // Only failed output
+        else if(strncmp(argv[i], onlyFailedOutput, strlen(onlyFailedOutput)) == 0) {
+            tauDisplayOnlyFailedOutput = 1;
+        }
+
+        // Filter tests
+        else if(strncmp(argv[i], filterStr, strlen(filterStr)) == 0)
+            // user wants to filter what test suites run!
+            cmd_filter = argv[i] + strlen(filterStr);
+
+        // Test duration cache
+        else if(strncmp(argv[i], durationsStr, strlen(durationsStr)) == 0)
+            tauDurationsFile = argv[i] + strlen(durationsStr);
+
+        // Performance counters
+        else if(strncmp(argv[i], countersStr, strlen(countersStr)) == 0) {
+            const char* events = argv[i] + strlen(countersStr);
+            if(*events == TAU_NULLCHAR)
+                events = TAU_DEFAULT_COUNTERS_;
+            else if(*events++ != '=') {
+                printf("ERROR: Invalid value for --counters: %s\n", argv[i]);
+                return tau_false;
+            }
+            if(!tauParseCounters(events)) {
+                printf("ERROR: Invalid value for --counters: %s\n", argv[i]);
+                return tau_false;
+            }
+        }
+
+        // Resource usage
+        else if(strcmp(argv[i], resourcesStr) == 0) {
+        #ifdef TAU_UNIX_
+            tauMeasureResources = 1;
+        #else
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Resource usage isn't available on this platform; "
+                                                        "ignoring --resources\n");
+        #endif // TAU_UNIX_
+        }
+        else if(strncmp(argv[i], topStr, strlen(topStr)) == 0) {
+            const char* const value = argv[i] + strlen(topStr);
+            tauNumTopTests = TAU_CAST(tau_ull, strtoull(value, TAU_NULL, 10));
+            if(!tauIsDigit(*value) || tauNumTopTests == 0) {
+                printf("ERROR: Invalid value for --top: %s\n", argv[i]);
+                return tau_false;
+            }
+        }
+
+        // Split the tests across machines
+        else if(strncmp(argv[i], shardIndexStr, strlen(shardIndexStr)) == 0 ||
+                strncmp(argv[i], shardCountStr, strlen(shardCountStr)) == 0) {
+            const tau_bool isIndex = argv[i][strlen("--shard-")] == 'i';
+            const char* const value = argv[i] + strlen(isIndex ? shardIndexStr : shardCountStr);
+            char* end;
+            const tau_ull n = TAU_CAST(tau_ull, strtoull(value, &end, 10));
+            if(!tauIsDigit(*value) || *end != TAU_NULLCHAR) {
+                printf("ERROR: Invalid value for %s: %s\n", isIndex ? "--shard-index" : "--shard-count", argv[i]);
+                return tau_false;
+            }
+            if(isIndex) {
+                tauPartitionIndex = n;
+                haveShardIndex = tau_true;
+            } else {
+                tauPartitionCount = n;
+                haveShardCount = tau_true;
+            }
+        }
+        else if(strncmp(argv[i], shardByStr, strlen(shardByStr)) == 0) {
+            const char* const value = argv[i] + strlen(shardByStr);
+            if(strcmp(value, "count") == 0)
+                tauPartitionByDuration = 0;
+            else if(strcmp(value, "duration") == 0)
+                tauPartitionByDuration = 1;
+            else {
+                printf("ERROR: Invalid value for --shard-by: %s\n", argv[i]);
+                return tau_false;
+            }
+        }
+
+        // Test order and repetition
+        else if(strncmp(argv[i], shuffleStr, strlen(shuffleStr)) == 0) {
+            const char* value = argv[i] + strlen(shuffleStr);
+            char* end;
+            if(*value == TAU_NULLCHAR) {
+                // Keep generated seeds short enough to type back in
+                tauShuffleSeed = tauClockMonotonic() % 1000000;
+            } else {
+                if(*value++ != '=' || !tauIsDigit(*value)) {
+                    printf("ERROR: Invalid value for --shuffle: %s\n", argv[i]);
+                    return tau_false;
+                }
+                tauShuffleSeed = TAU_CAST(tau_u64, strtoull(value, &end, 10));
+                if(*end != TAU_NULLCHAR) {
+                    printf("ERROR: Invalid value for --shuffle: %s\n", argv[i]);
+                    return tau_false;
+                }
+            }
+            tauShuffle = 1;
+        }
+        else if(strncmp(argv[i], repeatStr, strlen(repeatStr)) == 0) {
+            const char* const value = argv[i] + strlen(repeatStr);
+            char* end;
+            tauNumRepeats = TAU_CAST(tau_u64, strtoull(value, &end, 10));
+            if(!tauIsDigit(*value) || *end != TAU_NULLCHAR || tauNumRepeats == 0) {
+                printf("ERROR: Invalid value for --repeat: %s\n", argv[i]);
+                return tau_false;
+            }
+            haveRepeat = tau_true;
+        }
+        else if(strcmp(argv[i], untilFailStr) == 0) {
+            tauUntilFail = 1;
+        }
+
+        // Per-test time limit
+        else if(strncmp(argv[i], timeoutStr, strlen(timeoutStr)) == 0) {
+            const char* const value = argv[i] + strlen(timeoutStr);
+            tauTimeout = TAU_CAST(tau_u64, strtoull(value, TAU_NULL, 10)) * 1000000;
+            if(!tauIsDigit(*value) || tauTimeout == 0) {
+                printf("ERROR: Invalid value for --timeout: %s\n", argv[i]);
+                return tau_false;
+            }
+        #ifndef TAU_HAS_THREADS_
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Tau was built without threads; ignoring --timeout\n");
+            tauTimeout = 0;
+        #endif // TAU_HAS_THREADS_
+        }
+
+        // Failure budget
+        else if(strncmp(argv[i], maxFailuresStr, strlen(maxFailuresStr)) == 0) {
+            const char* const value = argv[i] + strlen(maxFailuresStr);
+            char* end;
+            tauMaxFailuresPerTest = TAU_CAST(tau_u64, strtoull(value, &end, 10));
+            if(!tauIsDigit(*value) || *end != TAU_NULLCHAR) {
+                printf("ERROR: Invalid value for --max-failures-per-test: %s\n", argv[i]);
+                return tau_false;
+            }
+        }
+
+        // Benchmark baselines
+        else if(strncmp(argv[i], benchSaveStr, strlen(benchSaveStr)) == 0)
+            tauBenchSaveFile = argv[i] + strlen(benchSaveStr);
+        else if(strncmp(argv[i], benchCompareStr, strlen(benchCompareStr)) == 0)
+            tauBenchCompareFile = argv[i] + strlen(benchCompareStr);
+        else if(strncmp(argv[i], benchThresholdStr, strlen(benchThresholdStr)) == 0) {
+            char* end;
+            tauBenchThreshold = strtod(argv[i] + strlen(benchThresholdStr), &end);
+            if(end == argv[i] + strlen(benchThresholdStr) || *end != TAU_NULLCHAR || tauBenchThreshold < 0) {
+                printf("ERROR: Invalid value for --bench-threshold: %s\n", argv[i]);
+                return tau_false;
+            }
+        }
+
+        // Write XUnit XML file
+        else if(strncmp(argv[i], XUnitOutput, strlen(XUnitOutput)) == 0) {
+            tauXUnitPath = argv[i] + strlen(XUnitOutput);
+            tauTestContext.foutput = tau_fopen(tauXUnitPath, "w+");
+        }
+
+        // Clock to time tests with
+        else if(strncmp(argv[i], timeStr, strlen(timeStr)) == 0) {
+            const char* const value = argv[i] + strlen(timeStr);
+            if(*value == TAU_NULLCHAR || strcmp(value, "=real") == 0)
+                tauClockState.source = TAU_CLOCK_REAL_;
+            else if(strcmp(value, "=cpu") == 0)
+                tauClockState.source = TAU_CLOCK_CPU_;
+            else if(strcmp(value, "=cycles") == 0)
+                tauClockState.source = TAU_CLOCK_CYCLES_;
+            else {
+                printf("ERROR: Invalid value for --time: %s\n", argv[i]);
+                return tau_false;
+            }
+        }
+
+        // Write a binary result stream
+        else if(strncmp(argv[i], emitStr, strlen(emitStr)) == 0) {
+            const char* const value = argv[i] + strlen(emitStr);
+            if(strncmp(value, "bin:", 4) != 0 || value[4] == TAU_NULLCHAR) {
+                printf("ERROR: Invalid value for --emit (expected bin:<FILE>): %s\n", argv[i]);
+                return tau_false;
+            }
+            tauStreamPath = value + 4;
+        }
+
+        // List tests
+        else if(strncmp(argv[i], listStr, strlen(listStr)) == 0) {
+            for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next)
+                tauPrintf("%s\n", test->name);
+            tauDisplayTests = 1;
+        }
+
+        // Disable colouring
+        else if(strncmp(argv[i], colourStr, strlen(colourStr)) == 0) {
+            tauShouldColourizeOutput = 0;
+        }
+
+        // Disable Summary
+        else if(strncmp(argv[i], summaryStr, strlen(summaryStr)) == 0) {
+            tauDisableSummary = 1;
+        }
+
+        // Run tests on a pool of worker threads
+        else if(strncmp(argv[i], jobsStr, strlen(jobsStr)) == 0) {
+            const char* const value = argv[i] + strlen(jobsStr);
+            if(*value == TAU_NULLCHAR)
+                tauNumJobs = tauNumCPUs();
+            else if(*value == '=' && tauIsDigit(value[1]))
+                tauNumJobs = TAU_CAST(tau_ull, strtoull(value + 1, TAU_NULL, 10));
+            else {
+                printf("ERROR: Invalid value for --jobs: %s\n", argv[i]);
+                return tau_false;
+            }
+        #ifndef TAU_HAS_THREADS_
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Tau was built without threads; ignoring --jobs\n");
+            tauNumJobs = 1;
+        #endif // TAU_HAS_THREADS_
+        }
+
+        // Run tests in worker processes
+        else if(strcmp(argv[i], isolateStr) == 0 || strncmp(argv[i], shardsStr, strlen(shardsStr)) == 0) {
+            tau_ull shards = 1;
+            if(strcmp(argv[i], isolateStr) != 0) {
+                const char* const value = argv[i] + strlen(shardsStr);
+                char* end;
+                shards = TAU_CAST(tau_ull, strtoull(value, &end, 10));
+                if(!tauIsDigit(*value) || *end != TAU_NULLCHAR || shards == 0) {
+                    printf("ERROR: Invalid value for --shards: %s\n", argv[i]);
+                    return tau_false;
+                }
+            }
+        #ifdef TAU_HAS_FORK_
+            if(shards > tauNumShards)
+                tauNumShards = shards;
+        #else
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Process isolation is not supported on this platform; "
+                                                        "ignoring %s\n", argv[i]);
+        #endif // TAU_HAS_FORK_
+        }
+
+        else {
+            printf("ERROR: Unrecognized option: %s", argv[i]);
+            return tau_false;
+        }
+    }
+
+    if(tauPartitionByDuration && TAU_NONE(tauDurationsFile)) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: --shard-by=duration needs the --durations file of an "
+                                                    "earlier run; sharding tests by count\n");
+        tauPartitionByDuration = 0;
+    }
+    if(tauUntilFail && !haveRepeat)
+        tauNumRepeats = 0;
+    return tauPartitionInit(haveShardIndex, haveShardCount);
+}
+
+static int tauCleanup() {
+    if(tauTestContext.foutput)
+        fclose(tauTestContext.foutput);
+    if(tauStreamReport.file)
+        fclose(tauStreamReport.file);
+
+    tauFree(TAU_PTRCAST(void*, tauBenchBaseline));
+    tauBufferFree(&tauBenchResults);
+
+    return TAU_CAST(int, tauStatsNumTestsFailed + tauBenchNumRegressions);
+}
+
+// The failures a test didn't report because they were over its budget, by where they came from
+static void tauReportSuppressedFailures() {
+    const tauFailureBudgetStruct* const budget = &tauFailureBudget;
+    tau_u64 total = budget->elsewhere;
+
+    for(tau_u64 i = 0; i < budget->numSites; i++)
+        total += budget->sites[i].count;
+    if(total == 0)
+        return;
+
+    tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "%" TAU_PRIu64 " more failed assertions not shown", total);
+    tauPrintf(" (--max-failures-per-test=%" TAU_PRIu64 "):\n", tauMaxFailuresPerTest);
+    for(tau_u64 i = 0; i < budget->numSites; i++) {
+        const tauFailureSiteStruct* const site = &budget->sites[i];
+        tauPrintf("  %s:%u failed %" TAU_PRIu64 " more time%s\n", site->file, site->line, site->count,
+                  site->count == 1 ? "" : "s");
+    }
+    if(budget->elsewhere > 0)
+        tauPrintf("  (and %" TAU_PRIu64 " more elsewhere)\n", budget->elsewhere);
+}
+
+// Runs a single test on the calling thread and records its outcome in `test->result`
+static void tauRunTest(tauTestSuiteStruct* const test) {
+    checkIsInsideTestSuite = 1;
+    hasCurrentTestFailed = 0;
+    shouldFailTest = 0;
+    shouldAbortTest = 0;
+    memset(&tauFailureBudget, 0, sizeof(tauFailureBudget));
+    tauContextStack.depth = 0;
+
+    if(!tauDisplayOnlyFailedOutput) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[ RUN      ] ");
+        tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s\n", test->name);
+    }
+
+    if(tauCurrentCapture) {
+        tauCurrentCapture->currentTest = test;
+        if(tauCurrentCapture->streaming)
+            tauStreamTestStart(&tauCurrentCapture->events, test);
+    }
+
+    // A test that hangs or crashes should at least have been announced
+    if(tauCurrentCapture && tauCurrentCapture->live)
+        tauSinkFlush(tauCurrentCapture);
+
+    // Whatever the test prints from here on goes into its XUnit record
+    const tau_ull outputStart = tauCurrentCapture ? tauCurrentCapture->console.size : 0;
+    if(tauCurrentCapture)
+        tauCurrentCapture->failureMark = outputStart;
+
+    // Put the test under the watchdog's eye
+    tauWatchStruct* const watch = tauCurrentWatch;
+    if(watch) {
+        watch->test = test;
+        watch->capture = tauCurrentCapture;
+        watch->outputStart = outputStart;
+        TAU_ATOMIC_STORE64(&watch->limit, tauTimeout);
+        TAU_ATOMIC_STORE64(&watch->start, tauClockMonotonic());
+        TAU_ATOMIC_CAS(&watch->state, TAU_WATCH_IDLE_, TAU_WATCH_RUNNING_);
+    }
+
+    // Start the counters and the timer
+    tau_i64 resources[TAU_NUM_RESOURCES_];
+    const tau_bool measuring = tauMeasureResources && tauResourcesSample(resources);
+    const tauAllocStatsStruct allocs = tauAllocStats;
+    tauAllocStats.peak = tauAllocStats.live;
+    const tau_u64 assertions = tauAssertionCount;
+    const tau_bool counting = tauCountersStart();
+    const tau_u64 start = tauClock();
+
+    // The actual test
+    test->func();
+
+    // Stop the timer and the counters
+    const tau_u64 duration = tauClockSince(start);
+    test->result.numCounters = counting ? tauCountersStop(test->result.counters) : 0;
+    if(watch) {
+        // If the watchdog just now gave up on the test, it is ending the process, so wait for that to happen
+        while(!TAU_ATOMIC_CAS(&watch->state, TAU_WATCH_RUNNING_, TAU_WATCH_IDLE_))
+            tauSleep(1);
+    }
+    tauReportSuppressedFailures();
+    test->result.assertions = tauAssertionCount - assertions;
+    test->result.allocs = tauAllocStats.allocs - allocs.allocs;
+    test->result.allocBytes = tauAllocStats.bytes - allocs.bytes;
+    test->result.peakBytes = tauAllocStats.peak - allocs.live;
+    test->result.leakedBytes = tauAllocStats.live - allocs.live;
+    test->result.hasResources = measuring && tauResourcesSample(test->result.resources);
+    for(int i = 0; i < TAU_NUM_RESOURCES_ && test->result.hasResources; i++)
+        test->result.resources[i] -= resources[i];
+
+    test->result.duration = duration;
+    test->result.status = hasCurrentTestFailed == 1 ? TAU_TEST_FAILED_ : TAU_TEST_PASSED_;
+    if(tauTestContext.foutput && tauCurrentCapture) {
+        tauXUnitTestCase(&tauCurrentCapture->file, test, tauCurrentCapture->console.data + outputStart,
+                         tauCurrentCapture->console.size - outputStart);
+    }
+    if(tauCurrentCapture && tauCurrentCapture->streaming)
+        tauStreamTestEnd(&tauCurrentCapture->events, test);
+
+    if(test->result.status == TAU_TEST_FAILED_) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "[  FAILED  ] ");
+        tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s (", test->name);
+        tauClockPrintDuration(duration);
+        tauConsolePrintf(")\n");
+    } else {
+        if(!tauDisplayOnlyFailedOutput) {
+            tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[       OK ] ");
+            tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s (", test->name);
+            tauClockPrintDuration(duration);
+            tauConsolePrintf(")\n");
+        }
+    }
+    if(test->result.numCounters > 0 && (test->result.status == TAU_TEST_FAILED_ || !tauDisplayOnlyFailedOutput)) {
+        tauMetricsStruct metrics;
+        tauCounterTestMetrics(&metrics, &test->result);
+        tauCountersPrint(&metrics, tau_false);
+    }
+    if(test->result.hasResources && (test->result.status == TAU_TEST_FAILED_ || !tauDisplayOnlyFailedOutput))
+        tauResourcesPrint(test->result.resources);
+}
+
+/**
+    Test duration cache (`--durations=<FILE>`)
+    One line per test: the duration of its last run (in nanoseconds), followed by its name. The parallel runner
+    uses this to start the longest tests first, so that a handful of slow tests at the end of the registry don't
+    leave most workers idle while they finish.
+*/
+typedef struct tauDurationEntryStruct {
+    const char* name;
+    tau_i64 duration;
+} tauDurationEntryStruct;
+
+static int tauCompareDurationEntries(const void* const a, const void* const b) {
+    return strcmp(TAU_PTRCAST(const tauDurationEntryStruct*, a)->name,
+                  TAU_PTRCAST(const tauDurationEntryStruct*, b)->name);
+}
+
+// Read all of a file into a NUL-terminated, malloc'ed buffer. Returns TAU_NULL if it doesn't exist or is empty.
+static char* tauReadFile(const char* const path, tau_ull* const size) {
+    FILE* const file = tau_fopen(path, "rb");
+    char* contents = TAU_NULL;
+    long length;
+
+    *size = 0;
+    if(TAU_NONE(file))
+        return TAU_NULL;
+
+    if(fseek(file, 0, SEEK_END) == 0 && (length = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        contents = TAU_PTRCAST(char*, tauMalloc(TAU_CAST(tau_ull, length) + 1));
+        if(TAU_SOME(contents)) {
+            *size = fread(contents, 1, TAU_CAST(tau_ull, length), file);
+            contents[*size] = TAU_NULLCHAR;
+        }
+    }
+    fclose(file);
+    return contents;
+}
+
+static void tauLoadDurations() {
+    char* contents = TAU_NULL;
+    tauDurationEntryStruct* entries = TAU_NULL;
+    tau_ull size = 0;
+    tau_ull numEntries = 0;
+
+    for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next)
+        test->result.previousDuration = -1;
+
+    // A missing cache file is not an error: this is simply the first run
+    if(TAU_NONE(tauDurationsFile) || TAU_NONE(contents = tauReadFile(tauDurationsFile, &size)))
+        return;
+
+    // Every line holds at least 3 characters, which bounds the number of entries
+    entries = TAU_PTRCAST(tauDurationEntryStruct*, tauMalloc(sizeof(tauDurationEntryStruct) * (size / 3 + 1)));
+    if(TAU_SOME(entries)) {
+        char* line = contents;
+        while(*line != TAU_NULLCHAR) {
+            char* const eol = strchr(line, '\n');
+            char* name;
+            const tau_i64 duration = TAU_CAST(tau_i64, strtoll(line, &name, 10));
+
+            if(TAU_SOME(eol))
+                *eol = TAU_NULLCHAR;
+            if(name != line && *name == ' ' && name[1] != TAU_NULLCHAR) {
+                entries[numEntries].name = name + 1;
+                entries[numEntries].duration = duration;
+                numEntries++;
+            }
+            if(TAU_NONE(eol))
+                break;
+            line = eol + 1;
+        }
+
+        qsort(entries, numEntries, sizeof(tauDurationEntryStruct), tauCompareDurationEntries);
+        for(tauTestSuiteStruct* test = tauTestContext.tests; test && numEntries > 0; test = test->next) {
+            tauDurationEntryStruct key;
+            const tauDurationEntryStruct* found;
+
+            key.name = test->name;
+            found = TAU_PTRCAST(const tauDurationEntryStruct*,
+                                bsearch(&key, entries, numEntries, sizeof(tauDurationEntryStruct),
+                                        tauCompareDurationEntries));
+            if(TAU_SOME(found))
+                test->result.previousDuration = found->duration;
+        }
+    }
+
+    tauFree(TAU_PTRCAST(void*, entries));
+    tauFree(TAU_PTRCAST(void*, contents));
+}
+
+// Tests that didn't run this time (e.g. they were filtered out) keep their previously recorded duration
+static void tauSaveDurations() {
+    const tau_ull length = strlen(tauDurationsFile);
+    char* const tmpName = TAU_PTRCAST(char*, tauMalloc(length + 5));
+    FILE* file;
+
+    if(TAU_NONE(tmpName))
+        return;
+
+    // Write to a temporary file first, so that an interrupted run never leaves a truncated cache behind
+    memcpy(tmpName, tauDurationsFile, length);
+    memcpy(tmpName + length, ".tmp", 5);
+
+    file = tau_fopen(tmpName, "wb");
+    if(TAU_SOME(file)) {
+        for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+            const tauTestResultStruct* const result = &test->result;
+            const tau_i64 duration = result->status != TAU_TEST_NOT_RUN_ ? TAU_CAST(tau_i64, result->duration)
+                                                                         : result->previousDuration;
+            if(duration >= 0)
+                fprintf(file, "%" TAU_PRIu64 " %s\n", TAU_CAST(tau_u64, duration), test->name);
+        }
+        if(fclose(file) == 0) {
+            remove(tauDurationsFile);
+            rename(tmpName, tauDurationsFile);
+        }
+    }
+    tauFree(TAU_PTRCAST(void*, tmpName));
+}
+
+/**
+    Benchmark baselines (`--bench-save=<FILE>`, `--bench-compare=<FILE>`)
+    One line per benchmark: its name and number of samples, followed by the samples themselves (time per
+    operation, in nanoseconds). A benchmark has regressed if its median got slower by more than
+    `--bench-threshold` percent, and a Mann-Whitney U test says that its samples differ from the baseline's at the
+    5% significance level (which keeps noisy benchmarks from failing the run on their own).
+*/
+#define TAU_BENCH_FILE_HEADER_      "# Tau benchmark samples (ns/op)\n"
+#define TAU_BENCH_CRITICAL_Z_       1.959964    // Two-sided, 5%
+
+typedef struct tauBenchEntryStruct {
+    const char* name;
+    double* samples;            // Sorted
+    tau_ull numSamples;
+} tauBenchEntryStruct;
+
+typedef struct tauRankedSampleStruct {
+    double value;
+    int fromBaseline;
+} tauRankedSampleStruct;
+
+static int tauCompareBenchEntries(const void* const a, const void* const b) {
+    return strcmp(TAU_PTRCAST(const tauBenchEntryStruct*, a)->name, TAU_PTRCAST(const tauBenchEntryStruct*, b)->name);
+}
+
+static int tauCompareRankedSamples(const void* const a, const void* const b) {
+    return tauCompareDoubles(&TAU_PTRCAST(const tauRankedSampleStruct*, a)->value,
+                             &TAU_PTRCAST(const tauRankedSampleStruct*, b)->value);
+}
+
+// Parse (in place) the lines of a samples file. `entries` and `samples` must hold `strlen(text) / 2 + 1` elements.
+// The entries come out sorted by name.
+static tau_ull tauBenchParse(char* text, tauBenchEntryStruct* const entries, double* samples) {
+    tau_ull numEntries = 0;
+
+    while(*text != TAU_NULLCHAR) {
+        char* const eol = strchr(text, '\n');
+        char* const space = strchr(text, ' ');
+
+        if(TAU_SOME(eol))
+            *eol = TAU_NULLCHAR;
+        if(*text != '#' && TAU_SOME(space) && space != text) {
+            char* pos;
+            const tau_ull count = TAU_CAST(tau_ull, strtoull(space + 1, &pos, 10));
+            tau_ull found = 0;
+
+            *space = TAU_NULLCHAR;
+            for(; found < count; found++) {
+                char* end;
+                samples[found] = strtod(pos, &end);
+                if(end == pos)
+                    break;
+                pos = end;
+            }
+            if(count > 0 && found == count) {
+                entries[numEntries].name = text;
+                entries[numEntries].samples = samples;
+                entries[numEntries].numSamples = count;
+                qsort(samples, count, sizeof(double), tauCompareDoubles);
+                samples += count;
+                numEntries++;
+            }
+        }
+        if(TAU_NONE(eol))
+            break;
+        text = eol + 1;
+    }
+
+    qsort(entries, numEntries, sizeof(tauBenchEntryStruct), tauCompareBenchEntries);
+    return numEntries;
+}
+
+// Mann-Whitney U test (normal approximation, corrected for ties). Returns the z-score, which is positive if
+// `current` tends to be larger (slower) than `baseline`.
+static double tauMannWhitneyZ(const tauBenchEntryStruct* const baseline, const tauBenchEntryStruct* const current) {
+    const tau_ull n1 = current->numSamples;
+    const tau_ull n2 = baseline->numSamples;
+    const tau_ull n = n1 + n2;
+    tauRankedSampleStruct* const all = TAU_PTRCAST(tauRankedSampleStruct*,
+        tauMalloc(sizeof(tauRankedSampleStruct) * n));
+    double rankSum = 0;
+    double ties = 0;
+    double u, mean, variance;
+
+    if(TAU_NONE(all))
+        return 0;
+    for(tau_ull i = 0; i < n1; i++) {
+        all[i].value = current->samples[i];
+        all[i].fromBaseline = 0;
+    }
+    for(tau_ull i = 0; i < n2; i++) {
+        all[n1 + i].value = baseline->samples[i];
+        all[n1 + i].fromBaseline = 1;
+    }
+    qsort(all, n, sizeof(tauRankedSampleStruct), tauCompareRankedSamples);
+
+    // Tied values all get the average of their ranks
+    for(tau_ull i = 0; i < n;) {
+        tau_ull j = i + 1;
+        while(j < n && all[j].value == all[i].value)
+            j++;
+        for(tau_ull k = i; k < j; k++) {
+            if(!all[k].fromBaseline)
+                rankSum += TAU_CAST(double, i + j + 1) / 2;
+        }
+        ties += TAU_CAST(double, j - i) * TAU_CAST(double, j - i) * TAU_CAST(double, j - i) -
+                TAU_CAST(double, j - i);
+        i = j;
+    }
+    tauFree(TAU_PTRCAST(void*, all));
+
+    u = rankSum - TAU_CAST(double, n1) * TAU_CAST(double, n1 + 1) / 2;
+    mean = TAU_CAST(double, n1) * TAU_CAST(double, n2) / 2;
+    variance = TAU_CAST(double, n1) * TAU_CAST(double, n2) / 12 *
+               (TAU_CAST(double, n + 1) - ties / (TAU_CAST(double, n) * TAU_CAST(double, n - 1)));
+    return variance > 0 ? (u - mean) / tauSqrt(variance) : 0;
+}
+
+// Compare the benchmarks that ran against `tauBenchBaseline`, in registration order
+static void tauBenchCompare() {
+    const tau_ull baselineSize = strlen(tauBenchBaseline);
+    char* const current = TAU_PTRCAST(char*, tauMalloc(tauBenchResults.size + 1));
+    tauBenchEntryStruct* const entries = TAU_PTRCAST(tauBenchEntryStruct*,
+        tauMalloc(sizeof(tauBenchEntryStruct) * ((baselineSize + tauBenchResults.size) / 2 + 2)));
+    double* const samples = TAU_PTRCAST(double*,
+        tauMalloc(sizeof(double) * ((baselineSize + tauBenchResults.size) / 2 + 2)));
+    tau_ull numBaseline, numCurrent;
+
+    if(TAU_NONE(current) || TAU_NONE(entries) || TAU_NONE(samples)) {
+        tauFree(TAU_PTRCAST(void*, current));
+        tauFree(TAU_PTRCAST(void*, entries));
+        tauFree(TAU_PTRCAST(void*, samples));
+        return;
+    }
+    if(tauBenchResults.size > 0)
+        memcpy(current, tauBenchResults.data, tauBenchResults.size);
+    current[tauBenchResults.size] = TAU_NULLCHAR;
+
+    numBaseline = tauBenchParse(tauBenchBaseline, entries, samples);
+    numCurrent = tauBenchParse(current, entries + numBaseline, samples + baselineSize / 2 + 1);
+
+    tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[==========] ");
+    tauColouredPrintf(TAU_COLOUR_DEFAULT_, "Comparing %" TAU_PRIu64 " benchmarks against %s (threshold %.1f%%)\n",
+                      TAU_CAST(tau_u64, numCurrent), tauBenchCompareFile, tauBenchThreshold);
+
+    for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        tauBenchEntryStruct key;
+        const tauBenchEntryStruct* now;
+        const tauBenchEntryStruct* before;
+        double medianBefore, medianNow, change, z;
+        int significant;
+
+        key.name = test->name;
+        now = TAU_PTRCAST(const tauBenchEntryStruct*, bsearch(&key, entries + numBaseline, numCurrent,
+                                                              sizeof(tauBenchEntryStruct), tauCompareBenchEntries));
+        if(TAU_NONE(now))
+            continue;
+        before = TAU_PTRCAST(const tauBenchEntryStruct*, bsearch(&key, entries, numBaseline,
+                                                                 sizeof(tauBenchEntryStruct), tauCompareBenchEntries));
+        if(TAU_NONE(before)) {
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "[   NEW    ] ");
+            tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s (not in the baseline)\n", test->name);
+            continue;
+        }
+
+        medianBefore = before->samples[before->numSamples / 2];
+        medianNow = now->samples[now->numSamples / 2];
+        change = medianBefore > 0 ? (medianNow - medianBefore) / medianBefore * 100 : 0;
+        z = tauMannWhitneyZ(before, now);
+        significant = z > TAU_BENCH_CRITICAL_Z_ || z < -TAU_BENCH_CRITICAL_Z_;
+
+        if(significant && change > tauBenchThreshold) {
+            tauBenchNumRegressions++;
+            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "[  SLOWER  ] ");
+        } else if(significant && change < -tauBenchThreshold) {
+            tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[  FASTER  ] ");
+        } else {
+            tauColouredPrintf(TAU_COLOUR_DEFAULT_, "[   SAME   ] ");
+        }
+        tauConsolePrintf("%s: median ", test->name);
+        tauBenchPrintTime(medianBefore);
+        tauConsolePrintf(" -> ");
+        tauBenchPrintTime(medianNow);
+        tauConsolePrintf(" (%+.1f%%, z = %.2f)\n", change, z);
+    }
+
+    if(tauBenchNumRegressions > 0) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "[  FAILED  ] %" TAU_PRIu64 " %s regressed\n",
+                          tauBenchNumRegressions, tauBenchNumRegressions == 1 ? "benchmark" : "benchmarks");
+    }
+
+    tauFree(TAU_PTRCAST(void*, current));
+    tauFree(TAU_PTRCAST(void*, entries));
+    tauFree(TAU_PTRCAST(void*, samples));
+}
+
+static void tauBenchSave() {
+    FILE* const file = tau_fopen(tauBenchSaveFile, "wb");
+    if(TAU_NONE(file)) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Could not open %s for writing\n", tauBenchSaveFile);
+        return;
+    }
+    fputs(TAU_BENCH_FILE_HEADER_, file);
+    fwrite(tauBenchResults.data, 1, tauBenchResults.size, file);
+    fclose(file);
+}
+
+// Report a test that never got to finish (its worker crashed, or it timed out): `reason` is all we know about
+// why it failed, followed by `details` (if any) in the console output and the XUnit file. The test may have
+// printed `output` before that, which has been written out already but still goes into its XUnit record; and if
+// `started`, its start (and the failures it reported) are in the binary stream already.
+static void tauReportLostTest(tauTestSuiteStruct* const test, const tau_u64 duration, const char* const reason,
+                              const char* const details, const tau_ull detailsSize, const char* const output,
+                              const tau_ull outputSize, const tau_bool started) {
+    tauBufferStruct text = { TAU_NULL, 0, 0 };
+
+    test->result.status = TAU_TEST_FAILED_;
+    test->result.duration = duration;
+    test->result.numCounters = 0;
+    test->result.assertions = 0;
+    test->result.allocs = 0;
+    test->result.allocBytes = 0;
+    test->result.peakBytes = 0;
+    test->result.leakedBytes = 0;
+    test->result.hasResources = 0;
+
+    tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "[  FAILED  ] ");
+    tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s (%s)\n", test->name, reason);
+    tauBufferPrintf(&text, "%s\n", reason);
+    if(detailsSize > 0) {
+        printf("%.*s", TAU_CAST(int, detailsSize), details);
+        tauBufferAppend(&text, details, detailsSize);
+    }
+    if(tauTestContext.foutput) {
+        tauBufferStruct all;
+        tauBufferStruct element;
+        memset(&all, 0, sizeof(all));
+        memset(&element, 0, sizeof(element));
+        if(outputSize > 0)
+            tauBufferAppend(&all, output, outputSize);
+        tauBufferAppend(&all, text.data, text.size);
+        tauXUnitTestCase(&element, test, all.data, all.size);
+        tauReportWrite(&tauXUnitReport, element.data, element.size);
+        tauBufferFree(&element);
+        tauBufferFree(&all);
+    }
+    if(tauStreamReport.open) {
+        tauBufferStruct events;
+        tauStreamAssertionFailureStruct failure;
+
+        memset(&events, 0, sizeof(events));
+        memset(&failure, 0, sizeof(failure));
+        failure.test = test->index;
+        failure.line = TAU_CAST(tau_u32, test->line);
+        failure.fileSize = TAU_CAST(tau_u32, strlen(test->file));
+        failure.messageSize = TAU_CAST(tau_u32, text.size - 1);       // Without the final newline
+        if(!started)
+            tauStreamTestStart(&events, test);
+        tauStreamAppendRecord(&events, TAU_STREAM_ASSERTION_FAILURE, &failure, sizeof(failure), test->file,
+                              failure.fileSize, text.data, failure.messageSize);
+        tauStreamTestEnd(&events, test);
+        tauReportWrite(&tauStreamReport, events.data, events.size);
+        tauBufferFree(&events);
+    }
+    tauBufferFree(&text);
+}
+
+#ifdef TAU_HAS_FORK_
+static void tauShardWorkerTimeout(const int fd, const tau_u64 limit, const tauCaptureStruct* const capture,
+                                  const tau_ull outputStart, const tauBufferStruct* const stack);
+static void tauShardWorkerExit(const int status);
+#endif // TAU_HAS_FORK_
+
+/**
+    Watchdog (`--timeout=<ms>`, `TEST_TIMEOUT(ms)`)
+    Every thread that runs tests publishes the test it is in the middle of through `tauCurrentWatch`, and a
+    watchdog thread (started once there is a limit to enforce) looks at all of them every `TAU_WATCHDOG_INTERVAL_`
+    milliseconds. Limits are enforced on the monotonic clock, whatever `--time` says: a test that hangs is stuck
+    in wall time.
+
+    There is no getting a thread back from a test that has gone past its limit, so the watchdog dumps its stack (on
+    Unix, by interrupting its thread with `TAU_WATCHDOG_SIGNAL_`), reports it as failed (along with whatever it had
+    reported so far) and ends the process. In an
+    `--isolate`/`--shards` worker, that only ends the worker, and the parent carries on with a fresh one; otherwise
+    the rest of the run is abandoned.
+*/
+#define TAU_WATCHDOG_INTERVAL_      10
+#define TAU_WATCHDOG_MAX_FRAMES_    64
+#define TAU_WATCHDOG_SIGNAL_        SIGUSR2
+
+typedef struct tauWatchdogStruct {
+#ifdef TAU_HAS_THREADS_
+    tau_thread_t thread;
+    tau_mutex_t* outputLock;    // Held by `--jobs` workers while they emit the output of a test
+#endif // TAU_HAS_THREADS_
+    volatile int launched;      // Whether the thread has been started (or tried to be)
+    volatile int running;
+    tauWatchStruct* watches;    // One for each thread that runs tests
+    tau_ull numWatches;
+    int shardFd;                // The pipe to the parent, in an `--isolate`/`--shards` worker; -1 otherwise
+} tauWatchdogStruct;
+
+static tauWatchdogStruct tauWatchdog;
+
+#ifdef TAU_HAS_BACKTRACE_
+static void* tauWatchdogFrames[TAU_WATCHDOG_MAX_FRAMES_];
+static volatile int tauWatchdogNumFrames = -1;
+
+// Runs on the thread of the test that timed out
+static void tauWatchdogStackHandler(int sig) {
+    (void)sig;
+    tauWatchdogNumFrames = backtrace(tauWatchdogFrames, TAU_WATCHDOG_MAX_FRAMES_);
+}
+#endif // TAU_HAS_BACKTRACE_
+
+// Append the stack of the thread `watch` belongs to (if we can get it) to `out`
+static void tauWatchdogCaptureStack(const tauWatchStruct* const watch, tauBufferStruct* const out) {
+#ifdef TAU_HAS_BACKTRACE_
+    char** symbols;
+
+    // Make sure `backtrace()` has loaded what it needs before it runs in a signal handler
+    backtrace(tauWatchdogFrames, 1);
+    tauWatchdogNumFrames = -1;
+    signal(TAU_WATCHDOG_SIGNAL_, tauWatchdogStackHandler);
+    if(pthread_kill(watch->thread, TAU_WATCHDOG_SIGNAL_) != 0)
+        return;
+    for(int i = 0; i < 100 && tauWatchdogNumFrames < 0; i++)
+        tauSleep(10);
+    if(tauWatchdogNumFrames <= 1)
+        return;
+
+    // Leave out the signal handler itself
+    symbols = backtrace_symbols(tauWatchdogFrames + 1, tauWatchdogNumFrames - 1);
+    if(TAU_NONE(symbols))
+        return;
+    tauBufferPrintf(out, "Stack of the test when it timed out:\n");
+    for(int i = 0; i < tauWatchdogNumFrames - 1; i++)
+        tauBufferPrintf(out, "    #%-2d %s\n", i, symbols[i]);
+    tauFree(TAU_PTRCAST(void*, symbols));
+#else
+    (void)watch;
+    (void)out;
+#endif // TAU_HAS_BACKTRACE_
+}
+
+// Give up on the test `watch` belongs to. Never returns.
+static void tauWatchdogExpire(tauWatchStruct* const watch) {
+    tauTestSuiteStruct* const test = watch->test;
+    tauCaptureStruct* const capture = watch->capture;
+    const tau_u64 limit = TAU_ATOMIC_LOAD64(&watch->limit);
+    tauBufferStruct stack = { TAU_NULL, 0, 0 };
+    char reason[64];
+
+    tauWatchdogCaptureStack(watch, &stack);
+
+#ifdef TAU_HAS_FORK_
+    if(tauWatchdog.shardFd >= 0) {
+        tauShardWorkerTimeout(tauWatchdog.shardFd, limit, capture, watch->outputStart, &stack);
+        tauShardWorkerExit(1);
+    }
+#endif // TAU_HAS_FORK_
+
+#ifdef TAU_HAS_THREADS_
+    // Other workers may be emitting the output of their tests
+    if(TAU_SOME(tauWatchdog.outputLock))
+        tauMutexLock(tauWatchdog.outputLock);
+#endif // TAU_HAS_THREADS_
+
+    // Whatever the test reported before it hung comes out first (on a `--jobs` worker, that includes the line that
+    // announces it). The test isn't coming back, so its sink is ours now.
+    if(TAU_SOME(capture))
+        tauSinkWriteThrough(capture);
+    TAU_SNPRINTF(reason, sizeof(reason), "timed out after %" TAU_PRIu64 "ms", limit / 1000000);
+    if(TAU_SOME(capture)) {
+        tauReportLostTest(test, limit, reason, stack.data, stack.size, capture->console.data + watch->outputStart,
+                          capture->console.size - watch->outputStart, TAU_CAST(tau_bool, capture->streaming));
+    } else {
+        tauReportLostTest(test, limit, reason, stack.data, stack.size, TAU_NULL, 0, tau_false);
+    }
+
+    tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED: ");
+    printf("%s %s; abandoning the rest of the run\n", test->name, reason);
+    if(tauXUnitReport.open)
+        tauXUnitEndWithCounts(tau_true);
+    if(tauStreamReport.open)
+        tauReportClose(&tauStreamReport);
+    fflush(stdout);
+    _exit(1);
+}
+
+#ifdef TAU_HAS_THREADS_
+// Whether the test `watch` belongs to has a time limit, and has gone over it by `now`
+static int tauWatchOverdue(tauWatchStruct* const watch, const tau_u64 now) {
+    const tau_u64 limit = TAU_ATOMIC_LOAD64(&watch->limit);
+    return limit > 0 && now - TAU_ATOMIC_LOAD64(&watch->start) > limit;
+}
+
+static tau_thread_result_t TAU_THREAD_CALL tauWatchdogMain(void* const arg) {
+    (void)arg;
+    while(TAU_ATOMIC_LOAD(&tauWatchdog.running)) {
+        tau_u64 now;
+
+        tauSleep(TAU_WATCHDOG_INTERVAL_);
+        now = tauClockMonotonic();
+        for(tau_ull i = 0; i < tauWatchdog.numWatches; i++) {
+            tauWatchStruct* const watch = &tauWatchdog.watches[i];
+            if(TAU_ATOMIC_LOAD(&watch->state) != TAU_WATCH_RUNNING_ || !tauWatchOverdue(watch, now) ||
+               !TAU_ATOMIC_CAS(&watch->state, TAU_WATCH_RUNNING_, TAU_WATCH_EXPIRED_))
+                continue;
+
+            // The test may have finished (and the next one started) since we looked; its thread is waiting for us
+            // to decide, so this time the answer is final
+            if(!tauWatchOverdue(watch, tauClockMonotonic())) {
+                TAU_ATOMIC_STORE(&watch->state, TAU_WATCH_RUNNING_);
+                continue;
+            }
+            tauWatchdogExpire(watch);
+        }
+    }
+    return 0;
+}
+#endif // TAU_HAS_THREADS_
+
+// Start the watchdog thread, unless that has been done (or tried) already
+static void tauWatchdogLaunch(void) {
+#ifdef TAU_HAS_THREADS_
+    if(!TAU_ATOMIC_CAS(&tauWatchdog.launched, 0, 1))
+        return;
+    TAU_ATOMIC_STORE(&tauWatchdog.running, 1);
+    if(!tauThreadCreate(&tauWatchdog.thread, tauWatchdogMain, TAU_NULL)) {
+        TAU_ATOMIC_STORE(&tauWatchdog.running, 0);
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Could not start the watchdog; ignoring time limits\n");
+    }
+#endif // TAU_HAS_THREADS_
+}
+
+// Keep an eye on `watches` (one for each thread that is about to run tests), until `tauWatchdogStop()`. Without
+// `--timeout`, the watchdog thread is only started by the first `TEST_TIMEOUT()`.
+static void tauWatchdogStart(tauWatchStruct* const watches, const tau_ull numWatches, const int shardFd) {
+    memset(&tauWatchdog, 0, sizeof(tauWatchdog));
+    tauWatchdog.watches = watches;
+    tauWatchdog.numWatches = numWatches;
+    tauWatchdog.shardFd = shardFd;
+    if(tauTimeout > 0)
+        tauWatchdogLaunch();
+}
+
+static void tauWatchdogStop() {
+#ifdef TAU_HAS_THREADS_
+    if(TAU_ATOMIC_LOAD(&tauWatchdog.running)) {
+        TAU_ATOMIC_STORE(&tauWatchdog.running, 0);
+        tauThreadJoin(tauWatchdog.thread);
+    }
+#endif // TAU_HAS_THREADS_
+}
+
+// Backs `TEST_TIMEOUT()`
+static inline void tauWatchSetLimit(const tau_u64 ms) {
+    if(TAU_NONE(tauCurrentWatch))
+        return;
+    TAU_ATOMIC_STORE64(&tauCurrentWatch->limit, ms * 1000000);
+    tauCurrentWatch->launch();
+}
+
+// Let the watchdog see the tests the calling thread runs
+static void tauWatchAttach(tauWatchStruct* const watch) {
+    watch->launch = tauWatchdogLaunch;
+#if defined(TAU_HAS_THREADS_) && defined(TAU_UNIX_)
+    watch->thread = pthread_self();
+#endif // TAU_HAS_THREADS_
+    tauCurrentWatch = watch;
+}
+
+#ifdef TAU_HAS_THREADS_
+/**
+    Work-stealing scheduler for `--jobs`
+    The run queue is ordered longest-first (by the durations recorded in the `--durations` file, if any; tests
+    without a recorded duration go first, in registration order) and dealt round-robin onto one deque per worker.
+    A worker takes tests from the front of its own deque and, once that is empty, steals from the back of the
+    fullest deque of another worker.
+
+    A finished test's output (and XUnit record) is emitted in one go while holding `tauOutputLock`.
+*/
+typedef struct tauWorkerStruct {
+    tau_thread_t thread;
+    tau_mutex_t lock;
+    tauTestSuiteStruct** tests; // Longest first
+    tau_ull head;
+    tau_ull tail;
+} tauWorkerStruct;
+
+static tau_mutex_t tauOutputLock;
+static tauWorkerStruct* tauWorkers = TAU_NULL;
+static tau_ull tauNumWorkers = 0;
+
+// Orders tests by their expected duration (longest first), then by registration order
+static int tauCompareExpectedDurations(const void* const a, const void* const b) {
+    const tauTestSuiteStruct* const lhsTest = *TAU_PTRCAST(tauTestSuiteStruct* const*, a);
+    const tauTestSuiteStruct* const rhsTest = *TAU_PTRCAST(tauTestSuiteStruct* const*, b);
+    const tau_ull lhs = lhsTest->index;
+    const tau_ull rhs = rhsTest->index;
+    const tau_i64 lhsDuration = lhsTest->result.previousDuration;
+    const tau_i64 rhsDuration = rhsTest->result.previousDuration;
+
+    if((lhsDuration < 0) != (rhsDuration < 0))
+        return lhsDuration < 0 ? -1 : 1;
+    if(lhsDuration != rhsDuration)
+        return lhsDuration > rhsDuration ? -1 : 1;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+static tau_bool tauTakeNextTest(tauWorkerStruct* const self, tauTestSuiteStruct** const next) {
+    tau_bool found = tau_false;
+
+    tauMutexLock(&self->lock);
+    if(self->head < self->tail) {
+        *next = self->tests[self->head++];
+        found = tau_true;
+    }
+    tauMutexUnlock(&self->lock);
+
+    while(!found) {
+        tauWorkerStruct* victim = TAU_NULL;
+        tau_ull mostQueued = 0;
+
+        // Nothing is ever added to a deque, so once they are all empty we are done. The sizes are read under
+        // their deques' locks: the fullest one may have changed by the time we lock it again, but that is
+        // rechecked below.
+        for(tau_ull w = 0; w < tauNumWorkers; w++) {
+            tau_ull queued;
+            if(&tauWorkers[w] == self)
+                continue;
+            tauMutexLock(&tauWorkers[w].lock);
+            queued = tauWorkers[w].tail - tauWorkers[w].head;
+            tauMutexUnlock(&tauWorkers[w].lock);
+            if(queued > mostQueued) {
+                victim = &tauWorkers[w];
+                mostQueued = queued;
+            }
+        }
+        if(TAU_NONE(victim))
+            break;
+
+        tauMutexLock(&victim->lock);
+        if(victim->head < victim->tail) {
+            *next = victim->tests[--victim->tail];
+            found = tau_true;
+        }
+        tauMutexUnlock(&victim->lock);
+    }
+    return found;
+}
+
+static void tauFlushCapture(tauCaptureStruct* const capture) {
+    tauMutexLock(&tauOutputLock);
+    tauSinkFlush(capture);
+    tauMutexUnlock(&tauOutputLock);
+}
+
+static tau_thread_result_t TAU_THREAD_CALL tauWorkerMain(void* const arg) {
+    tauWorkerStruct* const self = TAU_PTRCAST(tauWorkerStruct*, arg);
+    tauCaptureStruct capture;
+    tauTestSuiteStruct* next;
+
+    memset(&capture, 0, sizeof(capture));
+    capture.streaming = tauStreamReport.open;
+    tauCurrentCapture = &capture;
+    tauWatchAttach(&tauWatchdog.watches[self - tauWorkers]);
+    while(tauTakeNextTest(self, &next)) {
+        tauRunTest(next);
+        tauFlushCapture(&capture);
+    }
+    tauCurrentCapture = TAU_NULL;
+    tauCurrentWatch = TAU_NULL;
+
+    tauBufferFree(&capture.console);
+    tauBufferFree(&capture.file);
+    tauBufferFree(&capture.events);
+    tauBufferFree(&capture.benchmarks);
+    tauCountersClose();
+    return 0;
+}
+
+static void tauRunTestsInParallel(tauTestSuiteStruct* const* const queue, const tau_ull size,
+                                  const tau_ull numWorkers) {
+    tauTestSuiteStruct** const ordered = TAU_PTRCAST(tauTestSuiteStruct**,
+        tauMalloc(sizeof(tauTestSuiteStruct*) * size));
+    tauTestSuiteStruct** const dealt = TAU_PTRCAST(tauTestSuiteStruct**,
+        tauMalloc(sizeof(tauTestSuiteStruct*) * size));
+    tauWatchStruct* const watches = TAU_PTRCAST(tauWatchStruct*, tauCalloc(numWorkers, sizeof(tauWatchStruct)));
+    tau_ull numStarted = 0;
+
+    tauWorkers = TAU_PTRCAST(tauWorkerStruct*, tauCalloc(numWorkers, sizeof(tauWorkerStruct)));
+    tauNumWorkers = numWorkers;
+
+    if(TAU_NONE(ordered) || TAU_NONE(dealt) || TAU_NONE(watches) || TAU_NONE(tauWorkers)) {
+        for(tau_ull i = 0; i < size; i++)
+            tauRunTest(queue[i]);
+    } else {
+        tau_ull pos = 0;
+
+        // A shuffled run keeps its order (which may still be rearranged a bit by workers stealing tests)
+        memcpy(ordered, queue, sizeof(tauTestSuiteStruct*) * size);
+        if(!tauShuffle)
+            qsort(ordered, size, sizeof(tauTestSuiteStruct*), tauCompareExpectedDurations);
+
+        // Deal the ordered tests out round-robin, so that each worker's deque stays sorted longest-first
+        for(tau_ull w = 0; w < numWorkers; w++) {
+            const tau_ull first = pos;
+            for(tau_ull i = w; i < size; i += numWorkers)
+                dealt[pos++] = ordered[i];
+            tauWorkers[w].tests = dealt + first;
+            tauWorkers[w].head = 0;
+            tauWorkers[w].tail = pos - first;
+            tauMutexInit(&tauWorkers[w].lock);
+        }
+        tauMutexInit(&tauOutputLock);
+        tauWatchdogStart(watches, numWorkers, -1);
+        tauWatchdog.outputLock = &tauOutputLock;
+
+        // Anything already sitting in stdio's buffers must come out before the workers' output
+        fflush(stdout);
+
+        for(; numStarted < numWorkers; numStarted++) {
+            if(!tauThreadCreate(&tauWorkers[numStarted].thread, tauWorkerMain, &tauWorkers[numStarted]))
+                break;
+        }
+        for(tau_ull w = 0; w < numStarted; w++)
+            tauThreadJoin(tauWorkers[w].thread);
+        tauWatchdogStop();
+
+        // If no worker could be started, whatever is left is run right here
+        if(numStarted == 0) {
+            tauTestSuiteStruct* next;
+            while(tauTakeNextTest(&tauWorkers[0], &next))
+                tauRunTest(next);
+        }
+
+        for(tau_ull w = 0; w < numWorkers; w++)
+            tauMutexDestroy(&tauWorkers[w].lock);
+        tauMutexDestroy(&tauOutputLock);
+    }
+
+    checkIsInsideTestSuite = 0;
+    tauFree(TAU_PTRCAST(void*, tauWorkers));
+    tauFree(TAU_PTRCAST(void*, watches));
+    tauFree(TAU_PTRCAST(void*, dealt));
+    tauFree(TAU_PTRCAST(void*, ordered));
+    tauWorkers = TAU_NULL;
+    tauNumWorkers = 0;
+}
+#endif // TAU_HAS_THREADS_
+
+#ifdef TAU_HAS_FORK_
+/**
+    Crash-isolating runner (`--isolate`, `--shards=N`)
+    The tests to run are split into `N` contiguous slices, each of which is handed to a forked worker process.
+    A worker runs its slice with output captured and streams the results back to us over a pipe as fixed-size
+    `tauShardRecordStruct` records. If a worker dies (e.g. a test segfaults), the test it was in the middle of is
+    reported as failed, and the rest of its slice is rescheduled onto a fresh worker.
+*/
+#define TAU_SHARD_RECORD_START_     1
+#define TAU_SHARD_RECORD_END_       2
+#define TAU_SHARD_RECORD_TIMEOUT_   3   // The watchdog gave up on the test; the worker exits right after
+#define TAU_SHARD_RECORD_OUTPUT_    4   // An assertion failed: what the test has reported so far
+
+// An END record is followed by `consoleSize` bytes of console output, `fileSize` bytes of XUnit output,
+// `eventsSize` bytes of binary stream records and `benchmarksSize` bytes of benchmark samples, of which the
+// OUTPUT records sent since the START record have had the beginning already. An OUTPUT record is only followed
+// by the first three. A TIMEOUT record gives the time limit the test exceeded as its `duration`, and is followed
+// by what the test had reported since (as in an OUTPUT record) and `stackSize` bytes of its stack.
+typedef struct tauShardRecordStruct {
+    tau_u32 type;
+    tau_u32 status;
+    tau_u64 duration;
+    tau_u64 warnings;
+    tau_u64 consoleSize;
+    tau_u64 fileSize;
+    tau_u64 eventsSize;
+    tau_u64 benchmarksSize;
+    tau_u64 assertions;
+    tau_u64 allocs;
+    tau_u64 allocBytes;
+    tau_i64 peakBytes;
+    tau_i64 leakedBytes;
+    tau_i64 resources[TAU_NUM_RESOURCES_];
+    tau_u64 hasResources;
+    tau_u64 outputStart;        // OUTPUT, TIMEOUT: where in its console output the test's own output starts
+    tau_u64 stackSize;          // TIMEOUT
+} tauShardRecordStruct;
+
+typedef struct tauShardStruct {
+    tau_ull next;               // Position (in the run queue) of the next test this shard has to run
+    tau_ull end;
+    pid_t pid;
+    int fd;
+    int inTest;                 // We have seen a START record, but not (yet) its END record
+    int madeProgress;           // The current worker process has sent at least one record
+    tauBufferStruct received;
+    tauCaptureStruct partial;   // What the worker sent of the current test ahead of its END record
+    tau_ull outputStart;        // Where in `partial.console` the test's own output starts
+    tauShardRecordStruct timedOut;  // The TIMEOUT record the worker sent for the current test (0 `type` if none)...
+    tauBufferStruct timedOutStack;  // ...and the stack that came with it
+} tauShardStruct;
+
+static int tauShardWorkerFd = -1;   // In a worker, its end of the pipe
+
+static const char* tauSignalName(const int sig) {
+    switch(sig) {
+        case SIGSEGV:   return "SIGSEGV";
+        case SIGABRT:   return "SIGABRT";
+        case SIGBUS:    return "SIGBUS";
+        case SIGFPE:    return "SIGFPE";
+        case SIGILL:    return "SIGILL";
+        case SIGKILL:   return "SIGKILL";
+        case SIGTERM:   return "SIGTERM";
+        case SIGINT:    return "SIGINT";
+        case SIGPIPE:   return "SIGPIPE";
+        case SIGTRAP:   return "SIGTRAP";
+        case SIGALRM:   return "SIGALRM";
+        default:        return "an unknown signal";
+    }
+}
+
+// End a forked worker. Its atexit handlers belong to the parent, so they are skipped, but the stdio buffers were
+// flushed before the fork: anything in them now was printed by the worker's tests. (Unless a test that timed out
+// is stuck holding a stream's lock, in which case that stream is left alone rather than waited for.)
+static void tauShardWorkerExit(const int status) {
+    FILE* const streams[2] = { stdout, stderr };
+    for(int i = 0; i < 2; i++) {
+        if(ftrylockfile(streams[i]) == 0) {
+            fflush(streams[i]);
+            funlockfile(streams[i]);
+        }
+    }
+    _exit(status);
+}
 
-#define CHECK_NULL(val)       CHECK(val == TAU_NULL)
-#define CHECK_NOT_NULL(val)   CHECK(val != TAU_NULL)
+// The write-through of a worker's sink: send what the test has reported since the last OUTPUT record in another
+// one, which the parent holds on to in case the test crashes before it is done
+static void tauShardWorkerWriteThrough(tauCaptureStruct* const capture) {
+    tauShardRecordStruct record;
+
+    fflush(stdout);
+    memset(&record, 0, sizeof(record));
+    record.type = TAU_SHARD_RECORD_OUTPUT_;
+    record.consoleSize = capture->console.size - capture->written;
+    record.fileSize = capture->file.size;
+    record.eventsSize = capture->events.size;
+    record.outputStart = tauCurrentWatch ? tauCurrentWatch->outputStart : 0;
+    if(!tauWriteAll(tauShardWorkerFd, &record, sizeof(record)) ||
+       !tauWriteAll(tauShardWorkerFd, capture->console.data + capture->written, record.consoleSize) ||
+       !tauWriteAll(tauShardWorkerFd, capture->file.data, capture->file.size) ||
+       !tauWriteAll(tauShardWorkerFd, capture->events.data, capture->events.size))
+        tauShardWorkerExit(1);
+
+    capture->written = capture->console.size;
+    capture->file.size = 0;
+    capture->events.size = 0;
+}
 
-#define WARN(msg)                                                        \
-    incrementWarnings();                                                 \
-    tauColouredPrintf(TAU_COLOUR_YELLOW_, "%s:%u:\nWARNING: %s\n", __FILE__, __LINE__, #msg)
+// Body of a forked worker: run `queue[begin..end)` and report back over `fd`. Never returns.
+static void tauShardWorkerMain(tauTestSuiteStruct* const* const queue, const tau_ull begin, const tau_ull end,
+                               const int fd) {
+    tauCaptureStruct capture;
+    memset(&capture, 0, sizeof(capture));
+    capture.streaming = tauStreamReport.open;
+    capture.writeThrough = tauShardWorkerWriteThrough;
+    tauCurrentCapture = &capture;
+    tauShardWorkerFd = fd;
+
+    // The report files belong to the parent, which reports our crashes itself. What the tests print themselves
+    // goes straight to the parent's stdout: a line at a time, so that a crash loses as little of it as possible.
+    // (glibc only switches a stream that has been used already to line buffering along with its buffer.)
+    static char stdoutBuffer[BUFSIZ];
+    tauReportRestoreSignals();
+    setvbuf(stdout, stdoutBuffer, _IOLBF, sizeof(stdoutBuffer));
+
+    tauWatchStruct watch;
+    memset(&watch, 0, sizeof(watch));
+    tauWatchdogStart(&watch, 1, fd);
+    tauWatchAttach(&watch);
+
+    for(tau_ull pos = begin; pos < end; pos++) {
+        tauShardRecordStruct record;
+        const tau_u64 warnings = tauStatsNumWarnings;
+        tauTestSuiteStruct* const test = queue[pos];
+
+        memset(&record, 0, sizeof(record));
+        record.type = TAU_SHARD_RECORD_START_;
+        if(!tauWriteAll(fd, &record, sizeof(record)))
+            tauShardWorkerExit(1);
+
+        tauRunTest(test);
+
+        // What the test printed itself never went through the capture, and `_exit()` won't flush it for us
+        fflush(stdout);
+        fflush(stderr);
+
+        record.type = TAU_SHARD_RECORD_END_;
+        record.status = TAU_CAST(tau_u32, test->result.status);
+        record.duration = test->result.duration;
+        record.warnings = tauStatsNumWarnings - warnings;
+        record.consoleSize = capture.console.size - capture.written;
+        record.fileSize = capture.file.size;
+        record.eventsSize = capture.events.size;
+        record.benchmarksSize = capture.benchmarks.size;
+        record.assertions = test->result.assertions;
+        record.allocs = test->result.allocs;
+        record.allocBytes = test->result.allocBytes;
+        record.peakBytes = test->result.peakBytes;
+        record.leakedBytes = test->result.leakedBytes;
+        memcpy(record.resources, test->result.resources, sizeof(record.resources));
+        record.hasResources = TAU_CAST(tau_u64, test->result.hasResources);
+        if(!tauWriteAll(fd, &record, sizeof(record)) ||
+           !tauWriteAll(fd, capture.console.data + capture.written, record.consoleSize) ||
+           !tauWriteAll(fd, capture.file.data, capture.file.size) ||
+           !tauWriteAll(fd, capture.events.data, capture.events.size) ||
+           !tauWriteAll(fd, capture.benchmarks.data, capture.benchmarks.size))
+            tauShardWorkerExit(1);
+
+        capture.console.size = 0;
+        capture.written = 0;
+        capture.file.size = 0;
+        capture.events.size = 0;
+        capture.benchmarks.size = 0;
+    }
 
-#ifdef __cplusplus
-    #define SECTION(...)    \
-        if(1)
-    #define STATIC_REQUIRE(...)                  \
-        static_assert(__VA_ARGS__, #__VA_ARGS__)
-    #define STATIC_REQUIRE_FALSE(...)            \
-        static_assert(!(__VA_ARGS__), "!(" #__VA_ARGS__ ")")
-#else
-    #define SECTION(...)                                            \
-        WARN(Using "SECTION" in C results in limited diagnostics.); \
-        if(1)
-    #define STATIC_REQUIRE(...)                                              \
-        WARN(Usage of "STATIC_REQUIRE" is not supported in C source files.)
-    #define STATIC_REQUIRE_FALSE(...)                                        \
-        WARN(Usage of "STATIC_REQUIRE_FALSE" is not supported in C source files.)
-#endif // __cplusplus
+    tauShardWorkerExit(0);
+}
 
-/**
-#########################################
-             Implementation
-#########################################
-*/
+// Called by the watchdog of a worker when the test it is running has timed out: send what the test reported
+// before it hung (that it hasn't sent already), and its stack
+static void tauShardWorkerTimeout(const int fd, const tau_u64 limit, const tauCaptureStruct* const capture,
+                                  const tau_ull outputStart, const tauBufferStruct* const stack) {
+    tauShardRecordStruct record;
+
+    memset(&record, 0, sizeof(record));
+    record.type = TAU_SHARD_RECORD_TIMEOUT_;
+    record.duration = limit;
+    record.consoleSize = capture->console.size - capture->written;
+    record.fileSize = capture->file.size;
+    record.eventsSize = capture->events.size;
+    record.outputStart = outputStart;
+    record.stackSize = stack->size;
+    if(tauWriteAll(fd, &record, sizeof(record)) &&
+       tauWriteAll(fd, capture->console.data + capture->written, record.consoleSize) &&
+       tauWriteAll(fd, capture->file.data, capture->file.size) &&
+       tauWriteAll(fd, capture->events.data, capture->events.size))
+        tauWriteAll(fd, stack->data, stack->size);
+}
 
-#ifndef TAU_NO_TESTING
-#ifdef _MSC_VER
-    #define TAU_SNPRINTF(BUFFER, N, ...)   _snprintf_s(BUFFER, N, N, __VA_ARGS__)
-#else
-    #define TAU_SNPRINTF(...)              snprintf(__VA_ARGS__)
-#endif // _MSC_VER
+static tau_bool tauShardSpawn(tauShardStruct* const shard, tauTestSuiteStruct* const* const queue) {
+    int fds[2];
+    pid_t pid;
 
-#define TEST(TESTSUITE, TESTNAME)                                                              \
-    TAU_EXTERN tauTestStateStruct tauTestContext;                                              \
-    static void _TAU_TEST_FUNC_##TESTSUITE##_##TESTNAME(void);                                 \
-    TAU_TEST_INITIALIZER(tau_register_##TESTSUITE##_##TESTNAME) {                              \
-        const tau_ull index = tauTestContext.numTestSuites++;                                  \
-        const char* const namePart = #TESTSUITE "." #TESTNAME;                                 \
-        const tau_ull nameSize = strlen(namePart) + 1;                                         \
-        char* const name = TAU_PTRCAST(char* , malloc(nameSize));                              \
-        tauTestContext.tests = TAU_PTRCAST(                                                    \
-                                    tauTestSuiteStruct*,                                       \
-                                    tau_realloc(TAU_PTRCAST(void* , tauTestContext.tests),     \
-                                                sizeof(tauTestSuiteStruct) *                   \
-                                                    tauTestContext.numTestSuites));            \
-        tauTestContext.tests[index].func = &_TAU_TEST_FUNC_##TESTSUITE##_##TESTNAME;           \
-        tauTestContext.tests[index].name = name;                                               \
-        TAU_SNPRINTF(name, nameSize, "%s", namePart);                                          \
-    }                                                                                          \
-    void _TAU_TEST_FUNC_##TESTSUITE##_##TESTNAME(void)
+    if(pipe(fds) != 0)
+        return tau_false;
 
+    // Anything buffered now would otherwise be written out by both processes
+    fflush(stdout);
 
-#define TEST_F_SETUP(FIXTURE)                                                  \
-    static void __TAU_TEST_FIXTURE_SETUP_##FIXTURE(struct FIXTURE* const tau)
+    pid = fork();
+    if(pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return tau_false;
+    }
+    if(pid == 0) {
+        close(fds[0]);
+        tauShardWorkerMain(queue, shard->next, shard->end, fds[1]);
+    }
 
-#define TEST_F_TEARDOWN(FIXTURE)                                               \
-    static void __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(struct FIXTURE* const tau)
+    close(fds[1]);
+    shard->pid = pid;
+    shard->fd = fds[0];
+    shard->inTest = 0;
+    shard->madeProgress = 0;
+    shard->received.size = 0;
+    shard->partial.console.size = 0;
+    shard->partial.file.size = 0;
+    shard->partial.events.size = 0;
+    shard->outputStart = 0;
+    shard->timedOut.type = 0;
+    shard->timedOutStack.size = 0;
+    return tau_true;
+}
 
-#define TEST_F(FIXTURE, NAME)                                                                            \
-    TAU_EXTERN tauTestStateStruct tauTestContext;                                                        \
-    static void __TAU_TEST_FIXTURE_SETUP_##FIXTURE(struct FIXTURE* const);                               \
-    static void __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(struct FIXTURE* const);                            \
-    static void __TAU_TEST_FIXTURE_RUN_##FIXTURE##_##NAME(struct FIXTURE* const);                        \
-                                                                                                         \
-    static void __TAU_TEST_FIXTURE_##FIXTURE##_##NAME() {                                                \
-        struct FIXTURE fixture;                                                                          \
-        memset(&fixture, 0, sizeof(fixture));                                                            \
-        __TAU_TEST_FIXTURE_SETUP_##FIXTURE(&fixture);                                                    \
-        if(hasCurrentTestFailed == 1) {                                                                  \
-            return;                                                                                      \
-        }                                                                                                \
-                                                                                                         \
-        __TAU_TEST_FIXTURE_RUN_##FIXTURE##_##NAME(&fixture);                                             \
-        __TAU_TEST_FIXTURE_TEARDOWN_##FIXTURE(&fixture);                                                 \
-    }                                                                                                    \
-                                                                                                         \
-    TAU_TEST_INITIALIZER(tau_register_##FIXTURE##_##NAME) {                                              \
-        const tau_ull index = tauTestContext.numTestSuites++;                                            \
-        const char* const namePart = #FIXTURE "." #NAME;                                                 \
-        const tau_ull nameSize = strlen(namePart) + 1;                                                   \
-        char* name = TAU_PTRCAST(char* , malloc(nameSize));                                              \
-        tauTestContext.tests = TAU_PTRCAST(                                                              \
-                                    tauTestSuiteStruct*,                                                 \
-                                    tau_realloc(TAU_PTRCAST(void*, tauTestContext.tests),                \
-                                                                sizeof(tauTestSuiteStruct) *             \
-                                                                        tauTestContext.numTestSuites));  \
-        tauTestContext.tests[index].func = &__TAU_TEST_FIXTURE_##FIXTURE##_##NAME;                       \
-        tauTestContext.tests[index].name = name;                                                         \
-        TAU_SNPRINTF(name, nameSize, "%s", namePart);                                                    \
-    }                                                                                                    \
-    static void __TAU_TEST_FIXTURE_RUN_##FIXTURE##_##NAME(struct FIXTURE* const tau)
+// Hold on to what an OUTPUT, TIMEOUT or END record says the worker's current test has reported
+static void tauShardAppendPartial(tauShardStruct* const shard, const tauShardRecordStruct* const record,
+                                  const char* const payload) {
+    tauBufferAppend(&shard->partial.console, payload, record->consoleSize);
+    tauBufferAppend(&shard->partial.file, payload + record->consoleSize, record->fileSize);
+    tauBufferAppend(&shard->partial.events, payload + record->consoleSize + record->fileSize, record->eventsSize);
+    if(record->type != TAU_SHARD_RECORD_END_)
+        shard->outputStart = record->outputStart;
+}
 
+// Write out what the worker's current test has reported, and forget it
+static void tauShardWritePartial(tauShardStruct* const shard) {
+    fwrite(shard->partial.console.data, 1, shard->partial.console.size, stdout);
+    if(tauTestContext.foutput)
+        tauReportWrite(&tauXUnitReport, shard->partial.file.data, shard->partial.file.size);
+    if(tauStreamReport.open)
+        tauReportWrite(&tauStreamReport, shard->partial.events.data, shard->partial.events.size);
+    shard->partial.console.size = 0;
+    shard->partial.file.size = 0;
+    shard->partial.events.size = 0;
+    shard->outputStart = 0;
+}
 
-static int tauShouldFilterTest(const char* const filter, const char* const testcase);
-static int tauShouldFilterTest(const char* const filter, const char* const testcase) {
-    if(TAU_SOME(filter)) {
-        const char* filter_curr = filter;
-        const char* testcase_curr = testcase;
-        const char* filter_wildcard = TAU_NULL;
-
-        while ((*filter_curr != TAU_NULLCHAR) && (*testcase_curr != TAU_NULLCHAR)) {
-            if(*filter_curr == '*') {
-                // store the position of the wildcard
-                filter_wildcard = filter_curr;
-
-                // skip the wildcard character
-                filter_curr++;
-
-                while ((*filter_curr != TAU_NULLCHAR) && (*testcase_curr != TAU_NULLCHAR)) {
-                    if(*filter_curr == '*') {
-                        // Found another wildcard (filter is something like *foo*), so exit the current loop,
-                        // and return to the parent loop to handle the wildcard case
-                        break;
-                    } else if(*filter_curr != *testcase_curr) {
-                        // otherwise our filter didn't match, so reset it
-                        filter_curr = filter_wildcard;
-                    }
-
-                    // move testcase along
-                    testcase_curr++;
-
-                    // move filter along
-                    filter_curr++;
-                }
+// Parse (and consume) every complete record the worker has sent so far. A worker runs its slice in order, so
+// each END record belongs to `queue[shard->next]`.
+static void tauShardProcessRecords(tauShardStruct* const shard, tauTestSuiteStruct* const* const queue) {
+    tau_ull offset = 0;
 
-                if((*filter_curr == TAU_NULLCHAR) && (*testcase_curr == TAU_NULLCHAR))
-                    return 0;
+    while(shard->received.size - offset >= sizeof(tauShardRecordStruct)) {
+        tauShardRecordStruct record;
+        tau_u64 payloadSize;
+        memcpy(&record, shard->received.data + offset, sizeof(record));
 
-                // if the testcase has been exhausted, we don't have a match!
-                if(*testcase_curr == TAU_NULLCHAR)
-                    return 1;
-            } else {
-                if(*testcase_curr != *filter_curr) {
-                    // test case doesn't match filter
-                    return 1;
-                } else {
-                    // move our filter and testcase forward
-                    testcase_curr++;
-                    filter_curr++;
-                }
+        if(record.type == TAU_SHARD_RECORD_START_) {
+            shard->inTest = 1;
+            shard->madeProgress = 1;
+            offset += sizeof(record);
+            continue;
+        }
+        if(record.type == TAU_SHARD_RECORD_OUTPUT_ || record.type == TAU_SHARD_RECORD_TIMEOUT_) {
+            payloadSize = record.consoleSize + record.fileSize + record.eventsSize + record.stackSize;
+            if(shard->received.size - offset < sizeof(record) + payloadSize)
+                break;
+            tauShardAppendPartial(shard, &record, shard->received.data + offset + sizeof(record));
+            if(record.type == TAU_SHARD_RECORD_TIMEOUT_) {
+                shard->timedOut = record;
+                tauBufferAppend(&shard->timedOutStack, shard->received.data + offset + sizeof(record) + payloadSize -
+                                record.stackSize, record.stackSize);
             }
+            offset += sizeof(record) + payloadSize;
+            continue;
         }
 
-        if((*filter_curr != TAU_NULLCHAR) || ((*testcase_curr == TAU_NULLCHAR) && ((filter == filter_curr) ||
-            (filter_curr[-1] != '*')))) {
-            // We have a mismatch
-            return 1;
+        // END: wait until its payload has arrived as well
+        payloadSize = record.consoleSize + record.fileSize + record.eventsSize + record.benchmarksSize;
+        if(shard->received.size - offset < sizeof(record) + payloadSize)
+            break;
+
+        {
+            const char* const payload = shard->received.data + offset + sizeof(record);
+            tauTestResultStruct* const result = &queue[shard->next]->result;
+
+            result->status = TAU_CAST(int, record.status);
+            result->duration = record.duration;
+            result->assertions = record.assertions;
+            result->allocs = record.allocs;
+            result->allocBytes = record.allocBytes;
+            result->peakBytes = record.peakBytes;
+            result->leakedBytes = record.leakedBytes;
+            memcpy(result->resources, record.resources, sizeof(result->resources));
+            result->hasResources = TAU_CAST(int, record.hasResources);
+            tauStatsNumWarnings += record.warnings;
+
+            tauShardAppendPartial(shard, &record, payload);
+            tauShardWritePartial(shard);
+            if(record.benchmarksSize > 0)
+                tauBufferAppend(&tauBenchResults, payload + payloadSize - record.benchmarksSize, record.benchmarksSize);
         }
+
+        shard->inTest = 0;
+        shard->next++;
+        offset += sizeof(record) + payloadSize;
+    }
+
+    if(offset > 0) {
+        memmove(shard->received.data, shard->received.data + offset, shard->received.size - offset);
+        shard->received.size -= offset;
     }
-    return 0;
 }
 
-static inline FILE* tau_fopen(const char* const filename, const char* const mode) {
-#ifdef _MSC_VER
-    FILE* file;
-    if(fopen_s(&file, filename, mode) == 0) {
-        return file;
+// Report the test a worker died in the middle of, or sent a TIMEOUT record for, after what it had reported (and
+// announced itself with, unless it hadn't sent anything yet)
+static void tauShardReportLostTest(tauShardStruct* const shard, tauTestSuiteStruct* const test,
+                                   const char* const reason) {
+    const tauCaptureStruct* const partial = &shard->partial;
+    const tau_bool timedOut = TAU_CAST(tau_bool, shard->timedOut.type == TAU_SHARD_RECORD_TIMEOUT_);
+    char timeout[64];
+
+    if(partial->console.size == 0 && !tauDisplayOnlyFailedOutput) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[ RUN      ] ");
+        tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s\n", test->name);
+    }
+    fwrite(partial->console.data, 1, partial->console.size, stdout);
+    if(tauTestContext.foutput)
+        tauReportWrite(&tauXUnitReport, partial->file.data, partial->file.size);
+    if(tauStreamReport.open)
+        tauReportWrite(&tauStreamReport, partial->events.data, partial->events.size);
+
+    if(timedOut) {
+        TAU_SNPRINTF(timeout, sizeof(timeout), "timed out after %" TAU_PRIu64 "ms", shard->timedOut.duration / 1000000);
+        tauReportLostTest(test, shard->timedOut.duration, timeout, shard->timedOutStack.data, shard->timedOutStack.size,
+                          partial->console.data + shard->outputStart, partial->console.size - shard->outputStart,
+                          TAU_CAST(tau_bool, partial->events.size > 0));
     } else {
-        return TAU_NULL;
+        tauReportLostTest(test, 0, reason, TAU_NULL, 0, partial->console.data + shard->outputStart,
+                          partial->console.size - shard->outputStart, TAU_CAST(tau_bool, partial->events.size > 0));
     }
-#else
-    return fopen(filename, mode);
-#endif // _MSC_VER
+
+    shard->partial.console.size = 0;
+    shard->partial.file.size = 0;
+    shard->partial.events.size = 0;
+    shard->outputStart = 0;
 }
 
+// The worker closed its end of the pipe: find out why, and start a fresh worker if it didn't finish its slice
+static void tauShardReap(tauShardStruct* const shard, tauTestSuiteStruct* const* const queue) {
+    char reason[64];
+    int status = 0;
+
+    close(shard->fd);
+    shard->fd = -1;
+    while(waitpid(shard->pid, &status, 0) < 0 && errno == EINTR) {}
+    shard->pid = -1;
+
+    if(WIFSIGNALED(status))
+        TAU_SNPRINTF(reason, sizeof(reason), "killed by %s", tauSignalName(WTERMSIG(status)));
+    else
+        TAU_SNPRINTF(reason, sizeof(reason), "exited with status %d", WEXITSTATUS(status));
+
+    // Blame the test that was running. If the worker died before it even started one, blame the next test so
+    // that we always make progress.
+    if(shard->next < shard->end && (shard->inTest || !shard->madeProgress ||
+                                    !WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+        tauShardReportLostTest(shard, queue[shard->next], reason);
+        shard->next++;
+    }
 
-static void tau_help_() {
-    printf("Usage: %s [options] [test...]\n", tau_argv0_);
-    printf("\n");
-    printf("Run the specified unit tests; or if the option '--skip' is used, run all\n");
-    printf("tests in the suite but those listed. By default, if no tests are specified\n");
-    printf("on the command line, all unit tests in the suite are run.\n");
-    printf("\n");
-    printf("Options:\n");
-    printf("  --failed-output-only     Output only failed Test Suites");
-    printf("  --filter=<filter>        Filter the test suites to run (e.g: Suite1*.a\n");
-    printf("                             would run Suite1Case.a but not Suite1Case.b}\n");
-#if defined(TAU_WIN_)
-    printf("  --time                   Measure test duration\n");
-#elif defined(TAU_HAS_POSIX_TIMER_)
-    printf("  --time                   Measure test duration (real time)\n");
-    printf("  --time=TIMER             Measure test duration, using given timer\n");
-    printf("                               (TIMER is one of 'real', 'cpu')\n");
-#endif // TAU_WIN_
-    printf("  --no-summary             Suppress printing of test results summary\n");
-    printf("  --output=<FILE>          Write an XUnit XML file to Enable XUnit output\n");
-    printf("                             to the given file\n");
-    printf("  --list                   List unit tests in the suite and exit\n");
-    printf("  --no-color               Disable coloured output\n");
-    printf("  --help                   Display this help and exit\n");
+    if(shard->next < shard->end && !tauShardSpawn(shard, queue)) {
+        // No more processes: finish the slice without isolation
+        for(; shard->next < shard->end; shard->next++)
+            tauRunTest(queue[shard->next]);
+    }
 }
 
+static void tauRunTestsIsolated(tauTestSuiteStruct* const* const queue, const tau_ull size,
+                                const tau_ull numShards) {
+    tauShardStruct* const shards = TAU_PTRCAST(tauShardStruct*, tauCalloc(numShards, sizeof(tauShardStruct)));
+    struct pollfd* const fds = TAU_PTRCAST(struct pollfd*, tauCalloc(numShards, sizeof(struct pollfd)));
+    const tau_ull perShard = (size + numShards - 1) / numShards;
+    char chunk[65536];
 
-static tau_bool tauCmdLineRead(const int argc, const char* const * const argv) {
-    // Coloured output
-#ifdef TAU_UNIX_
-    tauShouldColourizeOutput = isatty(STDOUT_FILENO);
-#elif defined TAU_WIN_
-    #ifdef _BORLANDC_
-        tauShouldColourizeOutput = isatty(_fileno(stdout));
-    #else
-        tauShouldColourizeOutput = _isatty(_fileno(stdout));
-    #endif // _BORLANDC_
-#else
-    tauShouldColourizeOutput = isatty(STDOUT_FILENO);
-#endif // TAU_UNIX_
+    if(TAU_NONE(shards) || TAU_NONE(fds)) {
+        for(tau_ull i = 0; i < size; i++)
+            tauRunTest(queue[i]);
+    } else {
+        for(tau_ull s = 0; s < numShards; s++) {
+            shards[s].next = s * perShard < size ? s * perShard : size;
+            shards[s].end = shards[s].next + perShard < size ? shards[s].next + perShard : size;
+            shards[s].pid = -1;
+            shards[s].fd = -1;
+            if(shards[s].next < shards[s].end && !tauShardSpawn(&shards[s], queue)) {
+                for(; shards[s].next < shards[s].end; shards[s].next++)
+                    tauRunTest(queue[shards[s].next]);
+            }
+        }
 
-    // loop through all arguments looking for our options
-    for(tau_ull i = 1; i < TAU_CAST(tau_ull, argc); i++) {
-        /* Informational switches */
-        const char* const helpStr = "--help";
-        const char* const listStr = "--list";
-        const char* const colourStr = "--no-color";
-        const char* const summaryStr = "--no-summary";
-        const char* const onlyFailedOutput = "--failed-output-only";
-        /* Test config switches */
-        const char* const filterStr = "--filter=";
-        const char* const XUnitOutput = "--output=";
+        for(;;) {
+            nfds_t numActive = 0;
+            for(tau_ull s = 0; s < numShards; s++) {
+                if(shards[s].fd >= 0) {
+                    fds[numActive].fd = shards[s].fd;
+                    fds[numActive].events = POLLIN;
+                    fds[numActive].revents = 0;
+                    numActive++;
+                }
+            }
+            if(numActive == 0)
+                break;
 
-        // Help
-        if(strncmp(argv[i], helpStr, strlen(helpStr)) == 0) {
-            tau_help_();
-            return tau_false;
+            if(poll(fds, numActive, -1) < 0) {
+                if(errno == EINTR)
+                    continue;
+                break;
+            }
+
+            for(tau_ull s = 0, f = 0; s < numShards; s++) {
+                ssize_t n;
+                if(shards[s].fd < 0)
+                    continue;
+                if(fds[f++].revents == 0)
+                    continue;
+
+                n = read(shards[s].fd, chunk, sizeof(chunk));
+                if(n > 0) {
+                    tauBufferAppend(&shards[s].received, chunk, TAU_CAST(tau_ull, n));
+                    tauShardProcessRecords(&shards[s], queue);
+                } else if(n == 0 || errno != EINTR) {
+                    tauShardReap(&shards[s], queue);
+                }
+            }
         }
 
-        // Only failed output
-        else if(strncmp(argv[i], onlyFailedOutput, strlen(onlyFailedOutput)) == 0) {
-            tauDisplayOnlyFailedOutput = 1;
+        for(tau_ull s = 0; s < numShards; s++) {
+            tauBufferFree(&shards[s].received);
+            tauBufferFree(&shards[s].partial.console);
+            tauBufferFree(&shards[s].partial.file);
+            tauBufferFree(&shards[s].partial.events);
+            tauBufferFree(&shards[s].timedOutStack);
         }
+    }
 
-        // Filter tests
-        else if(strncmp(argv[i], filterStr, strlen(filterStr)) == 0)
-            // user wants to filter what test suites run!
-            cmd_filter = argv[i] + strlen(filterStr);
+    checkIsInsideTestSuite = 0;
+    tauFree(TAU_PTRCAST(void*, shards));
+    tauFree(TAU_PTRCAST(void*, fds));
+}
+#endif // TAU_HAS_FORK_
 
-        // Write XUnit XML file
-        else if(strncmp(argv[i], XUnitOutput, strlen(XUnitOutput)) == 0)
-            tauTestContext.foutput = tau_fopen(argv[i] + strlen(XUnitOutput), "w+");
+static void tauRunTestsSerially(tauTestSuiteStruct* const* const queue, const tau_ull size) {
+    tauWatchStruct watch;
+    memset(&watch, 0, sizeof(watch));
+    tauWatchdogStart(&watch, 1, -1);
+    tauWatchAttach(&watch);
 
-        // List tests
-        else if(strncmp(argv[i], listStr, strlen(listStr)) == 0) {
-            for (i = 0; i < tauTestContext.numTestSuites; i++)
-                tauPrintf("%s\n", tauTestContext.tests[i].name);
-            tauDisplayTests = 1;
-        }
+#ifdef TAU_WIN_
+    // Colours are console attributes on Windows, which can't be buffered (the XUnit and binary stream reporters
+    // need the output of every test though, and so do benchmark baselines, so they have to do without colours)
+    if(!tauTestContext.foutput && !tauStreamReport.open && TAU_NONE(tauBenchSaveFile) && TAU_NONE(tauBenchCompareFile)) {
+        for(tau_ull i = 0; i < size; i++)
+            tauRunTest(queue[i]);
+        tauWatchdogStop();
+        tauCurrentWatch = TAU_NULL;
+        checkIsInsideTestSuite = 0;
+        return;
+    }
+#endif // TAU_WIN_
+    tauCaptureStruct capture;
+    memset(&capture, 0, sizeof(capture));
+    capture.live = 1;
+    capture.writeThrough = tauSinkWriteThrough;
+    capture.streaming = tauStreamReport.open;
+
+    tauCurrentCapture = &capture;
+    for(tau_ull i = 0; i < size; i++) {
+        tauRunTest(queue[i]);
+        tauSinkFlush(&capture);
+    }
+    tauCurrentCapture = TAU_NULL;
+    tauWatchdogStop();
+    tauCurrentWatch = TAU_NULL;
+
+    tauSinkFlush(&capture);
+    tauBufferFree(&capture.console);
+    tauBufferFree(&capture.file);
+    tauBufferFree(&capture.events);
+    tauBufferFree(&capture.benchmarks);
+    tauCountersClose();
+    checkIsInsideTestSuite = 0;
+}
 
-        // Disable colouring
-        else if(strncmp(argv[i], colourStr, strlen(colourStr)) == 0) {
-            tauShouldColourizeOutput = 0;
-        }
+/**
+    Test order shuffling (`--shuffle`)
+    SplitMix64, which gives the same sequence on every platform, so that a seed reproduces an order anywhere. The
+    generator carries on from one iteration of `--repeat` to the next: iteration K is reproduced by running with
+    the same seed and at least K repeats.
+*/
+static tau_u64 tauRandomState = 0;
 
-        // Disable Summary
-        else if(strncmp(argv[i], summaryStr, strlen(summaryStr))) {
-            tauDisableSummary = 1;
-        }
+static tau_u64 tauRandomNext() {
+    tau_u64 z = (tauRandomState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-        else {
-            printf("ERROR: Unrecognized option: %s", argv[i]);
-            return tau_false;
+// Fisher-Yates
+static void tauShuffleTests(tauTestSuiteStruct** const queue, const tau_ull size) {
+    for(tau_ull i = size; i > 1; i--) {
+        const tau_ull j = TAU_CAST(tau_ull, tauRandomNext() % i);
+        tauTestSuiteStruct* const test = queue[i - 1];
+        queue[i - 1] = queue[j];
+        queue[j] = test;
+    }
+}
+
+// Triggers and runs all unit tests
+static void tauRunTests() {
+    // The run plan: the tests that pass the filter, in registration order
+    tauTestSuiteStruct** const queue = TAU_PTRCAST(tauTestSuiteStruct**,
+                                                   tauMalloc(sizeof(tauTestSuiteStruct*) * (tauTestContext.numTestSuites + 1)));
+    tau_ull queueSize = 0;
+
+    if(TAU_NONE(queue)) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "ERROR: Out of memory\n");
+        return;
+    }
+
+    // Read the baseline before running anything, in case `--bench-save` names the same file
+    if(TAU_SOME(tauBenchCompareFile)) {
+        tau_ull size;
+        tauBenchBaseline = tauReadFile(tauBenchCompareFile, &size);
+        if(TAU_NONE(tauBenchBaseline))
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Could not read %s\n", tauBenchCompareFile);
+    }
+    for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        test->numPasses = 0;
+        test->numFailures = 0;
+        if(test->selected)
+            queue[queueSize++] = test;
+    }
+
+    if(tauShuffle) {
+        tauRandomState = tauShuffleSeed;
+        tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[==========] ");
+        tauColouredPrintf(TAU_COLOUR_DEFAULT_, "Shuffling tests with seed %" TAU_PRIu64 "\n", tauShuffleSeed);
+    }
+
+    // Every iteration runs the same queue; only the results of the last one are kept (besides the pass/fail counts),
+    // and so are only the samples of its benchmarks
+    for(;;) {
+        tau_u64 numFailed = 0;
+
+        tauStatsIterations++;
+        for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next)
+            test->result.status = TAU_TEST_NOT_RUN_;
+        tauBenchResults.size = 0;
+        if(tauNumRepeats != 1) {
+            tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[==========] ");
+            if(tauNumRepeats > 0)
+                tauColouredPrintf(TAU_COLOUR_BOLD_, "Iteration %" TAU_PRIu64 " of %" TAU_PRIu64 "\n",
+                                  tauStatsIterations, tauNumRepeats);
+            else
+                tauColouredPrintf(TAU_COLOUR_BOLD_, "Iteration %" TAU_PRIu64 "\n", tauStatsIterations);
+        }
+        if(tauShuffle)
+            tauShuffleTests(queue, queueSize);
+
+        // Run tests
+#ifdef TAU_HAS_FORK_
+        if(tauNumShards > 0 && queueSize > 0)
+            tauRunTestsIsolated(queue, queueSize, tauNumShards < queueSize ? tauNumShards : queueSize);
+        else
+#endif // TAU_HAS_FORK_
+#ifdef TAU_HAS_THREADS_
+        if(tauNumJobs > 1 && queueSize > 1)
+            tauRunTestsInParallel(queue, queueSize, tauNumJobs < queueSize ? tauNumJobs : queueSize);
+        else
+#endif // TAU_HAS_THREADS_
+        tauRunTestsSerially(queue, queueSize);
+
+        for(tau_ull i = 0; i < queueSize; i++) {
+            tauStatsNumAssertions += queue[i]->result.assertions;
+            tauStatsTestsDuration += queue[i]->result.duration;
+            if(queue[i]->result.status == TAU_TEST_FAILED_) {
+                queue[i]->numFailures++;
+                numFailed++;
+            } else if(queue[i]->result.status == TAU_TEST_PASSED_) {
+                queue[i]->numPasses++;
+            }
         }
+        if(tauUntilFail && numFailed > 0)
+            break;
+        if(tauStatsIterations == tauNumRepeats)
+            break;
     }
+    tauFree(TAU_PTRCAST(void*, queue));
 
-    return tau_true;
+    // A test counts as failed if it failed in any iteration
+    for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        if(test->numFailures > 0)
+            tauStatsNumTestsFailed++;
+    }
+
+    if(TAU_SOME(tauDurationsFile))
+        tauSaveDurations();
+
+    tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[==========] ");
+    if(tauStatsIterations > 1)
+        tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%" TAU_PRIu64 " test suites ran %" TAU_PRIu64 " times\n",
+                          tauStatsTestsRan, tauStatsIterations);
+    else
+        tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%" TAU_PRIu64 " test suites ran\n", tauStatsTestsRan);
+
+    if(TAU_SOME(tauBenchBaseline))
+        tauBenchCompare();
+    if(TAU_SOME(tauBenchSaveFile))
+        tauBenchSave();
 }
 
-static int tauCleanup() {
-    for (tau_ull i = 0; i < tauTestContext.numTestSuites; i++)
-        free(TAU_PTRCAST(void* , tauTestContext.tests[i].name));
 
-    free(TAU_PTRCAST(void* , tauStatsFailedTestSuites));
-    free(TAU_PTRCAST(void* , tauTestContext.tests));
+// The allocations of each test that made any (only available with TauAlloc linked in)
+static void tauPrintAllocSummary() {
+    int width = 0;
 
-    if(tauTestContext.foutput)
-        fclose(tauTestContext.foutput);
+    for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        if(test->result.status != TAU_TEST_NOT_RUN_ && test->result.allocs > 0 && TAU_CAST(int, strlen(test->name)) > width)
+            width = TAU_CAST(int, strlen(test->name));
+    }
+    if(width == 0)
+        return;
 
-    return TAU_CAST(int, tauStatsNumTestsFailed);
+    tauColouredPrintf(TAU_COLOUR_BOLD_, "\nAllocations:\n");
+    for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        const tauTestResultStruct* const result = &test->result;
+        if(result->status == TAU_TEST_NOT_RUN_ || result->allocs == 0)
+            continue;
+        printf("    %-*s  %" TAU_PRIu64 " allocs, %" TAU_PRIu64 " bytes total, %" TAU_PRId64 " bytes peak, ",
+               width, test->name, result->allocs, result->allocBytes, result->peakBytes > 0 ? result->peakBytes : 0);
+        if(result->leakedBytes > 0)
+            tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "%" TAU_PRId64 " bytes leaked\n", result->leakedBytes);
+        else
+            printf("0 bytes leaked\n");
+    }
 }
 
-// Triggers and runs all unit tests
-static void tauRunTests() {
-    // Run tests
-    for(tau_ull i = 0; i < tauTestContext.numTestSuites; i++) {
-        checkIsInsideTestSuite = 1;
-        hasCurrentTestFailed = 0;
+// The tests that both passed and failed over the iterations of `--repeat`/`--until-fail`
+static void tauPrintFlakyTests() {
+    int width = 0;
+
+    for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        if(test->numPasses > 0 && test->numFailures > 0 && TAU_CAST(int, strlen(test->name)) > width)
+            width = TAU_CAST(int, strlen(test->name));
+    }
+    if(width == 0)
+        return;
 
-        if(tauShouldFilterTest(cmd_filter, tauTestContext.tests[i].name))
+    tauColouredPrintf(TAU_COLOUR_BOLD_, "\nFlaky tests:\n");
+    for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        if(test->numPasses == 0 || test->numFailures == 0)
             continue;
+        printf("    %-*s  %" TAU_PRIu64 " passed, ", width, test->name, test->numPasses);
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "%" TAU_PRIu64 " failed", test->numFailures);
+        printf(" (%.1f%% of runs)\n", 100.0 * TAU_CAST(double, test->numFailures) /
+                                       TAU_CAST(double, test->numPasses + test->numFailures));
+    }
+}
 
-        if(!tauDisplayOnlyFailedOutput) {
-            tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[ RUN      ] ");
-            tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s\n", tauTestContext.tests[i].name);
-        }
+/**
+    The heaviest tests (`--top=N`)
+    For each metric, the N tests that ran with the highest values (leaving out those that didn't register at all).
+    Metrics are the `TAU_RESOURCE_*_` constants, plus the pseudo-metrics below.
+*/
+#define TAU_TOP_DURATION_       (-1)
+#define TAU_TOP_ALLOC_BYTES_    (-2)
+#define TAU_TOP_PEAK_BYTES_     (-3)
+#define TAU_TOP_ASSERTIONS_     (-4)
+
+static int tauTopMetric;        // What `tauCompareTopTests()` compares by
+
+static tau_i64 tauTopValue(const tauTestSuiteStruct* const test, const int metric) {
+    switch(metric) {
+        case TAU_TOP_DURATION_:     return TAU_CAST(tau_i64, test->result.duration);
+        case TAU_TOP_ALLOC_BYTES_:  return TAU_CAST(tau_i64, test->result.allocBytes);
+        case TAU_TOP_PEAK_BYTES_:   return test->result.peakBytes;
+        case TAU_TOP_ASSERTIONS_:   return TAU_CAST(tau_i64, test->result.assertions);
+        default:                    return test->result.hasResources ? test->result.resources[metric] : 0;
+    }
+}
 
-        if(tauTestContext.foutput)
-            fprintf(tauTestContext.foutput, "<testcase name=\"%s\">", tauTestContext.tests[i].name);
+// Heaviest first; ties by name, then in registration order
+static int tauCompareTopTests(const void* const a, const void* const b) {
+    const tauTestSuiteStruct* const lhs = *TAU_PTRCAST(const tauTestSuiteStruct* const*, a);
+    const tauTestSuiteStruct* const rhs = *TAU_PTRCAST(const tauTestSuiteStruct* const*, b);
+    const tau_i64 lhsValue = tauTopValue(lhs, tauTopMetric);
+    const tau_i64 rhsValue = tauTopValue(rhs, tauTopMetric);
+    int byName;
+
+    if(lhsValue != rhsValue)
+        return lhsValue > rhsValue ? -1 : 1;
+    byName = strcmp(lhs->name, rhs->name);
+    if(byName != 0)
+        return byName;
+    return (lhs->index > rhs->index) - (lhs->index < rhs->index);
+}
 
-        // Start the timer
-        const double start = tauClock();
+static void tauPrintTopTestsBy(tauTestSuiteStruct** const tests, const tau_ull numTests, const int metric,
+                               const char* const title) {
+    int width = 0;
 
-        // The actual test
-        tauTestContext.tests[i].func();
+    tauTopMetric = metric;
+    qsort(tests, numTests, sizeof(tauTestSuiteStruct*), tauCompareTopTests);
+    if(numTests == 0 || tauTopValue(tests[0], metric) <= 0)
+        return;
 
-        // Stop the timer
-        const double duration = tauClock() - start;
+    for(tau_ull i = 0; i < numTests && i < tauNumTopTests && tauTopValue(tests[i], metric) > 0; i++) {
+        if(TAU_CAST(int, strlen(tests[i]->name)) > width)
+            width = TAU_CAST(int, strlen(tests[i]->name));
+    }
 
-        if(tauTestContext.foutput)
-            fprintf(tauTestContext.foutput, "</testcase>\n");
+    tauColouredPrintf(TAU_COLOUR_BOLD_, "\nHeaviest tests by %s:\n", title);
+    for(tau_ull i = 0; i < numTests && i < tauNumTopTests; i++) {
+        const tau_i64 value = tauTopValue(tests[i], metric);
+        if(value <= 0)
+            break;
+        printf("    %2" TAU_PRIu64 ". %-*s  ", TAU_CAST(tau_u64, i + 1), width, tests[i]->name);
+        if(metric == TAU_TOP_DURATION_)
+            tauClockPrintDuration(TAU_CAST(tau_u64, value));
+        else if(metric == TAU_TOP_ALLOC_BYTES_ || metric == TAU_TOP_PEAK_BYTES_ || metric == TAU_RESOURCE_RSS_ ||
+                metric == TAU_RESOURCE_MAX_RSS_)
+            tauPrintBytes(value, tau_false);
+        else
+            printf("%" TAU_PRId64, value);
+        printf("\n");
+    }
+}
 
-        if(hasCurrentTestFailed == 1) {
-            const tau_ull failed_testcase_index = tauStatsNumFailedTestSuites++;
-            tauStatsFailedTestSuites = TAU_PTRCAST(tau_ull*,
-                                            tau_realloc(TAU_PTRCAST(void*, tauStatsFailedTestSuites),
-                                                          sizeof(tau_ull) * tauStatsNumFailedTestSuites));
-            tauStatsFailedTestSuites[failed_testcase_index] = i;
-            tauStatsNumTestsFailed++;
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "[  FAILED  ] ");
-            tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s (", tauTestContext.tests[i].name);
-            tauClockPrintDuration(duration);
-            printf(")\n");
-        } else {
-            if(!tauDisplayOnlyFailedOutput) {
-                tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[       OK ] ");
-                tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%s (", tauTestContext.tests[i].name);
-                tauClockPrintDuration(duration);
-                printf(")\n");
-            }
+static void tauPrintTopTests() {
+    tauTestSuiteStruct** tests;
+    tau_ull numTests = 0;
+    int hasResources = 0;
+
+    tests = TAU_PTRCAST(tauTestSuiteStruct**, tauMalloc(sizeof(tauTestSuiteStruct*) * (tauTestContext.numTestSuites + 1)));
+    if(TAU_NONE(tests))
+        return;
+    for(tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+        if(test->result.status != TAU_TEST_NOT_RUN_) {
+            tests[numTests++] = test;
+            hasResources |= test->result.hasResources;
         }
     }
-    tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[==========] ");
-    tauColouredPrintf(TAU_COLOUR_DEFAULT_, "%" TAU_PRIu64 " test suites ran\n", tauStatsTestsRan);
-}
 
+    tauPrintTopTestsBy(tests, numTests, TAU_TOP_DURATION_, "duration");
+    tauPrintTopTestsBy(tests, numTests, TAU_TOP_ASSERTIONS_, "assertions");
+    if(hasResources) {
+        tauPrintTopTestsBy(tests, numTests, TAU_RESOURCE_MAX_RSS_, "peak RSS growth");
+        tauPrintTopTestsBy(tests, numTests, TAU_RESOURCE_RSS_, "RSS growth");
+        tauPrintTopTestsBy(tests, numTests, TAU_RESOURCE_MINOR_FAULTS_, "minor page faults");
+        tauPrintTopTestsBy(tests, numTests, TAU_RESOURCE_MAJOR_FAULTS_, "major page faults");
+        tauPrintTopTestsBy(tests, numTests, TAU_RESOURCE_VOLUNTARY_SWITCHES_, "voluntary context switches");
+        tauPrintTopTestsBy(tests, numTests, TAU_RESOURCE_INVOLUNTARY_SWITCHES_, "involuntary context switches");
+    }
+    if(tauAllocInterposed) {
+        tauPrintTopTestsBy(tests, numTests, TAU_TOP_ALLOC_BYTES_, "bytes allocated");
+        tauPrintTopTestsBy(tests, numTests, TAU_TOP_PEAK_BYTES_, "peak heap usage");
+    }
+    tauFree(TAU_PTRCAST(void*, tests));
+}
 
 static inline int tau_main(const int argc, const char* const * const argv);
 inline int tau_main(const int argc, const char* const * const argv) {
+#ifdef TAU_HAS_TEST_SECTION_
+    tauRegisterSectionTests();
+#endif // TAU_HAS_TEST_SECTION_
     tauStatsTotalTestSuites = TAU_CAST(tau_u64, tauTestContext.numTestSuites);
     tau_argv0_ = argv[0];
 
-    // Start the entire Test Session timer
-    const double start = tauClock();
-
     const tau_bool wasCmdLineReadSuccessful = tauCmdLineRead(argc, argv);
     if (tauDisplayTests)
         return tauCleanup();
@@ -1173,32 +7066,41 @@ inline int tau_main(const int argc, const char* const * const argv) {
     if(!wasCmdLineReadSuccessful)
         return tauCleanup();
 
-    for (tau_ull i = 0; i < tauTestContext.numTestSuites; i++) {
-        if(tauShouldFilterTest(cmd_filter, tauTestContext.tests[i].name))
-            tauStatsSkippedTests++;
+    if(!tauClockInit()) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: No usable cycle counter on this machine; "
+                                                    "timing tests with the monotonic clock instead\n");
     }
+    tauCountersInit();
 
-    tauStatsTestsRan = tauStatsTotalTestSuites - tauStatsSkippedTests;
+    // Start the entire Test Session timer
+    const tau_u64 start = tauClock();
+
+    tauLoadDurations();
+    tauStatsTestsRan = TAU_CAST(tau_u64, tauApplyFilter(cmd_filter));
+    if(tauPartitionCount > 0)
+        tauStatsTestsRan = TAU_CAST(tau_u64, tauApplyPartition());
+    tauStatsSkippedTests = tauStatsTotalTestSuites - tauStatsTestsRan;
 
     // Begin tests`
     tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[==========] ");
-    tauColouredPrintf(TAU_COLOUR_BOLD_, "Running %" TAU_PRIu64 " test suites.\n", TAU_CAST(tau_u64, tauStatsTestsRan));
-
-    if(tauTestContext.foutput) {
-        fprintf(tauTestContext.foutput, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-        fprintf(tauTestContext.foutput,
-                "<testsuites tests=\"%" TAU_PRIu64 "\" name=\"All\">\n",
-                TAU_CAST(tau_u64, tauStatsTestsRan));
-        fprintf(tauTestContext.foutput,
-                "<testsuite name=\"Tests\" tests=\"%" TAU_PRIu64 "\">\n",
-                TAU_CAST(tau_u64, tauStatsTestsRan));
+    if(tauPartitionCount > 0) {
+        tauColouredPrintf(TAU_COLOUR_BOLD_, "Running %" TAU_PRIu64 " test suites (shard %" TAU_PRIu64 " of %" TAU_PRIu64
+                                            ").\n", TAU_CAST(tau_u64, tauStatsTestsRan),
+                          TAU_CAST(tau_u64, tauPartitionIndex), TAU_CAST(tau_u64, tauPartitionCount));
+    } else {
+        tauColouredPrintf(TAU_COLOUR_BOLD_, "Running %" TAU_PRIu64 " test suites.\n", TAU_CAST(tau_u64, tauStatsTestsRan));
     }
 
+    if(tauTestContext.foutput)
+        tauXUnitBegin(tauXUnitPath, tauStatsTestsRan * (tauNumRepeats > 0 ? tauNumRepeats : 1));
+    if(TAU_SOME(tauStreamPath) && !tauStreamBegin(tauStreamPath))
+        tauColouredPrintf(TAU_COLOUR_BRIGHTYELLOW_, "WARNING: Could not open %s for writing\n", tauStreamPath);
+
     // Run tests
     tauRunTests();
 
     // End the entire Test Session timer
-    const double duration = tauClock() - start;
+    const tau_u64 duration = tauClock() - start;
 
     // Write a Summary
     tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "[  PASSED  ] %" TAU_PRIu64 " %s\n",
@@ -1218,6 +7120,19 @@ inline int tau_main(const int argc, const char* const * const argv) {
         printf("    Total warnings generated:   %" TAU_PRIu64 "\n", tauStatsNumWarnings);
         printf("    Total suites skipped:       %" TAU_PRIu64 "\n", tauStatsSkippedTests);
         printf("    Total suites failed:        %" TAU_PRIu64 "\n", tauStatsNumTestsFailed);
+        printf("    Total assertions:           %" TAU_PRIu64, tauStatsNumAssertions);
+        if(tauStatsNumAssertions > 0 && tauStatsTestsDuration > 0)
+            printf(" (%.0f per second of testing)",
+                   TAU_CAST(double, tauStatsNumAssertions) * 1e9 / TAU_CAST(double, tauStatsTestsDuration));
+        printf("\n");
+        if(tauStatsIterations > 1) {
+            printf("    Iterations:                 %" TAU_PRIu64 "\n", tauStatsIterations);
+            tauPrintFlakyTests();
+        }
+        if(tauAllocInterposed)
+            tauPrintAllocSummary();
+        if(tauNumTopTests > 0)
+            tauPrintTopTests();
     }
 
     if(tauStatsNumTestsFailed > 0) {
@@ -1228,10 +7143,21 @@ inline int tau_main(const int argc, const char* const * const argv) {
         tauClockPrintDuration(duration);
         printf("\n");
 
-        for (tau_ull i = 0; i < tauStatsNumFailedTestSuites; i++) {
-            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "  [ FAILED ] %s\n",
-                            tauTestContext.tests[tauStatsFailedTestSuites[i]].name);
+        for(const tauTestSuiteStruct* test = tauTestContext.tests; test; test = test->next) {
+            if(test->numFailures == 0)
+                continue;
+            tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "  [ FAILED ] %s", test->name);
+            if(tauStatsIterations > 1)
+                printf(" (%" TAU_PRIu64 " of %" TAU_PRIu64 " runs)", test->numFailures,
+                       test->numPasses + test->numFailures);
+            printf("\n");
         }
+    } else if(tauBenchNumRegressions > 0) {
+        tauColouredPrintf(TAU_COLOUR_BRIGHTRED_, "FAILED: ");
+        printf("%" TAU_PRIu64 " %s regressed; all %" TAU_PRIu64 " test suites passed in ", tauBenchNumRegressions,
+               tauBenchNumRegressions == 1 ? "benchmark" : "benchmarks", tauStatsTestsRan);
+        tauClockPrintDuration(duration);
+        printf("\n");
     } else if(tauStatsNumTestsFailed == 0 && tauStatsTotalTestSuites > 0) {
         const tau_u64 total_tests_passed = tauStatsTestsRan - tauStatsNumTestsFailed;
         tauColouredPrintf(TAU_COLOUR_BRIGHTGREEN_, "SUCCESS: ");
@@ -1245,7 +7171,9 @@ inline int tau_main(const int argc, const char* const * const argv) {
     }
 
     if(tauTestContext.foutput)
-        fprintf(tauTestContext.foutput, "</testsuite>\n</testsuites>\n");
+        tauXUnitEndWithCounts(tau_false);
+    if(tauStreamReport.open)
+        tauStreamEnd(tauStatsTotalTestSuites, duration);
 
     return tauCleanup();
 }
@@ -1264,22 +7192,33 @@ inline int tau_main(const int argc, const char* const * const argv) {
     compilation project (all testing source files).
     See: https://stackoverflow.com/questions/1856599/when-to-use-static-keyword-before-global-variables
 */
-#define TAU_ONLY_GLOBALS()                       \
-    volatile int checkIsInsideTestSuite = 0;     \
-    volatile int hasCurrentTestFailed = 0;       \
-    volatile int shouldFailTest = 0;             \
-    volatile int shouldAbortTest = 0;            \
-    tau_u64 tauStatsNumWarnings = 0;
+#define TAU_ONLY_GLOBALS()                                                   \
+    TAU_THREAD_LOCAL volatile int checkIsInsideTestSuite = 0;                \
+    TAU_THREAD_LOCAL volatile int hasCurrentTestFailed = 0;                  \
+    TAU_THREAD_LOCAL volatile int shouldFailTest = 0;                        \
+    TAU_THREAD_LOCAL volatile int shouldAbortTest = 0;                       \
+    TAU_THREAD_LOCAL tauCaptureStruct* tauCurrentCapture = TAU_NULL;         \
+    TAU_THREAD_LOCAL tauWatchStruct* tauCurrentWatch = TAU_NULL;             \
+    TAU_THREAD_LOCAL tau_u64 tauAssertionCount = 0;                          \
+    tau_u64 tauMaxFailuresPerTest = TAU_MAX_FAILURES_PER_TEST_;              \
+    TAU_THREAD_LOCAL tauFailureBudgetStruct tauFailureBudget;                \
+    TAU_THREAD_LOCAL tauContextStackStruct tauContextStack;                  \
+    tau_u64 tauStatsNumWarnings = 0;                                         \
+    tauClockStruct tauClockState = {0, 0, 0, 0};                             \
+    tauCounterConfigStruct tauCounterConfig = {0, {0}};                      \
+    TAU_THREAD_LOCAL tauCounterGroupStruct tauCounterGroup = {0, {0}};       \
+    TAU_THREAD_LOCAL tauAllocStatsStruct tauAllocStats = {0, 0, 0, 0, 0, 0}; \
+    int tauAllocInterposed = 0;
 
 // If a user wants to define their own `main()` function, this _must_ be at the very end of the functtion
 #define TAU_NO_MAIN()                                       \
-    tauTestStateStruct tauTestContext = {0, 0, 0};          \
+    tauTestStateStruct tauTestContext = {0, 0, 0, 0};          \
     TAU_ONLY_GLOBALS()
 
 // Define a main() function to call into tau.h and start executing tests.
 #define TAU_MAIN()                                                             \
     /* Define the global struct that will hold the data we need to run Tau. */ \
-    tauTestStateStruct tauTestContext = {0, 0, 0};                             \
+    tauTestStateStruct tauTestContext = {0, 0, 0, 0};                             \
     TAU_ONLY_GLOBALS()                                                         \
                                                                                \
     int main(const int argc, const char* const * const argv) {                 \
@@ -1289,8 +7228,15 @@ inline int tau_main(const int argc, const char* const * const argv) {
 #endif // TAU_NO_TESTING
 
 #ifdef TAU_NO_TESTING
-    volatile int checkIsInsideTestSuite = 0;
-    volatile int hasCurrentTestFailed = 0;
+    TAU_THREAD_LOCAL volatile int checkIsInsideTestSuite = 0;
+    TAU_THREAD_LOCAL volatile int hasCurrentTestFailed = 0;
+    TAU_THREAD_LOCAL tauCaptureStruct* tauCurrentCapture = TAU_NULL;
+    TAU_THREAD_LOCAL tau_u64 tauAssertionCount = 0;
+    tau_u64 tauMaxFailuresPerTest = 0;
+    TAU_THREAD_LOCAL tauFailureBudgetStruct tauFailureBudget;
+    TAU_THREAD_LOCAL tauContextStackStruct tauContextStack;
+    TAU_THREAD_LOCAL tauAllocStatsStruct tauAllocStats = {0, 0, 0, 0, 0, 0};
+    int tauAllocInterposed = 0;
     // volatile int shouldFailTest = 0;
     // volatile int shouldAbortTest = 0;
 #endif // TAU_NO_TESTING
@@ -1,3 +1,6 @@
+#if defined(__linux__)
+    #define _GNU_SOURCE     // popen(), readlink()
+#endif
 #include "tau/tau.h"
 
 TEST(c, CHECK_TF) {
@@ -228,4 +231,813 @@ TEST_F(MyTestF, c) {
 TEST_F(MyTestF, c2) {
     REQUIRE_EQ(42, tau->foo);
     tau->foo = 13;
-}
\ No newline at end of file
+}
+
+static int fib(const int n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+BENCH(c, fib) {
+    tau_do_not_optimize(fib(10));
+}
+
+struct MyBenchF {
+    int data[64];
+};
+
+TEST_F_SETUP(MyBenchF) {
+    for(int i = 0; i < 64; i++)
+        tau->data[i] = i;
+}
+
+TEST_F_TEARDOWN(MyBenchF) {
+    REQUIRE_EQ(63, tau->data[63]);
+}
+
+BENCH_F(MyBenchF, sum) {
+    int sum = 0;
+    tau_clobber();
+    for(int i = 0; i < 64; i++)
+        sum += tau->data[i];
+    tau_do_not_optimize(sum);
+}
+
+#if defined(__linux__)
+// The tests in the `child` suite fail (or hang) on purpose. They only do so when this binary is run again by
+// `runChild()`; in a normal run they pass straight away.
+static int isChild(void) {
+    return getenv("TAU_INTERNAL_CHILD") != NULL;
+}
+
+// Run the shell `command`, and return its exit status (-1 if it didn't exit), with what it printed
+static int runCommand(const char* const command, char* const output, const size_t size) {
+    char rest[2048];
+    FILE* pipe;
+    size_t used = 0;
+    size_t n;
+    int status;
+
+    output[0] = '\0';
+    pipe = popen(command, "r");
+    if(pipe == NULL)
+        return -1;
+    while(used < size - 1 && (n = fread(output + used, 1, size - 1 - used, pipe)) > 0)
+        used += n;
+    output[used] = '\0';
+    // Drain whatever didn't fit, so that the child doesn't block on a full pipe
+    while(fread(rest, 1, sizeof(rest), pipe) > 0) {}
+    status = pclose(pipe);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Run this binary again with `args` and the environment variables in `env` ("NAME=value ..."), and return its
+// exit status (-1 if it didn't exit), with what it printed
+static int runChildWithEnv(const char* const env, const char* const args, char* const output, const size_t size) {
+    char self[1024];
+    char command[2048];
+    const ssize_t length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+
+    output[0] = '\0';
+    if(length <= 0)
+        return -1;
+    self[length] = '\0';
+    snprintf(command, sizeof(command), "TAU_INTERNAL_CHILD=1 %s '%s' --no-color %s 2>&1", env, self, args);
+    return runCommand(command, output, size);
+}
+
+static int runChild(const char* const args, char* const output, const size_t size) {
+    return runChildWithEnv("", args, output, size);
+}
+
+// Where a child can write the report file called `name`, without clashing with other runs
+static void childFile(const char* const name, char* const path, const size_t size) {
+    snprintf(path, size, "/tmp/tau-internal-%d-%s", (int)getpid(), name);
+}
+
+// Whether the file at `path` has `text` in it (the file is removed)
+static int fileContains(const char* const path, const char* const text) {
+    tau_ull size;
+    char* const contents = tauReadFile(path, &size);
+    const int found = contents != NULL && memmem(contents, size, text, strlen(text)) != NULL;
+
+    free(contents);
+    remove(path);
+    return found;
+}
+
+// How many times `what` is in `text`
+static int countOccurrences(const char* const text, const char* const what) {
+    int count = 0;
+    for(const char* at = strstr(text, what); at != NULL; at = strstr(at + 1, what))
+        count++;
+    return count;
+}
+#endif // __linux__
+
+TEST(c, CHECK_NO_ALLOC) {
+    int sum = 0;
+    void* mem;
+
+    CHECK_NO_ALLOC {
+        for(int i = 0; i < 8; i++)
+            sum += i;
+    }
+    CHECK_EQ(sum, 28);
+
+    CHECK_ALLOCS_LE(2) {
+        mem = malloc(16);
+        mem = realloc(mem, 32);
+        free(mem);
+    }
+}
+
+#if defined(__linux__)
+TEST(child, allocatesInAllocBlocks) {
+    void* mem = NULL;
+
+    if(!isChild())
+        return;
+    CHECK_NO_ALLOC {
+        mem = malloc(16);
+        tau_do_not_optimize(mem);   // Or the compiler may drop the malloc()/free() pair altogether
+    }
+    free(mem);
+    CHECK_ALLOCS_LE(1) {
+        mem = malloc(16);
+        mem = realloc(mem, 32);
+    }
+    free(mem);
+}
+
+TEST(c, CHECK_NO_ALLOC_catches) {
+    char output[8192];
+
+    if(!tauAllocInterposed)
+        return;
+    CHECK_EQ(runChild("--filter=child.allocatesInAllocBlocks", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "In block : CHECK_NO_ALLOC\n"));
+    CHECK_NOT_NULL(strstr(output, "Actual : 1 allocations"));
+    CHECK_NOT_NULL(strstr(output, "In block : CHECK_ALLOCS_LE( 1 )"));
+    CHECK_NOT_NULL(strstr(output, "Actual : 2 allocations"));
+}
+#endif // __linux__
+
+TEST(c, TEST_TIMEOUT) {
+    TEST_TIMEOUT(60000);
+    CHECK(1);
+}
+
+#if defined(__linux__)
+TEST(child, hangs) {
+    volatile int forever = 1;
+
+    if(!isChild())
+        return;
+    TEST_TIMEOUT(50);
+    CHECK_EQ(1, 2);
+    while(forever) {}
+}
+
+TEST(c, TEST_TIMEOUT_expires) {
+    // Serially, on a `--jobs` worker and in an `--isolate` worker
+    const char* const args[] = { "--filter=child.hangs", "--filter=child.hangs:c.CHECK_TF --jobs=2",
+                                 "--filter=child.hangs --isolate" };
+    char output[16384];
+
+    for(int i = 0; i < 3; i++) {
+        TAU_CONTEXT("%s", args[i]) {
+            CHECK_EQ(runChild(args[i], output, sizeof(output)), 1);
+            CHECK_NOT_NULL(strstr(output, "Expected : 1 == 2"));
+            CHECK_NOT_NULL(strstr(output, "child.hangs (timed out after 50ms)"));
+        }
+    }
+}
+
+TEST(child, failsThenCrashes) {
+    if(!isChild())
+        return;
+    CHECK_EQ(1, 2);
+    printf("printed before the crash\n");
+    raise(SIGSEGV);
+}
+
+TEST(c, crash_keeps_earlier_failures) {
+    const char* const modes[] = { "--isolate", "--shards=2" };
+    char xunit[256];
+    char stream[256];
+    char args[1024];
+    char output[16384];
+
+    childFile("crash.xml", xunit, sizeof(xunit));
+    childFile("crash.bin", stream, sizeof(stream));
+    for(int i = 0; i < 2; i++) {
+        TAU_CONTEXT("%s", modes[i]) {
+            snprintf(args, sizeof(args), "--filter=child.failsThenCrashes:c.CHECK_TF %s --output=%s --emit=bin:%s",
+                     modes[i], xunit, stream);
+            CHECK_EQ(runChild(args, output, sizeof(output)), 1);
+            CHECK_NOT_NULL(strstr(output, "Expected : 1 == 2"));
+            CHECK_NOT_NULL(strstr(output, "printed before the crash"));
+            CHECK_NOT_NULL(strstr(output, "killed by SIGSEGV"));
+            CHECK_EQ(fileContains(xunit, "Expected : 1 == 2"), 1);
+            CHECK_EQ(fileContains(stream, "Expected : 1 == 2"), 1);
+        }
+    }
+}
+
+TEST(c, filter) {
+    // Each filter, and the tests it runs (in the order they're registered)
+    const char* const filters[][2] = {
+        { "c11.CHECK_??", "c11.CHECK_NE c11.CHECK_LT c11.CHECK_LE c11.CHECK_GT c11.CHECK_GE" },
+        { "c11.*QUIRE*EQ", "c11.REQUIRE_EQ c11.REQUIRE_STREQ c11.REQUIRE_SUBSTREQ c11.REQUIRE_BUF_EQ" },
+        { "c11.CHECK_NE:c11.REQUIRE_NE:c.CHECK_TF", "c.CHECK_TF c11.REQUIRE_NE c11.CHECK_NE" },
+        { "c11.*-*CHECK*:*_GE", "c11.REQUIRE_EQ c11.REQUIRE_NE c11.REQUIRE_LT c11.REQUIRE_LE c11.REQUIRE_GT "
+                                "c11.REQUIRE_STREQ c11.REQUIRE_SUBSTREQ c11.no_double_eval c11.REQUIRE_BUF_EQ "
+                                "c11.REQUIRE_BUF_NE" },
+        { "c11.?EQUIRE_*E?-c11.*_NE", "c11.REQUIRE_EQ c11.REQUIRE_STREQ c11.REQUIRE_SUBSTREQ c11.REQUIRE_BUF_EQ" },
+        { "c11.CHECK_E:no.such.test", "" },
+    };
+    char args[256];
+    char output[16384];
+    char ran[4096];
+
+    for(size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++) {
+        TAU_CONTEXT("--filter=%s", filters[i][0]) {
+            size_t used = 0;
+
+            snprintf(args, sizeof(args), "'--filter=%s'", filters[i][0]);
+            CHECK_EQ(runChild(args, output, sizeof(output)), 0);
+            ran[0] = '\0';
+            for(const char* run = strstr(output, "[ RUN      ] "); run != NULL; run = strstr(run + 1, "[ RUN      ] ")) {
+                const char* const name = run + strlen("[ RUN      ] ");
+                used += snprintf(ran + used, sizeof(ran) - used, "%s%.*s", used > 0 ? " " : "",
+                                 (int)strcspn(name, "\n"), name);
+            }
+            CHECK_STREQ(ran, filters[i][1]);
+        }
+    }
+}
+
+TEST(c, shards_option) {
+    const char* const values[] = { "", "x", "2x", "0" };
+    char args[256];
+    char output[16384];
+
+    for(int i = 0; i < 4; i++) {
+        TAU_CONTEXT("--shards=%s", values[i]) {
+            snprintf(args, sizeof(args), "--filter=c.CHECK_TF --shards=%s", values[i]);
+            runChild(args, output, sizeof(output));
+            CHECK_NOT_NULL(strstr(output, "ERROR: Invalid value for --shards"));
+            CHECK_NULL(strstr(output, "[ RUN      ]"));
+        }
+    }
+}
+
+static char shardOutputs[3][16384];
+
+TEST(c, shards_cover_every_test) {
+    // The shard is picked on the command line, or by either set of environment variables; and the tests are
+    // split by count, or by the durations of an earlier run
+    const char* const modes[] = { "--shard-index", "TAU_", "GTEST_", "--shard-by=duration" };
+    const char* const durations = "5000000 c11.REQUIRE_EQ\n3000000 c11.CHECK_LT\n2000000 c11.CHECK_STREQ\n";
+    char durationsFile[256];
+    char env[256];
+    char args[1024];
+    char output[16384];
+
+    childFile("durations", durationsFile, sizeof(durationsFile));
+    CHECK_EQ(runChild("--filter=c11.*", output, sizeof(output)), 0);
+    for(int mode = 0; mode < 4; mode++) {
+        TAU_CONTEXT("%s", modes[mode]) {
+            const int byEnv = mode == 1 || mode == 2;
+            int numRun = 0;
+
+            for(int shard = 0; shard < 3; shard++) {
+                if(mode == 3) {
+                    // Each shard reads the same durations, as if it ran on a machine of its own
+                    FILE* const file = fopen(durationsFile, "w");
+                    REQUIRE(file != NULL);
+                    fputs(durations, file);
+                    fclose(file);
+                }
+                env[0] = '\0';
+                if(byEnv)
+                    snprintf(env, sizeof(env), "%sSHARD_INDEX=%d %sTOTAL_SHARDS=3", modes[mode], shard, modes[mode]);
+                snprintf(args, sizeof(args), "--filter=c11.*");
+                if(!byEnv)
+                    snprintf(args + strlen(args), sizeof(args) - strlen(args), " --shard-index=%d --shard-count=3",
+                             shard);
+                if(mode == 3)
+                    snprintf(args + strlen(args), sizeof(args) - strlen(args), " --shard-by=duration --durations=%s",
+                             durationsFile);
+                CHECK_EQ(runChildWithEnv(env, args, shardOutputs[shard], sizeof(shardOutputs[shard])), 0);
+                CHECK_NOT_NULL(strstr(shardOutputs[shard], " of 3)."));
+                numRun += countOccurrences(shardOutputs[shard], "[ RUN      ] ");
+            }
+
+            // Every test runs in exactly one of the shards
+            CHECK_EQ(numRun, countOccurrences(output, "[ RUN      ] "));
+            for(const char* run = strstr(output, "[ RUN      ] "); run != NULL; run = strstr(run + 1, "[ RUN      ] ")) {
+                const char* const eol = strchr(run, '\n');
+                char line[256];
+                int found = 0;
+
+                REQUIRE(eol != NULL);
+                snprintf(line, sizeof(line), "%.*s", (int)(eol + 1 - run), run);
+                for(int shard = 0; shard < 3; shard++)
+                    found += strstr(shardOutputs[shard], line) != NULL;
+                CHECKF(found == 1, "%s", line);
+            }
+        }
+    }
+    remove(durationsFile);
+}
+
+// The `[ RUN      ]` lines of `output`, in the order the tests ran
+static void runOrder(const char* const output, char* const order, const size_t size) {
+    size_t used = 0;
+
+    order[0] = '\0';
+    for(const char* run = strstr(output, "[ RUN      ] "); run != NULL; run = strstr(run + 1, "[ RUN      ] ")) {
+        const char* const eol = strchr(run, '\n');
+        const size_t length = eol != NULL ? (size_t)(eol + 1 - run) : strlen(run);
+        if(used + length >= size)
+            break;
+        memcpy(order + used, run, length);
+        used += length;
+        order[used] = '\0';
+    }
+}
+
+TEST(c, shuffle_is_reproducible) {
+    char output[16384];
+    char first[4096];
+    char again[4096];
+    char unshuffled[4096];
+
+    CHECK_EQ(runChild("--filter=c11.* --shuffle=1234 --repeat=2", output, sizeof(output)), 0);
+    CHECK_NOT_NULL(strstr(output, "Shuffling tests with seed 1234\n"));
+    runOrder(output, first, sizeof(first));
+    CHECK_EQ(runChild("--filter=c11.* --shuffle=1234 --repeat=2", output, sizeof(output)), 0);
+    runOrder(output, again, sizeof(again));
+    CHECK_STREQ(again, first);
+    CHECK_EQ(runChild("--filter=c11.* --repeat=2", output, sizeof(output)), 0);
+    runOrder(output, unshuffled, sizeof(unshuffled));
+    CHECK_STRNE(unshuffled, first);
+}
+
+TEST(child, failsEveryOtherRun) {
+    static int numRuns = 0;
+
+    if(!isChild())
+        return;
+    CHECK(numRuns++ % 2 == 0);
+}
+
+TEST(c, flaky_tests_summary) {
+    char output[16384];
+    const char* flaky;
+
+    CHECK_EQ(runChild("--filter=child.failsEveryOtherRun:c.CHECK_TF --repeat=4", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "Iterations:                 4\n"));
+    flaky = strstr(output, "\nFlaky tests:\n");
+    REQUIRE(flaky != NULL);
+    CHECK_NOT_NULL(strstr(flaky, "    child.failsEveryOtherRun  2 passed, "));
+    CHECK_NOT_NULL(strstr(flaky, "2 failed"));
+    CHECK_NOT_NULL(strstr(flaky, " (50.0% of runs)\n"));
+    CHECK_NULL(strstr(flaky, "c.CHECK_TF"));
+
+    // A test that fails every time isn't flaky
+    CHECK_EQ(runChild("--filter=child.failsWithMessages:c.CHECK_TF --repeat=2", output, sizeof(output)), 1);
+    CHECK_NULL(strstr(output, "Flaky tests:"));
+}
+
+TEST(child, failsWithMarkup) {
+    if(!isChild())
+        return;
+    CHECKF(1 > 2, "<tag attr=\"a & b\">'quoted'</tag>");
+}
+
+// The records of the stream file at `path`, one word each: the test's name for START, F for ASSERTION_FAILURE,
+// M for METRICS, the status for END and how many tests ran and failed for SUMMARY
+static int readStream(const char* const path, char* const records, const size_t size) {
+    tau_ull fileSize;
+    char* const contents = tauReadFile(path, &fileSize);
+    tauStreamHeaderStruct header;
+    size_t offset = sizeof(header);
+    size_t used = 0;
+
+    records[0] = '\0';
+    if(contents == NULL || fileSize < sizeof(header)) {
+        free(contents);
+        return 0;
+    }
+    memcpy(&header, contents, sizeof(header));
+    if(memcmp(header.magic, TAU_STREAM_MAGIC, sizeof(header.magic)) != 0 || header.version != TAU_STREAM_VERSION ||
+       header.byteOrder != TAU_STREAM_BYTE_ORDER) {
+        free(contents);
+        return 0;
+    }
+
+    while(offset + sizeof(tauStreamRecordStruct) <= fileSize && used < size) {
+        const char* const payload = contents + offset + sizeof(tauStreamRecordStruct);
+        tauStreamRecordStruct record;
+        tauStreamTestStartStruct start;
+        tauStreamTestEndStruct end;
+        tauStreamSummaryStruct summary;
+
+        memcpy(&record, contents + offset, sizeof(record));
+        if(offset + sizeof(record) + record.size > fileSize)
+            break;
+        if(record.type == TAU_STREAM_TEST_START) {
+            memcpy(&start, payload, sizeof(start));
+            used += snprintf(records + used, size - used, "%.*s ", (int)start.nameSize, payload + sizeof(start));
+        } else if(record.type == TAU_STREAM_ASSERTION_FAILURE) {
+            used += snprintf(records + used, size - used, "F ");
+        } else if(record.type == TAU_STREAM_METRICS) {
+            used += snprintf(records + used, size - used, "M ");
+        } else if(record.type == TAU_STREAM_TEST_END) {
+            memcpy(&end, payload, sizeof(end));
+            used += snprintf(records + used, size - used, "%s ",
+                             end.status == TAU_STREAM_STATUS_PASSED ? "passed" : "failed");
+        } else if(record.type == TAU_STREAM_SUMMARY) {
+            memcpy(&summary, payload, sizeof(summary));
+            used += snprintf(records + used, size - used, "%d/%d", (int)summary.ran, (int)summary.failed);
+        }
+        offset += sizeof(record) + record.size;
+    }
+    free(contents);
+    return offset == fileSize;
+}
+
+TEST(c, stream_and_TauConvert) {
+    char stream[256];
+    char records[1024];
+    char command[1024];
+    char output[16384];
+
+    childFile("records.bin", stream, sizeof(stream));
+    snprintf(command, sizeof(command), "--filter=c.CHECK_TF:child.failsWithMarkup --resources --emit=bin:%s", stream);
+    CHECK_EQ(runChild(command, output, sizeof(output)), 1);
+    CHECK_EQ(readStream(stream, records, sizeof(records)), 1);
+    CHECK_STREQ(records, "c.CHECK_TF M passed child.failsWithMarkup F M failed 2/1");
+
+#ifdef TAU_CONVERT_PATH
+    snprintf(command, sizeof(command), "'%s' junit '%s' 2>&1", TAU_CONVERT_PATH, stream);
+    CHECK_EQ(runCommand(command, output, sizeof(output)), 0);
+    CHECK_NOT_NULL(strstr(output, "<testsuites tests=\"2\" failures=\"1\" name=\"All\">\n"));
+    CHECK_NOT_NULL(strstr(output, "<testcase classname=\"c\" name=\"CHECK_TF\" "));
+    CHECK_NOT_NULL(strstr(output, "<testcase classname=\"child\" name=\"failsWithMarkup\" "));
+    CHECK_NOT_NULL(strstr(output, "<property name=\"minor-faults\" value=\""));
+    CHECK_NOT_NULL(strstr(output, "Message : &lt;tag attr=&quot;a &amp; b&quot;&gt;&apos;quoted&apos;&lt;/tag&gt;"));
+    CHECK_NULL(strstr(output, "<tag"));
+    CHECK_NOT_NULL(strstr(output, "</failure></testcase>\n"));
+#endif // TAU_CONVERT_PATH
+    remove(stream);
+}
+
+// Write a benchmark baseline in which `c.fib` takes `ns` nanoseconds per call
+static void writeBaseline(const char* const path, const char* const ns) {
+    FILE* const file = fopen(path, "w");
+    if(file == NULL)
+        return;
+    fprintf(file, "# Tau benchmark samples (ns/op)\nc.fib 8");
+    for(int i = 0; i < 8; i++)
+        fprintf(file, " %s", ns);
+    fprintf(file, "\n");
+    fclose(file);
+}
+
+TEST(c, bench_compare) {
+    char baseline[256];
+    char args[1024];
+    char output[16384];
+
+    // What --bench-save writes
+    childFile("bench.txt", baseline, sizeof(baseline));
+    snprintf(args, sizeof(args), "--filter=c.fib --bench-save=%s", baseline);
+    CHECK_EQ(runChild(args, output, sizeof(output)), 0);
+    CHECK_EQ(fileContains(baseline, "# Tau benchmark samples (ns/op)\nc.fib 8 "), 1);
+
+    // A benchmark that got a lot slower fails the run...
+    writeBaseline(baseline, "0.001");
+    snprintf(args, sizeof(args), "--filter=c.fib:MyBenchF.sum --bench-compare=%s", baseline);
+    CHECK_EQ(runChild(args, output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "Comparing 2 benchmarks against "));
+    CHECK_NOT_NULL(strstr(output, "(threshold 5.0%)\n"));
+    CHECK_NOT_NULL(strstr(output, "[  SLOWER  ] c.fib: median "));
+    CHECK_NOT_NULL(strstr(output, "[   NEW    ] MyBenchF.sum (not in the baseline)\n"));
+    CHECK_NOT_NULL(strstr(output, "[  FAILED  ] 1 benchmark regressed\n"));
+
+    // ...unless the slowdown is within the threshold...
+    snprintf(args, sizeof(args), "--filter=c.fib --bench-compare=%s --bench-threshold=1e12", baseline);
+    CHECK_EQ(runChild(args, output, sizeof(output)), 0);
+    CHECK_NOT_NULL(strstr(output, "[   SAME   ] c.fib: median "));
+    CHECK_NULL(strstr(output, "regressed"));
+
+    // ...and one that got faster doesn't
+    writeBaseline(baseline, "1000000000");
+    snprintf(args, sizeof(args), "--filter=c.fib --bench-compare=%s", baseline);
+    CHECK_EQ(runChild(args, output, sizeof(output)), 0);
+    CHECK_NOT_NULL(strstr(output, "[  FASTER  ] c.fib: median "));
+    CHECK_NULL(strstr(output, "regressed"));
+    remove(baseline);
+}
+
+static unsigned char bufActual[4096];
+static unsigned char bufExpected[4096];
+
+TEST(child, buffersDiffer) {
+    if(!isChild())
+        return;
+    for(int i = 0; i < 4096; i++)
+        bufActual[i] = bufExpected[i] = (unsigned char)('a' + i % 26);
+
+    // A byte that differs, shown with the rows around it...
+    bufActual[100] = 'X';
+    CHECK_BUF_EQ(bufActual, bufExpected, 256);
+    // ...a long run of them, of which only the ends are shown...
+    memset(bufActual + 160, 0, 80);
+    CHECK_BUF_EQ(bufActual + 128, bufExpected + 128, 128);
+    // ...and more runs than are shown
+    for(int i = 1024; i < 4096; i += 64)
+        bufActual[i] = '.';
+    CHECK_BUF_EQ(bufActual + 1024, bufExpected + 1024, 3072);
+}
+
+TEST(c, CHECK_BUF_EQ_dump) {
+    // The differing bytes are coloured even with `--no-color`, as in CHECK_STREQ_diff
+    char output[32768];
+    char* one;
+    char* run;
+    char* runs;
+
+    CHECK_EQ(runChild("--filter=child.buffersDiffer", output, sizeof(output)), 1);
+    one = strstr(output, "not equal (1 byte differs, at offset 100)\n");
+    run = strstr(output, "not equal (80 bytes differ, from offset 32 to 111)\n");
+    runs = strstr(output, "not equal (48 bytes differ, from offset 0 to 3008)\n");
+    REQUIRE(one != NULL && run != NULL && runs != NULL);
+    REQUIRE(one < run && run < runs);
+    run[-1] = runs[-1] = '\0';
+
+    // The rows from 16 bytes before the difference to 16 bytes after it
+    CHECK_NOT_NULL(strstr(one, "    00000050  actual               67 68 69 6A 6B 6C 6D 6E 6F 70 71 72  "
+                               "|    ghijklmnopqr|\n"));
+    CHECK_NOT_NULL(strstr(one, "              expected 73 74 75 76 "));
+    CHECK_NOT_NULL(strstr(one, "    00000070  actual   69 6A 6B 6C 6D                                   "
+                               "|ijklm           |\n"));
+    CHECK_NULL(strstr(one, "00000040"));
+    CHECK_NULL(strstr(one, "00000080"));
+
+    // The ends of the long run
+    CHECK_NOT_NULL(strstr(run, "    00000010  actual   6F 70 71 72 73 74 75 76 77 78 79 7A 61 62 63 64  "
+                               "|opqrstuvwxyzabcd|\n"));
+    CHECK_NOT_NULL(strstr(run, "    ... (48 bytes)\n"));
+    CHECK_NOT_NULL(strstr(run, "    00000070  actual   67 68 69 6A 6B 6C 6D 6E 6F 70 71 72 73 74 75 76  "
+                               "|ghijklmnopqrstuv|\n"));
+    CHECK_NULL(strstr(run, "00000040"));
+
+    // The first TAU_BUF_DIFF_MAX_RUNS runs, and where the last difference is
+    CHECK_EQ(countOccurrences(runs, "    ...\n"), TAU_BUF_DIFF_MAX_RUNS - 1);
+    CHECK_NOT_NULL(strstr(runs, "    000001c0  actual   "));
+    CHECK_NULL(strstr(runs, "00000200"));
+    CHECK_NOT_NULL(strstr(runs, "    ... (more differences, up to offset 3008)\n"));
+}
+
+TEST(c, XUnit_counts) {
+    // Whether the run finishes, or is abandoned when a test times out
+    const char* const filters[] = { "child.failsThenCrashes:c.CHECK_TF --isolate", "c.CHECK_TF:child.hangs" };
+    char xunit[256];
+    char args[1024];
+    char output[16384];
+
+    childFile("counts.xml", xunit, sizeof(xunit));
+    for(int i = 0; i < 2; i++) {
+        TAU_CONTEXT("%s", filters[i]) {
+            tau_ull size;
+            char* contents;
+
+            snprintf(args, sizeof(args), "--filter=%s --output=%s", filters[i], xunit);
+            CHECK_EQ(runChild(args, output, sizeof(output)), 1);
+            contents = tauReadFile(xunit, &size);
+            REQUIRE(contents != NULL);
+            CHECK_NOT_NULL(strstr(contents, "<testsuites tests=\"2\"                    failures=\"1\" "));
+            CHECK_NOT_NULL(strstr(contents, "<testsuite name=\"Tests\" tests=\"2\"                    failures=\"1\" "));
+            free(contents);
+            remove(xunit);
+        }
+    }
+}
+#endif // __linux__
+
+TEST(c, CHECK_ARRAY_EQ) {
+    float values[40];
+    float copy[40];
+    int ints[40];
+    int intCopy[40];
+
+    for(int i = 0; i < 40; i++) {
+        values[i] = copy[i] = i * 0.5f;
+        ints[i] = intCopy[i] = -i;
+    }
+    CHECK_ARRAY_EQ(values, copy, 40);
+    REQUIRE_ARRAY_EQ(ints, intCopy, 40);
+}
+
+TEST(c, CHECK_ARRAY_NEAR) {
+    double values[40];
+    double expected[40];
+
+    for(int i = 0; i < 40; i++) {
+        expected[i] = i * 0.1;
+        values[i] = expected[i] + 1e-12;
+    }
+    CHECK_ARRAY_NEAR(values, expected, 40, 1e-9, 0);
+    REQUIRE_ARRAY_NEAR(values, expected, 40, 1e-9, 1e-6);
+    CHECK_ARRAY_ULP(values, values, 40, 0);
+}
+
+#if defined(__linux__)
+TEST(child, stringsDiffer) {
+    if(!isChild())
+        return;
+    // A line diff...
+    CHECK_STREQ("one\ntwo\nthree\nfour\nfive\nsix\nseven\neight\nnine\nten\n",
+                "one\ntwo\nthree\nfour\nfive\nsix\nSEVEN\neight\nnine\nten\n");
+    // ...a character diff...
+    CHECK_STREQ("The quick brown fox jumps over the lazy dog, and the lazy dog doesn't even notice it, poor thing",
+                "The quick brown fox jumps over the lazy cat, and the lazy dog doesn't even notice it, poor thing");
+}
+
+TEST(child, stringsDifferTooMuch) {
+    const size_t size = TAU_STR_DIFF_MAX_TOKENS + 64;
+    char* const actual = (char*)malloc(size + 1);
+    char* const expected = (char*)malloc(size + 1);
+
+    if(!isChild())
+        return;
+    REQUIRE(actual != NULL && expected != NULL);
+    // ...and one that's too long to diff, as the differences are at either end
+    memset(actual, 'a', size);
+    memset(expected, 'a', size);
+    actual[0] = 'x';
+    actual[size - 1] = 'y';
+    actual[size] = expected[size] = '\0';
+    CHECK_STREQ(actual, expected);
+    free(actual);
+    free(expected);
+}
+
+TEST(c, CHECK_STREQ_diff) {
+    // The changed parts are coloured even with `--no-color` (which only reaches main.c's copy of the flag), so
+    // these only look at what's between the colour changes
+    char output[16384];
+
+    CHECK_EQ(runChild("--filter=child.stringsDiffer", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "not equal (first difference at line 7, column 1)"));
+    CHECK_NOT_NULL(strstr(output, "@@ -4,7 +4,7 @@"));
+    CHECK_NOT_NULL(strstr(output, "     six\n"));
+    CHECK_NOT_NULL(strstr(output, "-SEVEN\n"));
+    CHECK_NOT_NULL(strstr(output, "+seven\n"));
+    CHECK_NOT_NULL(strstr(output, "     ten\n"));
+    CHECK_NULL(strstr(output, "three\n"));
+    CHECK_NOT_NULL(strstr(output, "not equal (first difference at offset 40)"));
+    CHECK_NOT_NULL(strstr(output, "@@ -25,35 +25,35 @@"));
+    CHECK_NOT_NULL(strstr(output, "-s over the lazy "));
+    CHECK_NOT_NULL(strstr(output, "+s over the lazy "));
+
+    CHECK_EQ(runChild("--filter=child.stringsDifferTooMuch", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "(too many differences to diff, showing where they start)"));
+    CHECK_NOT_NULL(strstr(output, "+xaaaa"));
+    CHECK_NULL(strstr(output, "@@"));
+}
+#endif // __linux__
+
+static int numFormatted = 0;
+
+static int countFormatted(const int value) {
+    numFormatted++;
+    return value;
+}
+
+TEST(c, CHECKF) {
+    for(int i = 0; i < 16; i++) {
+        CHECKF(i < 16, "i = %d", countFormatted(i));
+        CHECK_LE_MSG(i, 15, "i = %d", countFormatted(i));
+        REQUIRE_EQ_MSG(i * 2, i + i, "%s: %d", "doubling", countFormatted(i));
+    }
+    CHECK_EQ(numFormatted, 0);
+}
+
+#if defined(__linux__)
+TEST(child, failsWithMessages) {
+    if(!isChild())
+        return;
+    numFormatted = 0;
+    for(int i = 0; i < 8; i++) {
+        CHECKF(i < 0, "i = %d", countFormatted(i));
+        CHECK_EQ_MSG(i, -1, "i = %d", countFormatted(i));
+    }
+    printf("messages formatted: %d\n", numFormatted);
+}
+
+TEST(c, CHECKF_over_the_failure_budget) {
+    // Only the messages of the failures that are reported get formatted
+    char output[16384];
+
+    CHECK_EQ(runChild("--filter=child.failsWithMessages --max-failures-per-test=3", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "messages formatted: 3\n"));
+    CHECK_EQ(runChild("--filter=child.failsWithMessages --max-failures-per-test=0", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "messages formatted: 16\n"));
+}
+
+TEST(c, suppressed_failures_summary) {
+    // The child's two assertions fail 8 times each; the first 3 failures are reported
+    char output[16384];
+
+    CHECK_EQ(runChild("--filter=child.failsWithMessages --max-failures-per-test=3", output, sizeof(output)), 1);
+    CHECK_EQ(countOccurrences(output, "Message : i = "), 3);
+    CHECK_NOT_NULL(strstr(output, "13 more failed assertions not shown"));
+    CHECK_NOT_NULL(strstr(output, " (--max-failures-per-test=3):\n"));
+    CHECK_NOT_NULL(strstr(output, "failed 6 more times\n"));
+    CHECK_NOT_NULL(strstr(output, "failed 7 more times\n"));
+    CHECK_EQ(countOccurrences(output, "test.c:"), 3 + 2);
+
+    CHECK_EQ(runChild("--filter=child.failsWithMessages --max-failures-per-test=0", output, sizeof(output)), 1);
+    CHECK_EQ(countOccurrences(output, "Message : i = "), 16);
+    CHECK_NULL(strstr(output, "not shown"));
+}
+#endif // __linux__
+
+TEST(c, TAU_CONTEXT) {
+    const char* const name = "values";
+    int sum = 0;
+
+    for(int i = 0; i < 8; i++) {
+        TAU_CONTEXT("%s[%d]", name, i) {
+            TAU_CONTEXT("sum so far: %d", sum)
+                CHECK_GE(sum, 0);
+            if(i % 2 == 1)
+                continue;   // Goes to the end of the TAU_CONTEXT() block
+            sum += i;
+        }
+    }
+    CHECK_EQ(sum, 12);
+    CHECK_EQ(tauContextStack.depth, 0);
+}
+
+#if defined(__linux__)
+static void requireInContext(void) {
+    TAU_CONTEXT("in %s", "requireInContext") {
+        REQUIRE_EQ(1, 2);
+    }
+}
+
+struct child {
+    int tornDown;
+};
+
+TEST_F_SETUP(child) {
+    tau->tornDown = 0;
+}
+
+TEST_F_TEARDOWN(child) {
+    if(isChild())
+        CHECK_EQ(tau->tornDown, 1);
+}
+
+TEST_F(child, requiresInContext) {
+    (void)tau;
+    if(!isChild())
+        return;
+    requireInContext();
+    CHECK_EQ(3, 4);
+}
+
+TEST(child, breaksOutOfContext) {
+    if(!isChild())
+        return;
+    for(int i = 0; i < 2; i++) {
+        TAU_CONTEXT("i = %d", i) {
+            break;
+        }
+    }
+}
+
+TEST(c, TAU_CONTEXT_is_left) {
+    char output[16384];
+    int shown = 0;
+
+    // Neither the failure after the helper's REQUIRE nor the teardown is in the helper's block
+    CHECK_EQ(runChild("--filter=child.requiresInContext", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "Expected : 3 == 4"));
+    CHECK_NOT_NULL(strstr(output, "Expected : tau->tornDown == 1"));
+    for(const char* at = strstr(output, "in requireInContext"); at; at = strstr(at + 1, "in requireInContext"))
+        shown++;
+    CHECK_EQ(shown, 1);
+
+    CHECK_EQ(runChild("--filter=child.breaksOutOfContext", output, sizeof(output)), 1);
+    CHECK_NOT_NULL(strstr(output, "`break` only leaves the block in C"));
+    CHECK_NOT_NULL(strstr(output, "Context : i = 0"));
+    CHECK_NOT_NULL(strstr(output, "Context : i = 1"));
+}
+#endif // __linux__
\ No newline at end of file
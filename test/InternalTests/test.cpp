@@ -1,4 +1,5 @@
 #include <tau/tau.h>
+#include <vector>
 // Only MSVC seems to complain about this
 // Most likely because we're trying to cross-compile with `main.c` and `test.cpp`
 #ifdef _MSC_VER
@@ -385,7 +386,7 @@ TEST_F_SETUP(Stack) {
 }
 
 TEST_F_TEARDOWN(Stack) {
-
+    (void)tau;
 }
 
 TEST_F(Stack, TestStackDetails) {
@@ -393,4 +394,78 @@ TEST_F(Stack, TestStackDetails) {
     CHECK_EQ(tau->age, 4);
     REQUIRE_STREQ(tau->name, "Hello");
     REQUIRE_EQ(tau->pop(), 123);
+}
+
+BENCH(cpp, vector_push_back) {
+    std::vector<int> values;
+    for(int i = 0; i < 16; i++)
+        values.push_back(i);
+    tau_do_not_optimize(values.data());
+}
+
+TEST(cpp, CHECK_ALLOCS_LE) {
+    int values[16];
+
+    CHECK_NO_ALLOC {
+        for(int i = 0; i < 16; i++)
+            values[i] = i * i;
+    }
+    CHECK_EQ(values[15], 225);
+
+    CHECK_ALLOCS_LE(1) {
+        int* const mem = static_cast<int*>(malloc(sizeof(int) * 4));
+        CHECK_NOT_NULL(mem);
+        free(mem);
+    }
+}
+
+TEST(cpp, CHECK_ARRAY_ULP) {
+    std::vector<float> values(100);
+    std::vector<float> expected(100);
+
+    for(int i = 0; i < 100; i++) {
+        expected[i] = i / 3.0f;
+        values[i] = (i / 3.0f) * 1.0000001f;
+    }
+    CHECK_ARRAY_ULP(values.data(), expected.data(), values.size(), 4);
+    REQUIRE_ARRAY_NEAR(values.data(), expected.data(), values.size(), 0, 1e-6);
+    CHECK_ARRAY_EQ(expected.data(), expected.data(), expected.size());
+}
+
+TEST(cpp, TAU_CONTEXT) {
+    const std::vector<double> values(10, 0.5);
+
+    for(size_t i = 0; i < values.size(); i++) {
+        TAU_CONTEXT("values[%zu] == %g", i, values[i]) {
+            CHECKF(values[i] > 0, "%g is not positive", values[i]);
+            REQUIRE_LT_MSG(values[i], 1.0, "at index %zu", i);
+        }
+    }
+    CHECK_EQ(tauContextStack.depth, 0);
+}
+
+static int depthWhenReturning(const int at) {
+    for(int i = 0;; i++) {
+        TAU_CONTEXT("i = %d", i) {
+            if(i == at)
+                return tauContextStack.depth;
+        }
+    }
+}
+
+TEST(cpp, TAU_CONTEXT_is_left) {
+    int sum = 0;
+
+    for(int i = 0; i < 8; i++) {
+        TAU_CONTEXT("i = %d", i) {
+            if(i % 2 == 1)
+                continue;
+            if(i == 6)
+                break;
+            sum += i;
+        }
+    }
+    CHECK_EQ(sum, 6);
+    CHECK_EQ(depthWhenReturning(3), 1);
+    CHECK_EQ(tauContextStack.depth, 0);
 }
\ No newline at end of file
@@ -0,0 +1,520 @@
+/*
+ _______          _    _
+|__   __|  /\    | |  | |
+   | |    /  \   | |  | |  Tau - The Micro Testing Framework for C/C++
+   | |   / /\ \  | |  | |  Language: C
+   | |  / ____ \ | |__| |  https://github.com/jasmcaus/tau
+   |_| /_/    \_\ \____/
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>
+SPDX-License-Identifier: MIT
+Copyright (c) 2021 Jason Dsouza <@jasmcaus>
+*/
+
+/**
+    TauConvert: turns the binary result stream written by `--emit=bin:<FILE>` into JUnit XML, JSON or TAP.
+
+        TauConvert <junit|json|tap> <FILE> [OUTPUT]
+
+    Tests are converted one at a time as their END record comes by, so memory use doesn't grow with the size of
+    the run. A test the stream ends in the middle of (the run crashed or was killed) is reported as failed.
+*/
+#include <tau/stream.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAU_CONVERT_JUNIT   1
+#define TAU_CONVERT_JSON    2
+#define TAU_CONVERT_TAP     3
+
+typedef struct tauConvertBufferStruct {
+    char* data;
+    size_t size;
+    size_t capacity;
+} tauConvertBufferStruct;
+
+// The test whose records are being read
+typedef struct tauConvertTestStruct {
+    int open;
+    tauStreamTestStartStruct start;
+    tauConvertBufferStruct name;
+    tauConvertBufferStruct file;
+    tauConvertBufferStruct failures;    // ASSERTION_FAILURE payloads, one after the other
+    tau_u64 numFailures;
+    tauConvertBufferStruct metrics;     // The METRICS payload, if any
+} tauConvertTestStruct;
+
+typedef struct tauConvertStateStruct {
+    int format;
+    FILE* out;
+    tau_u64 numTests;               // Tests written out so far
+    tau_u64 numFailed;
+    int haveSummary;
+    tauStreamSummaryStruct summary;
+} tauConvertStateStruct;
+
+static void tauConvertReserve(tauConvertBufferStruct* const buffer, const size_t size) {
+    if(size <= buffer->capacity)
+        return;
+
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : 256;
+    while(capacity < size)
+        capacity *= 2;
+
+    char* const data = (char*)realloc(buffer->data, capacity);
+    if(data == NULL) {
+        fprintf(stderr, "TauConvert: out of memory\n");
+        exit(2);
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+}
+
+static void tauConvertAppend(tauConvertBufferStruct* const buffer, const char* const data, const size_t size) {
+    tauConvertReserve(buffer, buffer->size + size);
+    if(size > 0)
+        memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static void tauConvertSet(tauConvertBufferStruct* const buffer, const char* const data, const size_t size) {
+    buffer->size = 0;
+    tauConvertAppend(buffer, data, size);
+}
+
+// Console colour codes don't make it into the stream, but control characters (other than '\t' and '\n') may
+static void tauConvertXmlEscape(FILE* const out, const char* const text, const size_t size, const int inAttribute) {
+    for(size_t i = 0; i < size; i++) {
+        const unsigned char c = (unsigned char)text[i];
+        switch(c) {
+            case '&':   fputs("&amp;", out); break;
+            case '<':   fputs("&lt;", out); break;
+            case '>':   fputs("&gt;", out); break;
+            case '"':   fputs("&quot;", out); break;
+            case '\'':  fputs("&apos;", out); break;
+            case '\t':  fputs(inAttribute ? "&#9;" : "\t", out); break;
+            case '\n':  fputs(inAttribute ? "&#10;" : "\n", out); break;
+            case '\r':  fputs("&#13;", out); break;
+            default:
+                if(c >= 0x20)
+                    fputc(c, out);
+                break;
+        }
+    }
+}
+
+static void tauConvertJsonString(FILE* const out, const char* const text, const size_t size) {
+    fputc('"', out);
+    for(size_t i = 0; i < size; i++) {
+        const unsigned char c = (unsigned char)text[i];
+        switch(c) {
+            case '"':   fputs("\\\"", out); break;
+            case '\\':  fputs("\\\\", out); break;
+            case '\n':  fputs("\\n", out); break;
+            case '\r':  fputs("\\r", out); break;
+            case '\t':  fputs("\\t", out); break;
+            default:
+                if(c < 0x20)
+                    fprintf(out, "\\u%04x", c);
+                else
+                    fputc(c, out);
+                break;
+        }
+    }
+    fputc('"', out);
+}
+
+// Length of the first line of `text[0..size)`
+static size_t tauConvertFirstLine(const char* const text, const size_t size) {
+    const char* const eol = (const char*)memchr(text, '\n', size);
+    return eol != NULL ? (size_t)(eol - text) : size;
+}
+
+// Unpack the failure at `offset` in `test->failures`, returning the offset of the next one
+static size_t tauConvertFailureAt(const tauConvertTestStruct* const test, const size_t offset,
+                                  tauStreamAssertionFailureStruct* const failure, const char** const file,
+                                  const char** const message) {
+    memcpy(failure, test->failures.data + offset, sizeof(*failure));
+    *file = test->failures.data + offset + sizeof(*failure);
+    *message = *file + failure->fileSize;
+    return offset + sizeof(*failure) + failure->fileSize + failure->messageSize;
+}
+
+// Unpack the metric at `index` of a test: returns its value, and points `name` at its name
+static double tauConvertMetricAt(const tauConvertTestStruct* const test, const tau_u32 index, const char** const name,
+                                  size_t* const nameSize) {
+    tauStreamMetricsStruct metrics;
+    const char* names;
+    const char* end;
+    double value;
+
+    memcpy(&metrics, test->metrics.data, sizeof(metrics));
+    memcpy(&value, test->metrics.data + sizeof(metrics) + sizeof(double) * index, sizeof(value));
+    names = test->metrics.data + sizeof(metrics) + sizeof(double) * metrics.count;
+    end = names + metrics.namesSize;
+    for(tau_u32 i = 0; i < index && names < end; i++) {
+        const char* const comma = (const char*)memchr(names, ',', (size_t)(end - names));
+        names = comma != NULL ? comma + 1 : end;
+    }
+    *name = names;
+    *nameSize = (size_t)(end - names);
+    if(memchr(names, ',', *nameSize) != NULL)
+        *nameSize = (size_t)((const char*)memchr(names, ',', *nameSize) - names);
+    return value;
+}
+
+static tau_u32 tauConvertNumMetrics(const tauConvertTestStruct* const test) {
+    tauStreamMetricsStruct metrics;
+    if(test->metrics.size == 0)
+        return 0;
+    memcpy(&metrics, test->metrics.data, sizeof(metrics));
+    return metrics.count;
+}
+
+static void tauConvertWriteTest(tauConvertStateStruct* const state, const tauConvertTestStruct* const test,
+                                const tauStreamTestEndStruct* const end) {
+    const int failed = end->status == TAU_STREAM_STATUS_FAILED;
+    tauStreamAssertionFailureStruct failure;
+    const char* file;
+    const char* message;
+    const char* name;
+    size_t nameSize;
+    const tau_u32 numMetrics = tauConvertNumMetrics(test);
+
+    state->numTests++;
+    if(failed)
+        state->numFailed++;
+
+    if(state->format == TAU_CONVERT_JUNIT) {
+        const char* const dot = (const char*)memchr(test->name.data, '.', test->name.size);
+        const size_t classSize = dot != NULL ? (size_t)(dot - test->name.data) : 0;
+        const size_t nameStart = dot != NULL ? classSize + 1 : 0;
+
+        fputs("<testcase classname=\"", state->out);
+        tauConvertXmlEscape(state->out, test->name.data, classSize, 1);
+        fputs("\" name=\"", state->out);
+        tauConvertXmlEscape(state->out, test->name.data + nameStart, test->name.size - nameStart, 1);
+        fputs("\" file=\"", state->out);
+        tauConvertXmlEscape(state->out, test->file.data, test->file.size, 1);
+        fprintf(state->out, "\" line=\"%" PRIu32 "\" time=\"%.6f\"", test->start.line, (double)end->duration / 1e9);
+
+        if(!failed && numMetrics == 0) {
+            fputs("/>\n", state->out);
+            return;
+        }
+        fputs(">", state->out);
+        if(numMetrics > 0) {
+            fputs("<properties>", state->out);
+            for(tau_u32 i = 0; i < numMetrics; i++) {
+                const double value = tauConvertMetricAt(test, i, &name, &nameSize);
+                fputs("<property name=\"", state->out);
+                tauConvertXmlEscape(state->out, name, nameSize, 1);
+                fprintf(state->out, "\" value=\"%.15g\"/>", value);
+            }
+            fputs("</properties>", state->out);
+        }
+        if(!failed) {
+            fputs("</testcase>\n", state->out);
+            return;
+        }
+        // A single <failure> element: named after the first failed assertion, holding the messages of all of them
+        fputs("<failure message=\"", state->out);
+        if(test->numFailures > 0) {
+            tauConvertFailureAt(test, 0, &failure, &file, &message);
+            tauConvertXmlEscape(state->out, message, tauConvertFirstLine(message, failure.messageSize), 1);
+        } else {
+            fputs("FAILED", state->out);
+        }
+        fputs("\">", state->out);
+        for(size_t offset = 0; offset < test->failures.size;) {
+            offset = tauConvertFailureAt(test, offset, &failure, &file, &message);
+            tauConvertXmlEscape(state->out, message, failure.messageSize, 0);
+        }
+        fputs("</failure></testcase>\n", state->out);
+    } else if(state->format == TAU_CONVERT_JSON) {
+        int first = 1;
+
+        fputs(state->numTests > 1 ? ",\n    {" : "\n    {", state->out);
+        fputs("\"name\": ", state->out);
+        tauConvertJsonString(state->out, test->name.data, test->name.size);
+        fputs(", \"file\": ", state->out);
+        tauConvertJsonString(state->out, test->file.data, test->file.size);
+        fprintf(state->out, ", \"line\": %" PRIu32 ", \"status\": \"%s\", \"duration_ns\": %" PRIu64,
+                test->start.line, failed ? "failed" : "passed", end->duration);
+        if(numMetrics > 0) {
+            fputs(", \"metrics\": {", state->out);
+            for(tau_u32 i = 0; i < numMetrics; i++) {
+                const double value = tauConvertMetricAt(test, i, &name, &nameSize);
+                if(i > 0)
+                    fputs(", ", state->out);
+                tauConvertJsonString(state->out, name, nameSize);
+                fprintf(state->out, ": %.15g", value);
+            }
+            fputs("}", state->out);
+        }
+        fputs(", \"failures\": [", state->out);
+        for(size_t offset = 0; offset < test->failures.size;) {
+            offset = tauConvertFailureAt(test, offset, &failure, &file, &message);
+            fputs(first ? "{\"file\": " : ", {\"file\": ", state->out);
+            tauConvertJsonString(state->out, file, failure.fileSize);
+            fprintf(state->out, ", \"line\": %" PRIu32 ", \"message\": ", failure.line);
+            tauConvertJsonString(state->out, message, failure.messageSize);
+            fputs("}", state->out);
+            first = 0;
+        }
+        fputs("]}", state->out);
+    } else {
+        fprintf(state->out, "%s %" PRIu64 " - %.*s\n", failed ? "not ok" : "ok", state->numTests,
+                (int)test->name.size, test->name.data);
+        for(tau_u32 i = 0; i < numMetrics; i++) {
+            const double value = tauConvertMetricAt(test, i, &name, &nameSize);
+            fprintf(state->out, i == 0 ? "# metrics: %.*s %.15g" : ", %.*s %.15g", (int)nameSize, name, value);
+        }
+        if(numMetrics > 0)
+            fputs("\n", state->out);
+        // Failure messages go in as diagnostics
+        for(size_t offset = 0; offset < test->failures.size;) {
+            offset = tauConvertFailureAt(test, offset, &failure, &file, &message);
+            size_t pos = 0;
+            while(pos < failure.messageSize) {
+                const size_t length = tauConvertFirstLine(message + pos, failure.messageSize - pos);
+                fprintf(state->out, "# %.*s\n", (int)length, message + pos);
+                pos += length + 1;
+            }
+        }
+    }
+}
+
+static void tauConvertBegin(tauConvertStateStruct* const state, const tau_u64 numTests, const tau_u64 numFailed) {
+    if(state->format == TAU_CONVERT_JUNIT) {
+        fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n", state->out);
+        fprintf(state->out, "<testsuites tests=\"%" PRIu64 "\" failures=\"%" PRIu64 "\" name=\"All\">\n",
+                numTests, numFailed);
+        fprintf(state->out, "<testsuite name=\"Tests\" tests=\"%" PRIu64 "\" failures=\"%" PRIu64 "\">\n",
+                numTests, numFailed);
+    } else if(state->format == TAU_CONVERT_JSON) {
+        fputs("{\n  \"tests\": [", state->out);
+    } else {
+        fputs("TAP version 13\n", state->out);
+    }
+}
+
+static void tauConvertEnd(tauConvertStateStruct* const state) {
+    if(state->format == TAU_CONVERT_JUNIT) {
+        fputs("</testsuite>\n</testsuites>\n", state->out);
+    } else if(state->format == TAU_CONVERT_JSON) {
+        fputs(state->numTests > 0 ? "\n  ],\n  \"summary\": " : "],\n  \"summary\": ", state->out);
+        if(state->haveSummary) {
+            fprintf(state->out, "{\"total\": %" PRIu64 ", \"ran\": %" PRIu64 ", \"failed\": %" PRIu64
+                                ", \"skipped\": %" PRIu64 ", \"warnings\": %" PRIu64 ", \"duration_ns\": %" PRIu64 "}",
+                    state->summary.total, state->summary.ran, state->summary.failed, state->summary.skipped,
+                    state->summary.warnings, state->summary.duration);
+        } else {
+            fputs("null", state->out);
+        }
+        fputs("\n}\n", state->out);
+    } else {
+        fprintf(state->out, "1..%" PRIu64 "\n", state->numTests);
+    }
+}
+
+// Read the next record (and its payload) from `in`. Returns 0 at the end of the stream.
+static int tauConvertReadRecord(FILE* const in, tauStreamRecordStruct* const record,
+                                tauConvertBufferStruct* const payload) {
+    if(fread(record, sizeof(*record), 1, in) != 1)
+        return 0;
+    tauConvertReserve(payload, record->size);
+    payload->size = record->size;
+    return record->size == 0 || fread(payload->data, record->size, 1, in) == 1;
+}
+
+static int tauConvertReadHeader(FILE* const in, const char* const path) {
+    tauStreamHeaderStruct header;
+
+    if(fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, TAU_STREAM_MAGIC, sizeof(header.magic)) != 0) {
+        fprintf(stderr, "TauConvert: %s is not a Tau result stream\n", path);
+        return 0;
+    }
+    if(header.byteOrder != TAU_STREAM_BYTE_ORDER) {
+        fprintf(stderr, "TauConvert: %s was written on a machine with a different byte order\n", path);
+        return 0;
+    }
+    if(header.version != TAU_STREAM_VERSION) {
+        fprintf(stderr, "TauConvert: %s has unsupported version %" PRIu32 "\n", path, header.version);
+        return 0;
+    }
+    return 1;
+}
+
+static int tauConvert(tauConvertStateStruct* const state, FILE* const in) {
+    tauConvertTestStruct test;
+    tauConvertBufferStruct payload;
+    tauStreamRecordStruct record;
+    int ok = 1;
+
+    memset(&test, 0, sizeof(test));
+    memset(&payload, 0, sizeof(payload));
+
+    while(tauConvertReadRecord(in, &record, &payload)) {
+        if(record.type == TAU_STREAM_TEST_START && record.size >= sizeof(tauStreamTestStartStruct)) {
+            memcpy(&test.start, payload.data, sizeof(test.start));
+            if(record.size < sizeof(test.start) + (size_t)test.start.nameSize + test.start.fileSize) {
+                ok = 0;
+                break;
+            }
+            tauConvertSet(&test.name, payload.data + sizeof(test.start), test.start.nameSize);
+            tauConvertSet(&test.file, payload.data + sizeof(test.start) + test.start.nameSize, test.start.fileSize);
+            test.failures.size = 0;
+            test.numFailures = 0;
+            test.metrics.size = 0;
+            test.open = 1;
+        } else if(record.type == TAU_STREAM_ASSERTION_FAILURE && record.size >= sizeof(tauStreamAssertionFailureStruct)) {
+            tauStreamAssertionFailureStruct failure;
+            memcpy(&failure, payload.data, sizeof(failure));
+            if(record.size < sizeof(failure) + (size_t)failure.fileSize + failure.messageSize) {
+                ok = 0;
+                break;
+            }
+            if(test.open && failure.test == test.start.test) {
+                tauConvertAppend(&test.failures, payload.data, sizeof(failure) + failure.fileSize + failure.messageSize);
+                test.numFailures++;
+            }
+        } else if(record.type == TAU_STREAM_METRICS && record.size >= sizeof(tauStreamMetricsStruct)) {
+            tauStreamMetricsStruct metrics;
+            memcpy(&metrics, payload.data, sizeof(metrics));
+            if(record.size < sizeof(metrics) + sizeof(double) * metrics.count + metrics.namesSize) {
+                ok = 0;
+                break;
+            }
+            if(test.open && metrics.test == test.start.test)
+                tauConvertSet(&test.metrics, payload.data, record.size);
+        } else if(record.type == TAU_STREAM_TEST_END && record.size >= sizeof(tauStreamTestEndStruct)) {
+            tauStreamTestEndStruct end;
+            memcpy(&end, payload.data, sizeof(end));
+            if(test.open && end.test == test.start.test)
+                tauConvertWriteTest(state, &test, &end);
+            test.open = 0;
+        } else if(record.type == TAU_STREAM_SUMMARY && record.size >= sizeof(tauStreamSummaryStruct)) {
+            memcpy(&state->summary, payload.data, sizeof(state->summary));
+            state->haveSummary = 1;
+        }
+        // Anything else is a record type from a newer version: skip it
+    }
+
+    // The run ended in the middle of a test
+    if(test.open) {
+        tauStreamTestEndStruct end;
+        memset(&end, 0, sizeof(end));
+        end.test = test.start.test;
+        end.status = TAU_STREAM_STATUS_FAILED;
+        tauConvertWriteTest(state, &test, &end);
+    }
+
+    free(test.name.data);
+    free(test.file.data);
+    free(test.failures.data);
+    free(test.metrics.data);
+    free(payload.data);
+    return ok;
+}
+
+// JUnit wants the totals up front: count the tests in a first pass, skipping over the bulk of the payloads
+static void tauConvertCount(FILE* const in, tau_u64* const numTests, tau_u64* const numFailed) {
+    tauStreamRecordStruct record;
+    tauStreamTestEndStruct end;
+    int open = 0;
+
+    *numTests = 0;
+    *numFailed = 0;
+    while(fread(&record, sizeof(record), 1, in) == 1) {
+        if(record.type == TAU_STREAM_TEST_END && record.size >= sizeof(end)) {
+            if(fread(&end, sizeof(end), 1, in) != 1)
+                break;
+            record.size -= (tau_u32)sizeof(end);
+            if(open) {
+                (*numTests)++;
+                if(end.status == TAU_STREAM_STATUS_FAILED)
+                    (*numFailed)++;
+            }
+            open = 0;
+        } else if(record.type == TAU_STREAM_TEST_START) {
+            open = 1;
+        }
+        if(fseek(in, (long)record.size, SEEK_CUR) != 0)
+            break;
+    }
+    if(open) {
+        (*numTests)++;
+        (*numFailed)++;
+    }
+}
+
+static void tauConvertUsage(const char* const argv0) {
+    fprintf(stderr, "Usage: %s <junit|json|tap> <FILE> [OUTPUT]\n", argv0);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Convert a result stream written by a Tau test binary run with '--emit=bin:<FILE>'\n");
+    fprintf(stderr, "to JUnit XML, JSON or TAP. The result is written to OUTPUT (or to stdout).\n");
+}
+
+int main(int argc, char** argv) {
+    tauConvertStateStruct state;
+    FILE* in;
+    int ok;
+
+    memset(&state, 0, sizeof(state));
+    if(argc < 3 || argc > 4) {
+        tauConvertUsage(argv[0]);
+        return 2;
+    }
+
+    if(strcmp(argv[1], "junit") == 0)
+        state.format = TAU_CONVERT_JUNIT;
+    else if(strcmp(argv[1], "json") == 0)
+        state.format = TAU_CONVERT_JSON;
+    else if(strcmp(argv[1], "tap") == 0)
+        state.format = TAU_CONVERT_TAP;
+    else {
+        tauConvertUsage(argv[0]);
+        return 2;
+    }
+
+    in = fopen(argv[2], "rb");
+    if(in == NULL) {
+        fprintf(stderr, "TauConvert: could not open %s\n", argv[2]);
+        return 2;
+    }
+    if(!tauConvertReadHeader(in, argv[2])) {
+        fclose(in);
+        return 2;
+    }
+
+    state.out = argc == 4 ? fopen(argv[3], "w") : stdout;
+    if(state.out == NULL) {
+        fprintf(stderr, "TauConvert: could not open %s for writing\n", argv[3]);
+        fclose(in);
+        return 2;
+    }
+
+    if(state.format == TAU_CONVERT_JUNIT) {
+        const long records = ftell(in);
+        tau_u64 numTests;
+        tau_u64 numFailed;
+
+        tauConvertCount(in, &numTests, &numFailed);
+        fseek(in, records, SEEK_SET);
+        tauConvertBegin(&state, numTests, numFailed);
+    } else {
+        tauConvertBegin(&state, 0, 0);
+    }
+
+    ok = tauConvert(&state, in);
+    tauConvertEnd(&state);
+
+    fclose(in);
+    if(state.out != stdout)
+        fclose(state.out);
+    return ok ? 0 : 1;
+}